@@ -0,0 +1,158 @@
+// Move-generation throughput: perft from the opening and generateMoves over
+// seeded random games, for each ruleset. Numbers are printed, not asserted.
+// --corpus file.txt (see hive_corpus) also times each generator entry point
+// over the corpus positions, with generateMoves broken down by bucket.
+// --profile prints the engine's zone table after each phase and --trace writes
+// a Chrome trace of the whole run; both need a -DHIVE_PROFILE=ON build.
+#include "corpus.hpp"
+#include "rules.hpp"
+#include "profile.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+
+using namespace hive;
+
+namespace {
+
+    double msSince(std::chrono::steady_clock::time_point t0) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    void benchPerft(const char* name, Ruleset r, int depth) {
+        GameState s(r);
+        auto t0 = std::chrono::steady_clock::now();
+        const std::uint64_t n = perft(s, depth);
+        const double ms = msSince(t0);
+        std::printf("%-24s depth %d  %12llu nodes  %9.1f ms  %8.2f Mnps\n", name, depth,
+            static_cast<unsigned long long>(n), ms, n / (ms * 1e3));
+    }
+
+    // Plays seeded random games and times generateMoves on every position.
+    void benchPlayouts(const char* name, Ruleset r, int games) {
+        std::mt19937 rng(12345);
+        std::uint64_t positions = 0, moves = 0;
+        double genMs = 0;
+        for (int g = 0; g < games; ++g) {
+            GameState s(r);
+            for (int ply = 0; ply < 150 && evaluateGameOver(s) == GameOver::None; ++ply) {
+                auto t0 = std::chrono::steady_clock::now();
+                std::vector<Move> mv = generateMoves(s);
+                genMs += msSince(t0);
+                ++positions;
+                moves += mv.size();
+                s.play(mv.empty() ? Move::pass() : mv[rng() % mv.size()]);
+            }
+        }
+        std::printf("%-24s %6llu positions  %8.1f moves/pos  %9.1f ms  %8.2f us/pos\n", name,
+            static_cast<unsigned long long>(positions), double(moves) / positions, genMs, genMs * 1e3 / positions);
+    }
+
+    // Each entry point over every corpus position, repeated reps times.
+    void benchCorpus(const std::vector<GameRecord>& corpus, int reps) {
+        std::vector<GameState> positions;
+        positions.reserve(corpus.size());
+        for (const GameRecord& g : corpus) positions.push_back(replay(g));
+        std::printf("corpus: %zu positions x %d\n", positions.size(), reps);
+
+        std::uint64_t checksum = 0; // printed, so no timed call is optimized away
+        auto time = [&](const char* name, auto&& perPosition) {
+            auto t0 = std::chrono::steady_clock::now();
+            for (int r = 0; r < reps; ++r) {
+                for (const GameState& s : positions) checksum += perPosition(s);
+            }
+            const double ms = msSince(t0);
+            std::printf("  %-30s %9.1f ms  %8.2f us/pos\n", name, ms, ms * 1e3 / (double(positions.size()) * reps));
+        };
+        MoveList list;
+        LegalMoveList legal;
+        time("generateMoves (vector)", [&](const GameState& s) { return generateMoves(s).size(); });
+        time("generateMoves (MoveList)", [&](const GameState& s) { generateMoves(s, list); return list.size(); });
+        time("legalMovesForPiece (vector)", [&](const GameState& s) {
+            std::size_t n = 0;
+            for (const auto& [pos, stack] : s.board()) n += legalMovesForPiece(s, stack.back()).size();
+            return n;
+        });
+        time("legalMovesForPiece (list)", [&](const GameState& s) {
+            legal.clear();
+            for (const auto& [pos, stack] : s.board()) legalMovesForPiece(s, stack.back(), legal);
+            return legal.size();
+        });
+        time("countLegalMovesForPiece", [&](const GameState& s) {
+            std::size_t n = 0;
+            for (const auto& [pos, stack] : s.board()) n += countLegalMovesForPiece(s, stack.back());
+            return n;
+        });
+        time("countLegalMoves", [&](const GameState& s) { return countLegalMoves(s); });
+        time("pinnedCells", [&](const GameState& s) { return pinnedCells(s).size(); });
+        time("isPinned (every top piece)", [&](const GameState& s) {
+            std::size_t n = 0;
+            for (const auto& [pos, stack] : s.board()) n += isPinned(s, stack.back());
+            return n;
+        });
+
+        double bucketMs[kCorpusBuckets]{};
+        int bucketCount[kCorpusBuckets]{};
+        for (const GameState& s : positions) {
+            const int b = corpusBucket(s);
+            auto t0 = std::chrono::steady_clock::now();
+            for (int r = 0; r < reps; ++r) { generateMoves(s, list); checksum += list.size(); }
+            bucketMs[b] += msSince(t0);
+            ++bucketCount[b];
+        }
+        for (int b = 0; b < kCorpusBuckets; ++b) {
+            if (bucketCount[b]) std::printf("  %-30s %6d pos  %8.2f us/pos\n", corpusBucketName(b), bucketCount[b], bucketMs[b] * 1e3 / (double(bucketCount[b]) * reps));
+        }
+        std::printf("  checksum %llu\n", static_cast<unsigned long long>(checksum));
+    }
+
+}
+
+int main(int argc, char** argv) {
+    int baseDepth = 5, mlpDepth = 4, games = 200;
+    bool showProfile = false;
+    const char* tracePath = nullptr;
+    const char* corpusPath = nullptr;
+    int corpusReps = 5;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--profile")) showProfile = true;
+        else if (!std::strcmp(argv[i], "--trace") && hasValue) tracePath = argv[++i];
+        else if (!std::strcmp(argv[i], "--base-depth") && hasValue) baseDepth = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--mlp-depth") && hasValue) mlpDepth = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--games") && hasValue) games = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--corpus") && hasValue) corpusPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--corpus-reps") && hasValue) corpusReps = std::atoi(argv[++i]);
+    }
+    if (tracePath) profile::setTracing(true);
+
+    // each phase is timed, then (with --profile) broken down by engine zone
+    auto phase = [&](auto&& run) {
+        const profile::Snapshot before = profile::snapshot();
+        run();
+        if (showProfile) {
+            profile::printSummary(stdout, profile::snapshot() - before);
+            std::printf("\n");
+        }
+    };
+    phase([&] { benchPerft("perft base", Ruleset::Base, baseDepth); });
+    phase([&] { benchPerft("perft mlp", Ruleset::MLP, mlpDepth); });
+    phase([&] { benchPlayouts("playouts base", Ruleset::Base, games); });
+    phase([&] { benchPlayouts("playouts mlp", Ruleset::MLP, games); });
+    if (corpusPath) {
+        std::ifstream in(corpusPath);
+        if (!in) { std::fprintf(stderr, "cannot read %s\n", corpusPath); return 1; }
+        const auto corpus = readRecords(in);
+        phase([&] { benchCorpus(corpus, corpusReps); });
+    }
+
+    if (tracePath && !profile::writeChromeTrace(tracePath)) {
+        std::fprintf(stderr, "cannot write trace %s%s\n", tracePath, profile::kEnabled ? "" : " (built without HIVE_PROFILE)");
+        return 1;
+    }
+    return 0;
+}
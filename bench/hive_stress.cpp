@@ -0,0 +1,83 @@
+// Multithreaded move-generation stress: every thread plays seeded random games,
+// generating moves and evaluating each position, first with the engine pool
+// and then with every container on the global heap. Scaling with the thread
+// count shows allocator contention. Numbers are printed, not asserted.
+#include "pool.hpp"
+#include "search.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace hive;
+
+namespace {
+
+    struct Totals {
+        std::uint64_t positions{};
+        std::uint64_t moves{};
+        std::int64_t evalSum{}; // keeps evaluate() from being optimized out
+    };
+
+    Totals worker(Ruleset r, int games, unsigned seed) {
+        std::mt19937 rng(seed);
+        Totals t;
+        MoveList moves;
+        for (int g = 0; g < games; ++g) {
+            GameState s(r);
+            for (int ply = 0; ply < 150 && evaluateGameOver(s) == GameOver::None; ++ply) {
+                generateMoves(s, moves);
+                t.evalSum += evaluate(s);
+                ++t.positions;
+                t.moves += moves.size();
+                s.play(moves.empty() ? Move::pass() : moves[rng() % moves.size()]);
+            }
+        }
+        return t;
+    }
+
+    void run(const char* name, Ruleset r, int threads, int gamesPerThread) {
+        std::vector<Totals> totals(threads);
+        std::vector<std::thread> workers;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < threads; ++i) {
+            workers.emplace_back([&, i] { totals[i] = worker(r, gamesPerThread, 1000u + i); });
+        }
+        for (auto& th : workers) th.join();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        std::uint64_t positions = 0;
+        for (const Totals& t : totals) positions += t.positions;
+        std::printf("%-10s %-5s %2d threads  %8llu positions  %9.1f ms  %8.1f kpos/s\n", name,
+            r == Ruleset::MLP ? "mlp" : "base", threads, static_cast<unsigned long long>(positions), ms, positions / ms);
+    }
+
+}
+
+int main(int argc, char** argv) {
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int games = 40;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--threads")) maxThreads = std::max(1, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--games")) games = std::atoi(argv[i + 1]);
+    }
+
+    std::vector<int> counts;
+    for (int n = 1; n < maxThreads; n *= 2) counts.push_back(n);
+    counts.push_back(maxThreads);
+
+    // the pool switch is only flipped here, between phases, with no engine containers alive
+    for (Ruleset r : { Ruleset::Base, Ruleset::MLP }) {
+        for (int n : counts) {
+            pool::setEnabled(true);
+            run("pool", r, n, games);
+            pool::setEnabled(false);
+            run("heap", r, n, games);
+        }
+    }
+    pool::setEnabled(true);
+    return 0;
+}
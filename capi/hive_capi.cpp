@@ -0,0 +1,106 @@
+#include "hive_capi.h"
+#include "encode.hpp"
+#include "game_record.hpp"
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using namespace hive;
+
+struct hive_positions {
+    std::vector<PositionSnapshot> positions;
+    std::vector<std::int32_t> moves;
+    std::vector<std::int8_t> outcomes;
+};
+
+namespace {
+
+    std::int8_t outcomeFor(GameOver result, Color toMove) {
+        if (result == GameOver::WhiteWins) return toMove == Color::White ? 1 : -1;
+        if (result == GameOver::BlackWins) return toMove == Color::Black ? 1 : -1;
+        return 0;
+    }
+
+    hive_positions* load(std::istream& in, bool allPlies) {
+        try {
+            auto out = std::make_unique<hive_positions>();
+            for (const GameRecord& g : readRecords(in)) {
+                GameState s(g.ruleset);
+                auto keep = [&](std::int32_t move) {
+                    out->positions.push_back(s.snapshot());
+                    out->moves.push_back(move);
+                    out->outcomes.push_back(outcomeFor(g.result, s.toMove()));
+                };
+                for (const Move& m : g.moves) {
+                    if (allPlies) keep(moveIndex(s, m));
+                    s.play(m);
+                }
+                if (!allPlies) keep(-1);
+            }
+            return out->positions.empty() ? nullptr : out.release();
+        }
+        catch (...) {
+            return nullptr; // snapshot() refuses coordinates beyond its range
+        }
+    }
+
+    bool validRange(const hive_positions* p, std::int64_t first, std::int64_t count) {
+        return p && first >= 0 && count >= 0 && first + count <= static_cast<std::int64_t>(p->positions.size());
+    }
+
+    template <typename T>
+    int encode(const hive_positions* p, std::int64_t first, std::int64_t count, T* planes, T* masks, int threads) {
+        if (!validRange(p, first, count) || (!planes && count > 0)) return -1;
+        try {
+            return encodeBatch(p->positions.data() + first, static_cast<std::size_t>(count), planes, masks, threads);
+        }
+        catch (...) {
+            return -1;
+        }
+    }
+
+}
+
+extern "C" {
+
+    int hive_encode_window(void) { return kEncodeWindow; }
+    int hive_encode_planes(void) { return kEncodePlanes; }
+    int hive_encode_mask_planes(void) { return kMaskPlanes; }
+
+    hive_positions* hive_positions_from_text(const char* records, int all_plies) {
+        if (!records) return nullptr;
+        std::istringstream in(records);
+        return load(in, all_plies != 0);
+    }
+
+    hive_positions* hive_positions_load(const char* path, int all_plies) {
+        if (!path) return nullptr;
+        std::ifstream in(path);
+        return in ? load(in, all_plies != 0) : nullptr;
+    }
+
+    int64_t hive_positions_count(const hive_positions* p) {
+        return p ? static_cast<int64_t>(p->positions.size()) : 0;
+    }
+
+    void hive_positions_free(hive_positions* p) { delete p; }
+
+    int hive_encode_f32(const hive_positions* p, int64_t first, int64_t count, float* planes, float* masks, int threads) {
+        return encode(p, first, count, planes, masks, threads);
+    }
+
+    int hive_encode_i8(const hive_positions* p, int64_t first, int64_t count, int8_t* planes, int8_t* masks, int threads) {
+        return encode(p, first, count, planes, masks, threads);
+    }
+
+    int hive_positions_targets(const hive_positions* p, int64_t first, int64_t count, int32_t* moves, int8_t* outcomes) {
+        if (!validRange(p, first, count)) return -1;
+        for (int64_t i = 0; i < count; ++i) {
+            if (moves) moves[i] = p->moves[static_cast<std::size_t>(first + i)];
+            if (outcomes) outcomes[i] = p->outcomes[static_cast<std::size_t>(first + i)];
+        }
+        return 0;
+    }
+
+}
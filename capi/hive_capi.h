@@ -0,0 +1,62 @@
+/* C interface to the Hive engine's position encoder, for Python (ctypes,
+ * cffi) and other languages. Positions are loaded once from game records,
+ * then encoded in batches straight into caller-owned arrays; see
+ * engine/include/encode.hpp for the plane layout. Nothing here throws or
+ * keeps pointers to caller memory past a call. */
+#ifndef HIVE_CAPI_H
+#define HIVE_CAPI_H
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(HIVE_CAPI_BUILD)
+#    define HIVE_CAPI __declspec(dllexport)
+#  else
+#    define HIVE_CAPI __declspec(dllimport)
+#  endif
+#else
+#  define HIVE_CAPI __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Layout sizes: one position is planes x window x window values of planes
+ * and mask_planes x window x window values of mask. */
+HIVE_CAPI int hive_encode_window(void);
+HIVE_CAPI int hive_encode_planes(void);
+HIVE_CAPI int hive_encode_mask_planes(void);
+
+typedef struct hive_positions hive_positions;
+
+/* Positions from game records, one per line (the hive_book / hive_corpus
+ * text format; '#' comments and malformed lines are skipped). With
+ * all_plies != 0 every position before a move of every game is kept,
+ * otherwise only each game's final position. NULL when nothing loads. */
+HIVE_CAPI hive_positions* hive_positions_from_text(const char* records, int all_plies);
+HIVE_CAPI hive_positions* hive_positions_load(const char* path, int all_plies);
+HIVE_CAPI int64_t hive_positions_count(const hive_positions* p);
+HIVE_CAPI void hive_positions_free(hive_positions* p);
+
+/* Encodes positions [first, first + count) into planes and, unless NULL,
+ * masks, position by position, on threads workers (0 = all cores). Returns
+ * the number of positions that did not fit the window, or -1 on a bad
+ * range or null argument. */
+HIVE_CAPI int hive_encode_f32(const hive_positions* p, int64_t first, int64_t count,
+    float* planes, float* masks, int threads);
+HIVE_CAPI int hive_encode_i8(const hive_positions* p, int64_t first, int64_t count,
+    int8_t* planes, int8_t* masks, int threads);
+
+/* Training targets for the same range. moves: the mask index of the move
+ * played from each position, -1 for a pass, a final position or a move
+ * outside the window. outcomes: the game result for the side to move,
+ * 1 win, -1 loss, 0 draw or unfinished. Returns 0, or -1 as above. */
+HIVE_CAPI int hive_positions_targets(const hive_positions* p, int64_t first, int64_t count,
+    int32_t* moves, int8_t* outcomes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HIVE_CAPI_H */
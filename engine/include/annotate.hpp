@@ -0,0 +1,50 @@
+#pragma once
+#include "game_record.hpp"
+#include "search.hpp"
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace hive {
+
+    struct AnnotateOptions {
+        int depth{ 4 };             // search depth per position
+        std::int64_t maxNodes{ 0 }; // per search; 0 = depth only
+        int threshold{ 150 };       // drops of at least this much are flagged
+        int threads{ 0 };           // 0 = hardware concurrency
+        std::size_t ttEntries{ std::size_t{ 1 } << 20 }; // shared by every search
+    };
+
+    // One played move, scored from the mover's point of view at the same depth
+    // as the best move: the played score comes from a search restricted to it,
+    // to the depth the full search completed. A search that completed no depth
+    // (node budget too small) leaves both scores equal.
+    struct PlyNote {
+        Move played{ Move::pass() };
+        Move best{ Move::pass() };
+        int bestScore{};
+        int playedScore{};
+        int drop() const { return bestScore - playedScore; }
+    };
+
+    struct GameAnnotation {
+        std::vector<PlyNote> plies; // one per move of the record
+        int flagged{};              // plies whose drop reaches the threshold
+    };
+
+    // Searches the position before every move of every game. Games go to a
+    // work-stealing pool, one task each, which walks its game ply by ply, and
+    // all searches share one transposition table, so neighboring plies reuse
+    // each other's work. Table sharing makes scores depend slightly on
+    // scheduling; with one thread the result is reproducible. done, when
+    // given, counts searched positions as they finish.
+    std::vector<GameAnnotation> annotateGames(const std::vector<GameRecord>& games, const AnnotateOptions& o,
+        std::atomic<std::int64_t>* done = nullptr);
+
+    // The record line, then a '#' comment for each flagged ply, so
+    // readRecords() still loads the file:
+    //   # ply 12: bA1@2,-1 ?? -340, best bQ@1,1 +120
+    void writeAnnotated(std::ostream& out, const GameRecord& g, const GameAnnotation& a, int threshold);
+
+} // namespace hive
@@ -0,0 +1,65 @@
+#pragma once
+#include "game_record.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hive {
+
+    // Position key that is the same for all 12 rotations/reflections of the hive
+    // and for any translation of it, so mirrored openings share one book entry.
+    std::uint64_t canonicalHash(const GameState& s);
+
+    // Game outcomes seen from one position.
+    struct BookStats {
+        std::uint32_t visits{};
+        std::uint32_t whiteWins{};
+        std::uint32_t draws{};
+        std::uint32_t blackWins{};
+
+        // expected score in [0,1] for color c
+        double scoreFor(Color c) const;
+    };
+
+    // Aggregates game records into canonical-position statistics and writes the
+    // sorted binary book: a header, then fixed-size entries ordered by key.
+    class BookBuilder {
+    public:
+        explicit BookBuilder(Ruleset ruleset, int maxPly = 16) : ruleset_(ruleset), maxPly_(maxPly) {}
+
+        // Records of another ruleset are ignored; returns whether g was used.
+        bool add(const GameRecord& g);
+        size_t positions() const { return stats_.size(); }
+        // Drops positions seen fewer than minVisits times, then writes the file.
+        bool write(const std::string& path, std::uint32_t minVisits = 1) const;
+
+    private:
+        Ruleset ruleset_;
+        int maxPly_;
+        std::unordered_map<std::uint64_t, BookStats> stats_;
+    };
+
+    // Read-only view of a book file; lookups are binary searches over the sorted keys.
+    class OpeningBook {
+    public:
+        bool load(const std::string& path);
+        bool empty() const { return keys_.empty(); }
+        size_t size() const { return keys_.size(); }
+        Ruleset ruleset() const { return ruleset_; }
+
+        std::optional<BookStats> find(std::uint64_t key) const;
+        std::optional<BookStats> find(const GameState& s) const { return find(canonicalHash(s)); }
+
+        // The legal move whose resulting position scores best for the side to move,
+        // among those seen at least minVisits times; nullopt when out of book.
+        std::optional<Move> pick(const GameState& s, std::uint32_t minVisits = 4) const;
+
+    private:
+        Ruleset ruleset_{ Ruleset::Base };
+        std::vector<std::uint64_t> keys_;   // sorted
+        std::vector<BookStats> stats_;      // parallel to keys_
+    };
+
+} // namespace hive
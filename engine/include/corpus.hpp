@@ -0,0 +1,46 @@
+#pragma once
+#include "game_record.hpp"
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace hive {
+
+    // Buckets of a position corpus: board pieces in bands of four (the last band
+    // open-ended) times the tallest stack (1, 2, or 3 and up).
+    constexpr int kCorpusPieceBands = 5;
+    constexpr int kCorpusStackBands = 3;
+    constexpr int kCorpusBuckets = kCorpusPieceBands * kCorpusStackBands;
+    int corpusBucket(const GameState& s); // pieceBand * kCorpusStackBands + stackBand
+    const char* corpusBucketName(int bucket); // e.g. "6-9 pieces, stack 2"
+
+    struct CorpusOptions {
+        Ruleset ruleset{ Ruleset::Base };
+        int positions{ 2000 };
+        std::uint32_t seed{ 1 };
+        // false: uniform random moves. true: piece moves outweigh placements
+        // and climbs outweigh both, which reaches taller stacks sooner.
+        bool weighted{ false };
+        int maxPly{ 200 };
+    };
+
+    // Reachable positions from seeded random games, each a record of the
+    // moves that reach it (result "*"). No two share a canonical position and
+    // finished games are left out. Buckets are filled evenly while games still
+    // reach the open ones; the rest of the count is then taken from wherever
+    // games go, so rare buckets end up sparse rather than the corpus short.
+    // Same options, same corpus.
+    std::vector<GameRecord> generateCorpus(const CorpusOptions& o);
+
+    // Position counts per bucket.
+    std::array<int, kCorpusBuckets> corpusHistogram(const std::vector<GameRecord>& corpus);
+
+    // Corpus file: a '#' comment header, then one record per line, so
+    // readRecords() loads it back.
+    void writeCorpus(std::ostream& out, const std::vector<GameRecord>& corpus);
+
+    // The position a record ends in.
+    GameState replay(const GameRecord& g);
+
+} // namespace hive
@@ -0,0 +1,69 @@
+#pragma once
+#include "rules.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hive {
+
+    // Positions as dense planes for training and inference. Each plane is a
+    // kEncodeWindow x kEncodeWindow grid of axial cells, row r, column q,
+    // centered on the middle of the hive's bounding box (encodeCenter), so a
+    // position and its translation encode the same. Planes are from the side
+    // to move's point of view: "ours" is the side to move.
+    //
+    //   planes [kEncodePlanes][W][W]
+    //     piecePlane(bug, ours, height): 1 where a piece of that bug and side
+    //       sits at that stack height; the last height slot takes every piece
+    //       at or above it
+    //     handPlane(bug, ours): filled with the number of that bug in hand
+    //   mask [kMaskPlanes][W][W]
+    //     maskPlane(slot, ours): 1 on every legal destination of the piece with
+    //       that slot (a placement names the next piece in hand, a Pillbug
+    //       throw the thrown piece). No legal move, all zero, means a pass.
+    //
+    // A slot is a piece's index within its color's hand, in Bug order, the same
+    // under both rulesets (the base game leaves the expansion slots empty).
+    constexpr int kEncodeWindow = 15;
+    constexpr int kEncodeHeights = 4;
+    constexpr std::size_t kEncodeCells = std::size_t{ kEncodeWindow } * kEncodeWindow;
+    constexpr int kPiecePlanes = kBugCount * kColorCount * kEncodeHeights;
+    constexpr int kHandPlanes = kBugCount * kColorCount;
+    constexpr int kEncodePlanes = kPiecePlanes + kHandPlanes;
+    constexpr int kMaskPlanes = kColorCount * kMaxPiecesPerColor;
+
+    constexpr int piecePlane(Bug b, bool ours, int height) {
+        return (bugIndex(b) * kColorCount + (ours ? 0 : 1)) * kEncodeHeights + (height < kEncodeHeights ? height : kEncodeHeights - 1);
+    }
+    constexpr int handPlane(Bug b, bool ours) { return kPiecePlanes + bugIndex(b) * kColorCount + (ours ? 0 : 1); }
+    constexpr int maskPlane(int slot, bool ours) { return (ours ? 0 : kMaxPiecesPerColor) + slot; }
+
+    Axial encodeCenter(const GameState& s);
+
+    // Where m lands in the mask layout (plane * kEncodeCells + cell) for the
+    // position s, or -1 for a pass or a move outside the window.
+    int moveIndex(const GameState& s, const Move& m);
+
+    // Writes one position into planes (kEncodePlanes * kEncodeCells values)
+    // and, unless null, mask (kMaskPlanes * kEncodeCells); both are overwritten
+    // whole. Returns false when a piece or a move fell outside the window or
+    // had no slot (setup pieces beyond the hand); those are left out.
+    template <typename T>
+    bool encodePosition(const GameState& s, T* planes, T* mask);
+    extern template bool encodePosition<float>(const GameState&, float*, float*);
+    extern template bool encodePosition<std::int8_t>(const GameState&, std::int8_t*, std::int8_t*);
+
+    // A batch, position i at planes + i * kEncodePlanes * kEncodeCells (and
+    // likewise in masks), encoded on a pool of worker threads (0 = hardware
+    // concurrency). The snapshot overload restores each position on the
+    // worker that encodes it. Returns how many positions were clipped.
+    template <typename T>
+    int encodeBatch(const GameState* states, std::size_t count, T* planes, T* masks, int threads = 0);
+    template <typename T>
+    int encodeBatch(const PositionSnapshot* positions, std::size_t count, T* planes, T* masks, int threads = 0);
+    extern template int encodeBatch<float>(const GameState*, std::size_t, float*, float*, int);
+    extern template int encodeBatch<std::int8_t>(const GameState*, std::size_t, std::int8_t*, std::int8_t*, int);
+    extern template int encodeBatch<float>(const PositionSnapshot*, std::size_t, float*, float*, int);
+    extern template int encodeBatch<std::int8_t>(const PositionSnapshot*, std::size_t, std::int8_t*, std::int8_t*, int);
+
+} // namespace hive
@@ -3,15 +3,73 @@
 #include <unordered_map>
 #include <cstdint>
 #include <optional>
+#include <array>
+#include <string>
+#include <string_view>
+#include "pool.hpp"
+#include "small_vector.hpp"
 
 namespace hive {
 
     enum class Color { White, Black };
-    enum class Bug { Queen, Beetle, Spider, Grasshopper, Ant };
+    enum class Bug { Queen, Beetle, Spider, Grasshopper, Ant, Mosquito, Ladybug, Pillbug };
+
+    // Base: the five original bugs. MLP: base plus the Mosquito, Ladybug and Pillbug expansions.
+    enum class Ruleset { Base, MLP };
+
+    constexpr int kColorCount = 2;
+    constexpr int kBugCount = 8;
+    constexpr int kBaseBugCount = 5; // expansion bugs come after the base ones in Bug order
+
+    constexpr int colorIndex(Color c) { return static_cast<int>(c); }
+    constexpr int bugIndex(Bug b) { return static_cast<int>(b); }
+    constexpr Color opponent(Color c) { return c == Color::White ? Color::Black : Color::White; }
+
+    // Compile-time facts about a ruleset. Hand per color, indexed by Bug: 1 Queen,
+    // 2 Beetles, 2 Spiders, 3 Grasshoppers, 3 Ants, plus one of each expansion bug
+    // under MLP. Code templated on R sizes its tables from these and drops the
+    // branches for bugs that are not in play.
+    template <Ruleset R>
+    struct RulesetTraits {
+        static constexpr std::array<int, kBugCount> kHand = R == Ruleset::MLP
+            ? std::array<int, kBugCount>{ 1, 2, 2, 3, 3, 1, 1, 1 }
+            : std::array<int, kBugCount>{ 1, 2, 2, 3, 3, 0, 0, 0 };
+
+        static constexpr bool has(Bug b) { return kHand[static_cast<int>(b)] > 0; }
+
+        // bugs [0, kBugs) are in play
+        static constexpr int kBugs = R == Ruleset::MLP ? kBugCount : kBaseBugCount;
+        static constexpr int kPiecesPerColor = [] {
+            int n = 0;
+            for (int c : kHand) n += c;
+            return n;
+        }();
+        static constexpr int kPieces = kColorCount * kPiecesPerColor;
+    };
+
+    constexpr std::array<int, kBugCount> startingHand(Ruleset r) {
+        return r == Ruleset::MLP ? RulesetTraits<Ruleset::MLP>::kHand : RulesetTraits<Ruleset::Base>::kHand;
+    }
+    constexpr int piecesPerColor(Ruleset r) {
+        return r == Ruleset::MLP ? RulesetTraits<Ruleset::MLP>::kPiecesPerColor : RulesetTraits<Ruleset::Base>::kPiecesPerColor;
+    }
+    constexpr int kMaxPiecesPerColor = RulesetTraits<Ruleset::MLP>::kPiecesPerColor;
+    // first piece id of each bug within a color's hand; the base bugs come first,
+    // so their offsets are the same under every ruleset
+    inline constexpr std::array<int, kBugCount> kHandOffset = [] {
+        constexpr auto hand = startingHand(Ruleset::MLP);
+        std::array<int, kBugCount> off{};
+        for (int b = 1; b < kBugCount; ++b) off[b] = off[b - 1] + hand[b - 1];
+        return off;
+    }();
+    static_assert(RulesetTraits<Ruleset::Base>::kPiecesPerColor == 11 && kMaxPiecesPerColor == 14);
+
+    // Notation letter: Q B S G A M L P
+    constexpr char bugChar(Bug b) { return "QBSGAMLP"[static_cast<int>(b)]; }
 
     struct Axial {
         int q{}; int r{};
-        friend bool operator==(const Axial& a, const Axial& b) { return a.q == b.q && a.r == b.r; }
+        friend constexpr bool operator==(const Axial& a, const Axial& b) { return a.q == b.q && a.r == b.r; }
     };
 
     struct AxialHash {
@@ -36,22 +94,169 @@ namespace hive {
 
     struct Move {
         int pieceId{}; Axial to{}; bool isPlacement{ false };
+
+        // a side with no legal move passes its turn
+        static constexpr Move pass() { return { -1, {}, false }; }
+        constexpr bool isPass() const { return pieceId < 0; }
+        friend constexpr bool operator==(const Move& a, const Move& b) {
+            return a.pieceId == b.pieceId && a.to == b.to && a.isPlacement == b.isPlacement;
+        }
+    };
+
+    // Pieces on one cell, bottom first. Seven is the tallest real stack (ground
+    // piece, four Beetles, two Mosquitoes); only setups stack higher and spill.
+    using PieceStack = SmallVector<int, 8>;
+    // Occupied cells only; map nodes come from the engine pool.
+    using Board = PoolMap<Axial, PieceStack, AxialHash>;
+
+    // Where every piece stands, whose turn it is, the ply and the last move
+    // (which the rules consult), in about a hundred bytes, for keyframe
+    // indexes over long games. Older history and repetition counts are not
+    // part of it.
+    struct PositionSnapshot {
+        struct Slot { std::int8_t q{}, r{}, height{ -1 }; }; // height -1: in hand
+        std::array<Slot, kColorCount * kMaxPiecesPerColor> pieces{};
+        bool hasLast{ false };
+        Move last{ Move::pass() };
+        Slot lastFrom{}; // where the last moved piece came from
+        std::int32_t ply{};
+        Ruleset ruleset{ Ruleset::Base };
+        Color toMove{ Color::White };
     };
 
+    // Owns the board, every piece (in hand or on board) and whose turn it is.
+    // Piece ids are fixed: each color's hand is laid out in Bug order, so the
+    // k-th Spider of a color always has the same id.
     class GameState {
     public:
-        GameState();
+        explicit GameState(Ruleset ruleset = Ruleset::Base);
+        Ruleset ruleset() const { return ruleset_; }
         const std::vector<Piece>& pieces() const { return pieces_; }
-        const std::unordered_map<Axial, std::vector<int>, AxialHash>& board() const { return board_; }
+        const Board& board() const { return board_; }
 
-        int addDemoPiece(Bug bug, Color color, Axial at, int height = 0);
+        // Setup primitives: no turn bookkeeping. addDemoPiece takes the piece from the
+        // hand when one is left, otherwise it adds an extra piece beyond the hand.
+        // height is the stack index to insert at; -1 (default) stacks on top.
+        int addDemoPiece(Bug bug, Color color, Axial at, int height = -1);
         void movePiece(int pieceId, Axial to, bool allowStack = true);
+        // Reduced hands (retrograde variants): c keeps only the first count pieces of
+        // bug b, the rest never enter play. Call before any of them is placed.
+        void limitHand(Color c, Bug b, int count);
+        void setToMove(Color c);
+
+        // Positions of ordinary games only: full hands, no extra setup pieces,
+        // coordinates within +-127 (snapshot() throws otherwise). After
+        // restore() the undo history holds just the last move, so undo() goes
+        // one ply back and then stops.
+        PositionSnapshot snapshot() const;
+        void restore(const PositionSnapshot& snap);
+
+        // Plays one turn for the side to move and passes the turn.
+        // A placement must name the piece returned by nextInHand(); a Pillbug
+        // throw is played as an ordinary move of the thrown piece.
+        void play(const Move& m);
+        // Takes back the last play() exactly (stack order, hand, turn).
+        void undo();
+        const Move* lastMove() const { return history_.empty() ? nullptr : &history_.back().move; }
+
+        // Zobrist key of the board and side to move, kept up to date by every change.
+        // Pieces are keyed by color and bug, not id, so swapping two Spiders is the same position.
+        // The piece moved last is not keyed either: positions that differ only in
+        // which piece a Pillbug may not throw are one entry to the transposition
+        // tables and one position to repetitions().
+        std::uint64_t hash() const { return hash_; }
+        // Earlier occurrences of this exact position since the last placement (placements
+        // are irreversible, so nothing older can repeat). Counted once at play(), which
+        // looks back over every other ply of that window; the query itself is O(1).
+        int repetitions() const {
+            const PositionEntry& e = positionAt(ply_);
+            return e.ply == ply_ ? e.reps : 0;
+        }
+        // Plies after which the game is drawn; 0 (default) = no limit.
+        void setMoveLimit(int plies) { moveLimit_ = plies; }
+        int moveLimit() const { return moveLimit_; }
+
+        // Top pieces of each color on the six neighbors of a, and the empty
+        // cells where c touches only its own color (where it may place from its
+        // second piece on). Both are kept up to date by every board change, so
+        // enumerating the cells costs only the result; their order follows the
+        // history rather than the board.
+        int adjacentTops(Axial a, Color c) const {
+            auto it = adjacent_.find(a);
+            return it == adjacent_.end() ? 0 : it->second[colorIndex(c)];
+        }
+        const std::vector<Axial>& placeableCells(Color c) const { return placeable_[colorIndex(c)].cells; }
+
+        // hand / turn queries, all O(1)
+        int inHand(Color c, Bug b) const { return hand_[colorIndex(c)][bugIndex(b)]; }
+        int nextInHand(Color c, Bug b) const; // -1 when none left
+        int placementsMade(Color c) const { return placed_[colorIndex(c)]; }
+        bool queenPlaced(Color c) const { return queenId_[colorIndex(c)] >= 0; }
+        int queenId(Color c) const { return queenId_[colorIndex(c)]; } // -1 until placed
+        Color toMove() const { return toMove_; }
+        int ply() const { return ply_; }
+
+        static constexpr int kHashHistory = 1024; // largest ring size; bounds the repetition window
 
     private:
-        std::unordered_map<Axial, std::vector<int>, AxialHash> board_;
+        struct Undo { Move move; Axial from; int fromHeight; };
+
+        // one ring slot per ply; a slot is valid only while its ply matches
+        struct PositionEntry {
+            std::uint64_t hash{};
+            std::int32_t ply{ -1 };
+            std::int16_t window{};  // plies since the last placement
+            std::int16_t reps{};    // earlier occurrences within that window
+        };
+
+        void putOnBoard(int pieceId, Axial at, int height);
+        void liftOff(int pieceId);
+        void relocate(int pieceId, Axial to, bool allowStack);
+        void toggleStack(const PieceStack& stack); // xor every piece of a stack in/out of hash_
+        // the top of the stack at `at` went from oldTop to newTop (-1: empty cell)
+        void topChanged(Axial at, int oldTop, int newTop);
+        void refreshPlaceable(Axial a);
+        void recordPosition(bool irreversible);          // writes the ring slot for ply_
+        const PositionEntry& positionAt(int ply) const { return positions_[ply & (static_cast<int>(positions_.size()) - 1)]; }
+
+        Board board_;
         std::vector<Piece> pieces_;
+        Ruleset ruleset_{ Ruleset::Base };
+
+        std::array<std::array<int, kBugCount>, kColorCount> hand_{};
+        std::array<std::array<int, kBugCount>, kColorCount> handSize_{}; // starting hand, after limitHand
+        std::array<int, kColorCount> placed_{};
+        std::array<int, kColorCount> queenId_{ -1, -1 };
+        Color toMove_{ Color::White };
+        int ply_{ 0 };
+        std::vector<Undo> history_;
+
+        // dense cells plus their slots, so membership changes are O(1) and
+        // enumeration is just the vector
+        struct CellSet {
+            std::vector<Axial> cells;
+            PoolMap<Axial, int, AxialHash> slot;
+            void insert(Axial a);
+            void erase(Axial a);
+        };
+        PoolMap<Axial, std::array<std::uint8_t, kColorCount>, AxialHash> adjacent_; // nonzero counts only
+        std::array<CellSet, kColorCount> placeable_;
+
+        std::uint64_t hash_{ 0 };
+        int moveLimit_{ 0 };
+        // one slot per ply, a power of two that grows with ply_ up to
+        // kHashHistory, so copying or restoring an early position stays cheap
+        std::vector<PositionEntry> positions_;
     };
 
+    // Notation: piece names follow the usual Hive style (wQ, bS1, wA3); a move is
+    // "<piece>@q,r" for placements and moves alike, or "pass".
+    std::string pieceName(const GameState& s, int pieceId);
+    std::string moveToString(const GameState& s, const Move& m);
+    // Inverse of moveToString for the hand pieces of s.ruleset(); a piece not yet on
+    // the board makes a placement. nullopt when the text does not name a move.
+    std::optional<Move> parseMove(const GameState& s, std::string_view text);
+
     struct Pixel { float x{}, y{}; };
     Pixel axialToPixel(Axial a, float hexSize);
 
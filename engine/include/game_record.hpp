@@ -0,0 +1,52 @@
+#pragma once
+#include "rules.hpp"
+#include <fstream>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hive {
+
+    // One finished (or abandoned) game, one per line in text form:
+    //   <ruleset> <result> <move> <move> ...
+    // ruleset is "base" or "mlp", result "1-0", "0-1", "1/2" or "*" (unfinished),
+    // moves use moveToString notation ("wQ@0,0", "bA1@1,-1", "pass").
+    struct GameRecord {
+        Ruleset ruleset{ Ruleset::Base };
+        GameOver result{ GameOver::None };
+        std::vector<Move> moves;
+    };
+
+    std::string formatRecord(const GameRecord& g);
+    // Replays the moves to resolve notation; nullopt on a malformed line, an
+    // unknown piece, an illegal move or a move after the game ended.
+    std::optional<GameRecord> parseRecord(std::string_view line);
+
+    // Reads every record of a stream, skipping blank lines and '#' comments.
+    // Malformed lines are counted in *rejected when given.
+    std::vector<GameRecord> readRecords(std::istream& in, int* rejected = nullptr);
+
+    // Random access to the records of a file too large to read whole. Only
+    // line offsets are kept: the file is indexed up to the furthest record
+    // asked for, and a record is parsed each time it is fetched, so the first
+    // game is there at once. Comments and malformed lines are skipped as in
+    // readRecords().
+    class RecordArchive {
+    public:
+        bool open(const std::string& path);
+        std::optional<GameRecord> get(std::size_t index); // nullopt past the last record
+        std::size_t indexed() const { return offsets_.size(); } // records located so far
+        bool complete() const { return complete_; }              // then indexed() is the total
+
+    private:
+        bool indexNext(); // locates one more record; false at the end of the file
+
+        std::ifstream in_;
+        std::vector<std::streamoff> offsets_;
+        std::streamoff scanned_{ 0 }; // where indexing goes on
+        bool complete_{ false };
+    };
+
+} // namespace hive
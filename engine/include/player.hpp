@@ -0,0 +1,59 @@
+#pragma once
+#include "book.hpp"
+#include "search.hpp"
+#include <memory>
+#include <thread>
+
+namespace hive {
+
+    // One engine side of a timed game, for match runners and protocol front
+    // ends. go() answers from the opening book or, with a single legal move,
+    // at once; otherwise it searches under the time manager. Between turns it
+    // can ponder: search the position after the reply it expects, on its own
+    // thread, until the next go(). If that reply was played, go() turns the
+    // running search into the real one (a ponder hit); otherwise the ponder
+    // is stopped and only its table entries carry over.
+    class EnginePlayer {
+    public:
+        enum class Source { Book, Forced, Search, PonderHit };
+        struct Decision {
+            Move move{ Move::pass() };
+            Move ponder{ Move::pass() }; // expected reply; pass when the line ends here
+            bool hasPonder{ false };
+            Source source{ Source::Search };
+            int score{};
+            int depth{};
+            std::int64_t nodes{};
+        };
+
+        explicit EnginePlayer(std::shared_ptr<TranspositionTable> table = nullptr);
+        ~EnginePlayer();
+        EnginePlayer(const EnginePlayer&) = delete;
+        EnginePlayer& operator=(const EnginePlayer&) = delete;
+
+        void setBook(std::shared_ptr<const OpeningBook> book, std::uint32_t minVisits = 4);
+        void setMaxDepth(int depth) { maxDepth_ = depth; }
+
+        Decision go(const GameState& s, const TimeControl& clock, const InfoCallback& onInfo = {});
+
+        // s is the position after our move. False (and nothing started) if
+        // expected is not legal there or ends the game.
+        bool startPonder(const GameState& s, const Move& expected, const InfoCallback& onInfo = {});
+        void stopPonder();
+        bool pondering() const { return ponderThread_.joinable(); }
+
+    private:
+        Decision finish(const SearchResult& r, Source source) const;
+
+        Searcher searcher_;
+        std::shared_ptr<const OpeningBook> book_;
+        std::uint32_t bookMinVisits_{ 4 };
+        int maxDepth_{ 64 };
+
+        std::thread ponderThread_;
+        std::uint64_t ponderHash_{ 0 }; // position being pondered
+        int ponderPly_{ -1 };
+        SearchResult ponderResult_;     // written by the ponder thread, read after join
+    };
+
+} // namespace hive
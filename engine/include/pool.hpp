@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace hive {
+
+    // Small-block pool for the engine's node-based containers (board cells,
+    // visited sets). Blocks up to kMaxBlock bytes come from per-thread free
+    // lists in 16-byte size classes, refilled from 64 KiB chunks, so move
+    // generation on several threads never meets in malloc. A block freed on
+    // another thread joins that thread's lists; lists of a finished thread go
+    // to a shared depot that the next refill drains. Chunks are kept for the
+    // life of the process.
+    namespace pool {
+
+        constexpr std::size_t kMaxBlock = 256; // larger requests use the global heap
+
+        void* allocate(std::size_t bytes);
+        void deallocate(void* p, std::size_t bytes) noexcept;
+
+        // Route every request to the global heap instead (for A/B benchmarks).
+        // Flip only while no pool-allocated container is alive.
+        void setEnabled(bool on);
+        bool enabled();
+
+        // Bytes taken from the global heap for chunks so far, by every thread.
+        std::size_t reservedBytes();
+
+    } // namespace pool
+
+    template <typename T>
+    struct PoolAllocator {
+        static_assert(alignof(T) <= 16, "pool blocks are 16-byte aligned");
+        using value_type = T;
+
+        PoolAllocator() noexcept = default;
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n) { return static_cast<T*>(pool::allocate(n * sizeof(T))); }
+        void deallocate(T* p, std::size_t n) noexcept { pool::deallocate(p, n * sizeof(T)); }
+
+        template <typename U>
+        friend bool operator==(const PoolAllocator&, const PoolAllocator<U>&) noexcept { return true; }
+    };
+
+    template <typename K, typename Hash = std::hash<K>>
+    using PoolSet = std::unordered_set<K, Hash, std::equal_to<K>, PoolAllocator<K>>;
+
+    template <typename K, typename V, typename Hash = std::hash<K>>
+    using PoolMap = std::unordered_map<K, V, Hash, std::equal_to<K>, PoolAllocator<std::pair<const K, V>>>;
+
+} // namespace hive
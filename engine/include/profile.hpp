@@ -0,0 +1,108 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Hot-path instrumentation, compiled in only with HIVE_PROFILE (CMake option of
+// the same name). Without it HIVE_PROFILE_ZONE / HIVE_PROFILE_COUNT expand to
+// nothing, and the reporting functions below report that profiling is off.
+//
+// Every thread records into its own block (plain stores, no atomics RMW), so
+// the searcher and a UI worker can be profiled at the same time. Reading
+// (summary, trace export, reset) is meant for quiescent points: between bench
+// phases or after a match, not while a search is running.
+
+namespace hive::profile {
+
+    // Timed regions. Zones nest; each reports inclusive time.
+    enum class Zone : std::uint8_t {
+        GenerateMoves,
+        Placement,
+        Pinned,         // articulation points for a whole position
+        Connectivity,   // keepsHiveConnectedAfter
+        Queen, Beetle, Spider, Grasshopper, Ant, Mosquito, Ladybug, Pillbug, // per-bug generators, Bug order
+        Throws,
+        GameOver,
+        Count
+    };
+
+    // Event counts that have no duration of their own.
+    enum class Counter : std::uint8_t {
+        MovesGenerated,   // moves returned by generateMoves or counted by countLegalMoves
+        PlacementCells,   // candidate placement cells listed or counted
+        // connectivity questions settled per tier (keepsHiveConnectedAfter, isPinned)
+        ConnectivityStackTop, ConnectivityRing, ConnectivityBounded, ConnectivityFull,
+        Count
+    };
+
+    constexpr int kZoneCount = static_cast<int>(Zone::Count);
+    constexpr int kCounterCount = static_cast<int>(Counter::Count);
+
+#ifdef HIVE_PROFILE
+    constexpr bool kEnabled = true;
+#else
+    constexpr bool kEnabled = false;
+#endif
+
+    const char* zoneName(Zone z);
+    const char* counterName(Counter c);
+
+    struct ZoneStats {
+        std::uint64_t calls{};
+        std::uint64_t ns{};
+    };
+
+    // Totals over every thread that has recorded so far.
+    struct Snapshot {
+        ZoneStats zones[kZoneCount]{};
+        std::uint64_t counters[kCounterCount]{};
+    };
+
+    Snapshot snapshot();
+    // Activity between two snapshots, e.g. one benchmark phase.
+    Snapshot operator-(const Snapshot& later, const Snapshot& earlier);
+    void reset(); // zeroes counters and drops buffered trace events
+
+    // Table of zones and counters, sorted by time.
+    void printSummary(std::FILE* out, const Snapshot& s);
+    inline void printSummary(std::FILE* out = stdout) { printSummary(out, snapshot()); }
+
+    // Trace events are buffered only while tracing is on, up to maxEventsPerThread
+    // per thread (later ones are dropped and counted).
+    void setTracing(bool on, std::size_t maxEventsPerThread = std::size_t{ 1 } << 20);
+    // Chrome trace-event JSON (chrome://tracing, Perfetto). false if it cannot write.
+    bool writeChromeTrace(const std::string& path);
+
+#ifdef HIVE_PROFILE
+    namespace detail {
+        using Clock = std::chrono::steady_clock;
+        void count(Counter c, std::uint64_t n);
+        void record(Zone z, Clock::time_point t0, Clock::time_point t1);
+    }
+
+    class ScopedZone {
+    public:
+        explicit ScopedZone(Zone z) : zone_(z), t0_(detail::Clock::now()) {}
+        ~ScopedZone() { detail::record(zone_, t0_, detail::Clock::now()); }
+        ScopedZone(const ScopedZone&) = delete;
+        ScopedZone& operator=(const ScopedZone&) = delete;
+
+    private:
+        Zone zone_;
+        detail::Clock::time_point t0_;
+    };
+#endif
+
+} // namespace hive::profile
+
+#define HIVE_PROFILE_CAT2(a, b) a##b
+#define HIVE_PROFILE_CAT(a, b) HIVE_PROFILE_CAT2(a, b)
+
+#ifdef HIVE_PROFILE
+#define HIVE_PROFILE_ZONE(zone) ::hive::profile::ScopedZone HIVE_PROFILE_CAT(hiveProfileZone_, __LINE__)(zone)
+#define HIVE_PROFILE_COUNT(counter, n) ::hive::profile::detail::count((counter), static_cast<std::uint64_t>(n))
+#else
+#define HIVE_PROFILE_ZONE(zone) ((void)0)
+#define HIVE_PROFILE_COUNT(counter, n) ((void)0)
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+#include "game_record.hpp"
+#include <vector>
+
+namespace hive {
+
+    // Seeking within a recorded game. A snapshot is kept every `every` plies,
+    // so any ply is one GameState::restore() and a few moves away: fewer than
+    // `every` during placements, and from the keyframe before the last
+    // placement once pieces only move, so repetitions (and a threefold draw)
+    // count as in the game played through. Navigation drives the caller's
+    // state, which must only be moved by these calls: stepping back is an
+    // undo() while the state's history reaches back far enough, and a restore
+    // only past that.
+    class GameReplay {
+    public:
+        explicit GameReplay(GameRecord record, int every = 16);
+
+        const GameRecord& record() const { return record_; }
+        int length() const { return static_cast<int>(record_.moves.size()); } // plies
+        std::size_t keyframes() const { return keyframes_.size(); }
+
+        void seek(GameState& s, int ply) const; // clamped to [0, length()]
+        bool forward(GameState& s) const;       // false at the end
+        bool back(GameState& s) const;          // false at the start
+
+    private:
+        void restoreAt(GameState& s, int ply) const; // nearest keyframe, then forward
+
+        GameRecord record_;
+        int every_;
+        std::vector<PositionSnapshot> keyframes_; // keyframes_[k] is ply k * every_
+    };
+
+} // namespace hive
@@ -0,0 +1,94 @@
+#pragma once
+#include "book.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hive {
+
+    // A base game where each side holds only some of its pieces, e.g. a Queen,
+    // a Spider and an Ant. Written as the bug letters of each hand, "QSA" for
+    // both sides or "QSAG/QSA" for white/black; every hand needs its Queen.
+    struct RetroVariant {
+        std::array<int, kBaseBugCount> hand[kColorCount]{};
+
+        static std::optional<RetroVariant> parse(std::string_view text);
+        std::string name() const;
+        int pieces() const;
+    };
+
+    // The variant's empty board, white to move.
+    GameState variantStart(const RetroVariant& v);
+
+    // Game-theoretic value for the side to move, with distance in plies to the
+    // surround under best play (the winner hurries, the loser stalls). Positions
+    // that neither side can force, including repetition cycles, are draws.
+    enum class RetroValue : std::uint8_t { Draw, Win, Loss };
+    struct RetroResult {
+        RetroValue value{ RetroValue::Draw };
+        int distance{ 0 };
+    };
+
+    // Unmove generator: calls fn with every position (same pieces, other side to
+    // move) from which a legal move or a forced pass leads to exactly s: a piece
+    // taken back into the hand, or moved back to any cell it could move to from
+    // here (base bugs move reversibly), or the same board after a pass.
+    // Predecessors that are themselves unreachable, such as a split hive, are
+    // not filtered out.
+    void forEachPredecessor(const RetroVariant& v, const GameState& s, const std::function<void(const GameState&)>& fn);
+
+    struct RetroStats {
+        std::size_t positions{};
+        std::size_t wins{}, losses{}, draws{};
+        int longestWin{};  // plies, over all positions
+        double ms{};
+    };
+
+    // Enumerates every canonical position reachable from variantStart(v) (the
+    // 12 symmetries and translations folded, see canonicalHash), then solves
+    // them backward from the surrounds: level by level along unmoves, a
+    // position is won once one successor is lost and lost once every successor
+    // is won. Both phases split the positions of a level across threads
+    // (0 = hardware concurrency). Writes the table to path; nullopt if v has
+    // an expansion bug or a side without its Queen, or the file cannot be written.
+    std::optional<RetroStats> buildRetroTable(const RetroVariant& v, const std::string& path, int threads = 0);
+
+    // Read-only view of a table file, memory-mapped where the platform allows.
+    // Layout: header, bucket directory, sorted canonical keys, 16-bit results.
+    // The directory splits the keys on their top bits, so a lookup is one
+    // bucket read and a search of a few keys, and a key's rank is its slot: a
+    // minimal perfect index into the result array.
+    class RetroTable {
+    public:
+        RetroTable() = default;
+        ~RetroTable();
+        RetroTable(const RetroTable&) = delete;
+        RetroTable& operator=(const RetroTable&) = delete;
+
+        bool load(const std::string& path);
+        bool empty() const { return count_ == 0; }
+        std::size_t size() const { return count_; }
+        const RetroVariant& variant() const { return variant_; }
+
+        std::optional<RetroResult> find(std::uint64_t key) const;
+        std::optional<RetroResult> find(const GameState& s) const { return find(canonicalHash(s)); }
+
+    private:
+        void release();
+
+        RetroVariant variant_{};
+        std::size_t count_{ 0 };
+        int bucketBits_{ 0 };
+        const std::uint32_t* buckets_{ nullptr };
+        const std::uint64_t* keys_{ nullptr };
+        const std::uint16_t* results_{ nullptr };
+        void* mapping_{ nullptr };          // mmap'ed file, or
+        std::size_t mappedBytes_{ 0 };
+        std::vector<std::uint64_t> buffer_; // the file read into memory
+    };
+
+} // namespace hive
@@ -1,31 +1,161 @@
 #pragma once
 #include "engine.hpp"
+#include <limits>
 #include <vector>
 
 namespace hive {
 
-    enum class MoveKind { Place, Slide, Climb, Jump };
+    enum class MoveKind : std::uint8_t { Place, Slide, Climb, Jump, Throw };
 
+    // The piece starts from its current cell, so only the destination is kept.
     struct LegalMove {
         int pieceId;
-        Axial from;
         Axial to;
         MoveKind kind;
-        int steps{ 1 };
+        std::uint8_t steps{ 1 }; // path length: Spider/Ladybug 3, Throw 2, 0 = any (Ant, Grasshopper)
     };
+    static_assert(sizeof(LegalMove) == 16);
 
+    // Canonical 32-bit move: the form for tables, records and batch outputs.
+    //   bits  0-15  destination, q and r as two's-complement bytes
+    //   bits 16-22  piece id (kPassPiece = pass)
+    //   bit     23  placement
+    //   bits 24-26  MoveKind + 1, or 0 when packed from a plain Move
+    //   bits 27-28  steps
+    // The low 24 bits identify the move; kind and steps only ride along, so a
+    // packed LegalMove equals the packed Move it produces. Coordinates must lie
+    // in [-128, 127] and piece ids below kPassPiece, which any game satisfies.
+    struct PackedMove {
+        static constexpr std::uint32_t kPassPiece = 0x7f;
+        static constexpr std::uint32_t kIdentityMask = 0x00ffffff;
+
+        std::uint32_t bits{ kPassPiece << 16 };
+
+        constexpr std::uint32_t key() const { return bits & kIdentityMask; }
+        constexpr bool isPass() const { return ((bits >> 16) & 0x7f) == kPassPiece; }
+        constexpr int pieceId() const { return isPass() ? -1 : static_cast<int>((bits >> 16) & 0x7f); }
+        constexpr Axial to() const {
+            return { static_cast<std::int8_t>(bits & 0xff), static_cast<std::int8_t>((bits >> 8) & 0xff) };
+        }
+        constexpr bool isPlacement() const { return (bits >> 23) & 1; }
+        constexpr bool hasKind() const { return ((bits >> 24) & 7) != 0; }
+        constexpr MoveKind kind() const { return static_cast<MoveKind>(((bits >> 24) & 7) - 1); } // when hasKind()
+        constexpr int steps() const { return static_cast<int>((bits >> 27) & 3); }
+
+        friend constexpr bool operator==(PackedMove a, PackedMove b) { return a.key() == b.key(); }
+    };
+    static_assert(sizeof(PackedMove) == 4);
+
+    namespace detail {
+        constexpr std::uint32_t packCell(Axial a) {
+            return static_cast<std::uint8_t>(a.q) | static_cast<std::uint32_t>(static_cast<std::uint8_t>(a.r)) << 8;
+        }
+    }
+
+    constexpr PackedMove pack(const Move& m) {
+        if (m.isPass()) return {};
+        return { detail::packCell(m.to) | static_cast<std::uint32_t>(m.pieceId) << 16 | std::uint32_t{ m.isPlacement } << 23 };
+    }
+    constexpr PackedMove pack(const LegalMove& m) {
+        return { detail::packCell(m.to) | static_cast<std::uint32_t>(m.pieceId) << 16
+            | std::uint32_t{ m.kind == MoveKind::Place } << 23
+            | (static_cast<std::uint32_t>(m.kind) + 1) << 24 | (std::uint32_t{ m.steps } & 3) << 27 };
+    }
+    constexpr Move unpackMove(PackedMove p) {
+        return p.isPass() ? Move::pass() : Move{ p.pieceId(), p.to(), p.isPlacement() };
+    }
+    // A plain Move carries no kind: it comes back as Place or Slide.
+    constexpr LegalMove unpackLegalMove(PackedMove p) {
+        const MoveKind kind = p.hasKind() ? p.kind() : p.isPlacement() ? MoveKind::Place : MoveKind::Slide;
+        return { p.pieceId(), p.to(), kind, static_cast<std::uint8_t>(p.steps()) };
+    }
+    // the piece a LegalMove moves, as a Move
+    constexpr Move toMove(const LegalMove& m) { return { m.pieceId, m.to, m.kind == MoveKind::Place }; }
+
+    struct PackedMoveHash {
+        size_t operator()(PackedMove m) const noexcept { return m.key() * 0x9e3779b97f4a7c15ULL >> 16; }
+    };
+
+    // Reusable move buffers for hot loops: a typical position fits inline, so
+    // generation into a list kept across calls never allocates.
+    using MoveList = SmallVector<Move, 256>;
+    using LegalMoveList = SmallVector<LegalMove, 64>;
+
+    // Moves of one board piece, ignoring whose turn it is. Covered pieces and
+    // pinned pieces (lifting them would split the hive) have none.
     std::vector<LegalMove> legalMovesForPiece(const GameState& s, int pieceId);
+    void legalMovesForPiece(const GameState& s, int pieceId, LegalMoveList& out); // appends
+
+    // legalMovesForPiece(s, pieceId).size(), walking the same paths without
+    // storing a move: an Ant counts the hive edge it reaches, a Grasshopper its
+    // open lines. With a limit, Ant and Spider walks stop once they have found
+    // that many (the result may then exceed it by a few).
+    int countLegalMovesForPiece(const GameState& s, int pieceId, int limit = std::numeric_limits<int>::max());
+    // Same, with pinnedCells(s) at hand, so no per-piece pin check.
+    int countLegalMovesForPiece(const GameState& s, int pieceId, const PoolSet<Axial, AxialHash>& pinned,
+        int limit = std::numeric_limits<int>::max());
+
+    // Pillbug ability of a board Pillbug, or of a ground Mosquito touching one:
+    // an adjacent unstacked piece goes over it to an empty neighbor. Each entry
+    // names the thrown piece (kind Throw). The piece moved last turn is exempt,
+    // and a thrower that was just moved cannot throw.
+    std::vector<LegalMove> pillbugThrows(const GameState& s, int throwerId);
+
+    // Cells where color c may place: the first piece goes to the origin, the
+    // second anywhere next to the hive, later ones touch own color only.
+    std::vector<Axial> placementTargets(const GameState& s, Color c);
+
+    // Every legal move for the side to move: placements (one per bug kind, with
+    // the queen-by-4th rule) and, once the queen is down, piece moves.
+    // Empty means the side to move must pass.
+    std::vector<Move> generateMoves(const GameState& s);
+    void generateMoves(const GameState& s, MoveList& out); // replaces out's contents
+    // Same, compiled for one ruleset (s.ruleset() must be R). generateMoves()
+    // dispatches here once; hot loops that already know R can call it directly.
+    template <Ruleset R>
+    std::vector<Move> generateMovesFor(const GameState& s);
+    template <Ruleset R>
+    void generateMovesFor(const GameState& s, MoveList& out);
+    extern template std::vector<Move> generateMovesFor<Ruleset::Base>(const GameState&);
+    extern template std::vector<Move> generateMovesFor<Ruleset::MLP>(const GameState&);
+    extern template void generateMovesFor<Ruleset::Base>(const GameState&, MoveList&);
+    extern template void generateMovesFor<Ruleset::MLP>(const GameState&, MoveList&);
+
+    // generateMoves(s).size() without building the list; 0 means a pass.
+    int countLegalMoves(const GameState& s);
+    template <Ruleset R>
+    int countLegalMovesFor(const GameState& s);
+    extern template int countLegalMovesFor<Ruleset::Base>(const GameState&);
+    extern template int countLegalMovesFor<Ruleset::MLP>(const GameState&);
+
+    // Leaf count of the move tree to the given depth (a pass is one move,
+    // finished games are leaves); the reference check for move generation.
+    // The last ply is counted with countLegalMovesFor rather than generated.
+    std::uint64_t perft(GameState& s, int depth);
 
     // helpers
-    bool keepsHiveConnectedAfter(const GameState& s, int movingPid, Axial to);
+    // Which test settled a connectivity question, cheapest first.
+    enum class ConnectivityTier { StackTop, Ring, Bounded, Full };
+    // One-hive rule for a single move on a connected hive. A piece leaving a
+    // stack and a vacated cell whose occupied neighbors form one run are decided
+    // in O(1); otherwise a search within a couple of cells of the origin, and
+    // only then a BFS of the whole hive. decidedBy reports the tier used.
+    bool keepsHiveConnectedAfter(const GameState& s, int movingPid, Axial to, ConnectivityTier* decidedBy = nullptr);
     bool canSlideBetween(const GameState& s, Axial from, Axial to);
     bool occupied(const GameState& s, Axial a);
     int  stackHeight(const GameState& s, Axial a);
 
+    // One-hive rule during transit: a lone piece on an articulation cell cannot move.
+    // Uses the same tiers as keepsHiveConnectedAfter.
+    bool isPinned(const GameState& s, int pieceId);
+    // All articulation cells of the hive, found in one pass.
+    PoolSet<Axial, AxialHash> pinnedCells(const GameState& s);
+
     // Add near the other helpers
     bool queenSurrounded(const GameState& s, Color c);
 
-    // If both queens are surrounded at once -> draw
+    // If both queens are surrounded at once -> draw. Also a draw: the third
+    // occurrence of a position, or reaching s.moveLimit() plies.
     enum class GameOver { None, WhiteWins, BlackWins, Draw };
     GameOver evaluateGameOver(const GameState& s);
 
@@ -0,0 +1,137 @@
+#pragma once
+#include "rules.hpp"
+#include "time_manager.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hive {
+
+    // Decisive scores are kWinScore minus the ply of the surround, so faster wins rank higher.
+    constexpr int kWinScore = 100000;
+    constexpr int kWinThreshold = kWinScore - 1000;
+
+    // Static evaluation from the side to move's point of view.
+    int evaluate(const GameState& s);
+
+    struct SearchLimits {
+        int maxDepth{ 64 };
+        std::int64_t maxNodes{ 0 };  // 0 = no limit
+        int moveTimeMs{ 0 };         // 0 = no limit
+        std::vector<Move> searchMoves; // restrict the root to these (legal) moves; empty = all
+        int multiPv{ 1 };              // exact scores and lines for this many best root moves
+        TimeControl clock{};           // when timed, the time manager sets the budget; a forced move returns at once
+        bool ponder{ false };          // ignore time and nodes until Searcher::ponderHit(), and never return before it (or stop())
+    };
+
+    // Reported after every completed iteration, once per multi-PV line (best first).
+    struct SearchInfo {
+        int depth{};
+        int multiPv{ 1 };  // 1-based rank of this line
+        int score{};
+        std::int64_t nodes{};
+        int timeMs{};
+        std::vector<Move> pv;
+    };
+
+    struct SearchResult {
+        Move best{ Move::pass() };
+        int score{};
+        int depth{};
+        std::int64_t nodes{};
+        std::vector<Move> pv;
+    };
+
+    using InfoCallback = std::function<void(const SearchInfo&)>;
+
+    // Transposition table of search results by Zobrist hash (Searcher salts
+    // MLP keys, so one table serves both rulesets), one slot per index.
+    // Safe to share between searchers on different threads: a slot keeps its
+    // key XOR its data, so a torn write reads back as a miss rather
+    // than a wrong entry. Win scores are stored relative to the node.
+    class TranspositionTable {
+    public:
+        enum class Bound : std::uint8_t { None, Upper, Lower, Exact };
+        struct Hit {
+            int score{};
+            int depth{};
+            Bound bound{ Bound::None };
+            PackedMove move{};
+        };
+
+        explicit TranspositionTable(std::size_t entries = std::size_t{ 1 } << 18); // rounded down to a power of two
+        bool probe(std::uint64_t key, Hit& out) const;
+        // Replaces the slot unless it holds a deeper result for another position
+        // from the current search.
+        void store(std::uint64_t key, int depth, int score, Bound bound, PackedMove move);
+        void newSearch() { age_ = (age_ + 1) & 0x3f; }
+        void clear();
+        std::size_t size() const { return mask_ + 1; }
+        int permilleFull() const; // of the first thousand slots, filled this search
+
+    private:
+        struct Slot {
+            std::atomic<std::uint64_t> check{ 0 }; // key ^ data
+            std::atomic<std::uint64_t> data{ 0 };
+        };
+        std::unique_ptr<Slot[]> slots_;
+        std::size_t mask_{ 0 };
+        std::uint8_t age_{ 0 };
+    };
+
+    // Iterative-deepening alpha-beta (negamax) over generateMoves(), with a
+    // transposition table kept between searches (warm for the next move or a
+    // ponder hit) and shareable with other searchers through setTable().
+    // stop() may be called from any thread and stays latched until clearStop();
+    // an interrupted search returns the last completed iteration.
+    class Searcher {
+    public:
+        Searcher() : table_(std::make_shared<TranspositionTable>()) {}
+
+        SearchResult search(const GameState& root, const SearchLimits& limits, const InfoCallback& onInfo = {});
+        void stop() { stop_.store(true, std::memory_order_relaxed); }
+        void clearStop() { stop_.store(false, std::memory_order_relaxed); }
+        // From any thread, once a ponder search is running or about to start:
+        // the expected move was played, so the search goes on under clock,
+        // timed from now.
+        void ponderHit(const TimeControl& clock);
+
+        void setTable(std::shared_ptr<TranspositionTable> table) { table_ = std::move(table); }
+        TranspositionTable& table() { return *table_; }
+
+    private:
+        struct RootMove { Move move; int score; std::vector<Move> pv; };
+
+        // compiled per ruleset; search() picks one from root.ruleset()
+        template <Ruleset R>
+        void searchRoot(GameState& s, int depth, std::vector<RootMove>& roots);
+        template <Ruleset R>
+        int negamax(GameState& s, int depth, int ply, int alpha, int beta, std::vector<Move>& pv);
+        void orderMoves(const GameState& s, MoveList& moves, int ply, PackedMove ttMove = {}) const;
+        bool outOfBudget();
+        void startClock(const TimeControl& clock, int ply);
+        int elapsedMs() const;
+
+        std::atomic<bool> stop_{ false };
+        std::atomic<bool> ponderHit_{ false };
+        std::mutex ponderMutex_;
+        TimeControl hitClock_{}; // guarded by ponderMutex_
+        bool pondering_{ false };
+        int rootPly_{ 0 };
+        SearchLimits limits_{};
+        std::int64_t nodes_{ 0 };
+        std::chrono::steady_clock::time_point start_{};
+        std::chrono::steady_clock::time_point deadline_{}; // hard stop when timed
+        bool timed_{ false };
+        TimeManager time_;
+        bool aborted_{ false };
+        std::shared_ptr<TranspositionTable> table_;
+        std::vector<Move> prevPv_;
+        std::vector<MoveList> plyMoves_; // one buffer per ply, kept between searches
+    };
+
+} // namespace hive
@@ -0,0 +1,155 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace hive {
+
+    // Vector with room for N elements inside the object; only growing past N
+    // touches the heap. Limited to trivially copyable T (moves, cells, piece
+    // ids), so elements are copied with memcpy and never destroyed.
+    template <typename T, std::size_t N>
+    class SmallVector {
+        static_assert(std::is_trivially_copyable_v<T>, "SmallVector holds trivially copyable types only");
+        static_assert(N > 0);
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+
+        SmallVector() noexcept = default;
+        SmallVector(std::initializer_list<T> init) { assign(init.begin(), init.end()); }
+        SmallVector(const SmallVector& o) { assign(o.begin(), o.end()); }
+        SmallVector(SmallVector&& o) noexcept { steal(o); }
+        ~SmallVector() { release(); }
+
+        SmallVector& operator=(const SmallVector& o) {
+            if (this != &o) assign(o.begin(), o.end());
+            return *this;
+        }
+        SmallVector& operator=(SmallVector&& o) noexcept {
+            if (this != &o) {
+                release();
+                steal(o);
+            }
+            return *this;
+        }
+
+        template <typename It>
+        void assign(It first, It last) {
+            clear();
+            reserve(static_cast<size_type>(std::distance(first, last)));
+            for (; first != last; ++first) data_[size_++] = *first;
+        }
+
+        size_type size() const noexcept { return size_; }
+        size_type capacity() const noexcept { return cap_; }
+        bool empty() const noexcept { return size_ == 0; }
+        bool onHeap() const noexcept { return data_ != inlineData(); }
+
+        T* data() noexcept { return data_; }
+        const T* data() const noexcept { return data_; }
+        iterator begin() noexcept { return data_; }
+        iterator end() noexcept { return data_ + size_; }
+        const_iterator begin() const noexcept { return data_; }
+        const_iterator end() const noexcept { return data_ + size_; }
+
+        T& operator[](size_type i) noexcept { return data_[i]; }
+        const T& operator[](size_type i) const noexcept { return data_[i]; }
+        T& front() noexcept { return data_[0]; }
+        const T& front() const noexcept { return data_[0]; }
+        T& back() noexcept { return data_[size_ - 1]; }
+        const T& back() const noexcept { return data_[size_ - 1]; }
+
+        void clear() noexcept { size_ = 0; } // keeps capacity, heap or inline
+        void reserve(size_type n) {
+            if (n > cap_) grow(n);
+        }
+        void push_back(const T& v) {
+            if (size_ == cap_) {
+                const T copy = v; // v may live in the buffer being replaced
+                grow(size_type{ cap_ } * 2);
+                data_[size_++] = copy;
+                return;
+            }
+            data_[size_++] = v;
+        }
+        template <typename... Args>
+        T& emplace_back(Args&&... args) {
+            push_back(T{ std::forward<Args>(args)... });
+            return back();
+        }
+        void pop_back() noexcept { --size_; }
+
+        iterator insert(const_iterator pos, const T& v) {
+            const size_type i = static_cast<size_type>(pos - data_);
+            const T copy = v;
+            if (size_ == cap_) grow(size_type{ cap_ } * 2);
+            std::memmove(static_cast<void*>(data_ + i + 1), data_ + i, (size_ - i) * sizeof(T));
+            data_[i] = copy;
+            ++size_;
+            return data_ + i;
+        }
+        iterator erase(const_iterator first, const_iterator last) noexcept {
+            const size_type i = static_cast<size_type>(first - data_);
+            const size_type n = static_cast<size_type>(last - first);
+            std::memmove(static_cast<void*>(data_ + i), data_ + i + n, (size_ - i - n) * sizeof(T));
+            size_ -= static_cast<std::uint32_t>(n);
+            return data_ + i;
+        }
+        iterator erase(const_iterator pos) noexcept { return erase(pos, pos + 1); }
+
+        friend bool operator==(const SmallVector& a, const SmallVector& b) {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end());
+        }
+        friend bool operator!=(const SmallVector& a, const SmallVector& b) { return !(a == b); }
+
+    private:
+        T* inlineData() noexcept { return std::launder(reinterpret_cast<T*>(inline_)); }
+        const T* inlineData() const noexcept { return std::launder(reinterpret_cast<const T*>(inline_)); }
+
+        void grow(size_type n) {
+            n = std::max({ n, size_type{ cap_ } * 2, N * 2 });
+            T* p = static_cast<T*>(::operator new(n * sizeof(T)));
+            if (size_) std::memcpy(static_cast<void*>(p), data_, size_ * sizeof(T));
+            release();
+            data_ = p;
+            cap_ = static_cast<std::uint32_t>(n);
+        }
+        void release() noexcept {
+            if (onHeap()) ::operator delete(data_);
+            data_ = inlineData();
+            cap_ = N;
+        }
+        // takes o's heap buffer, or copies its inline elements; o is left empty
+        void steal(SmallVector& o) noexcept {
+            if (o.onHeap()) {
+                data_ = o.data_;
+                cap_ = o.cap_;
+                o.data_ = o.inlineData();
+                o.cap_ = N;
+            }
+            else if (o.size_) {
+                std::memcpy(static_cast<void*>(data_), o.data_, o.size_ * sizeof(T));
+            }
+            size_ = o.size_;
+            o.size_ = 0;
+        }
+
+        T* data_{ inlineData() };
+        std::uint32_t size_{ 0 };
+        std::uint32_t cap_{ N };
+        alignas(T) unsigned char inline_[N * sizeof(T)];
+    };
+
+} // namespace hive
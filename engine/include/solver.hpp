@@ -0,0 +1,89 @@
+#pragma once
+#include "rules.hpp"
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace hive {
+
+    // A move by the side to move that surrounds the enemy queen at once (and
+    // not its own). Only cells next to that queen can finish it, so unless it
+    // has exactly one empty neighbor, and no Pillbug could throw it, nothing is
+    // generated. s is played on and restored.
+    std::optional<Move> findSurroundInOne(GameState& s);
+    std::optional<Move> findSurroundInOne(GameState& s, MoveList& scratch); // reuses scratch for the move list
+
+    enum class ProofResult {
+        Win,     // the side to move forces a queen surround within the move bound
+        NoWin,   // every line within the bound is defended (draws count as defended)
+        Unknown, // node budget spent or stopped first
+    };
+
+    struct SolveLimits {
+        int maxMoves{ 3 };              // attacker moves, so at most 2*maxMoves-1 plies
+        std::int64_t maxNodes{ 2'000'000 }; // 0 = no limit
+    };
+
+    struct SolveResult {
+        ProofResult result{ ProofResult::Unknown };
+        Move best{ Move::pass() };
+        int winInMoves{ 0 };   // shortest forced win found, when result is Win
+        std::vector<Move> pv;  // attacker and defender moves down to the surround
+        std::int64_t nodes{};
+    };
+
+    // Depth-first proof-number (df-pn) search for forced queen surrounds.
+    // The side to move at the root attacks; each attacker node first asks
+    // findSurroundInOne, so the last attacker move of every line costs one
+    // threat check instead of a subtree. Bounds are tried shortest first
+    // (mate in 1, 2, ...) over one transposition table, which keeps proofs
+    // and disproofs between bounds and between solve() calls. Proof numbers
+    // are relative to the attacker, so keys are salted with it and with the
+    // ruleset: calls attacking with either side share the table safely.
+    // stop() may be called from any thread and stays latched until clearStop().
+    class ProofSolver {
+    public:
+        explicit ProofSolver(std::size_t ttEntries = std::size_t{ 1 } << 20);
+
+        SolveResult solve(const GameState& root, const SolveLimits& limits);
+        void stop() { stop_.store(true, std::memory_order_relaxed); }
+        void clearStop() { stop_.store(false, std::memory_order_relaxed); }
+        void clearTable();
+
+    private:
+        struct Entry {
+            std::uint64_t key{};
+            std::uint32_t pn{};
+            std::uint32_t dn{};
+            PackedMove best{};
+            std::int16_t plies{ -1 }; // remaining plies the numbers were computed for; -1 = empty
+        };
+        struct Child {
+            Move move;
+            std::uint64_t key;
+            std::uint32_t pn, dn;
+        };
+        struct Numbers { std::uint32_t pn, dn; };
+
+        Numbers mid(GameState& s, int plies, std::uint32_t thPn, std::uint32_t thDn);
+        void expand(GameState& s, int plies, std::vector<Child>& children);
+        bool lookup(std::uint64_t key, int plies, Numbers& out) const;
+        void store(std::uint64_t key, int plies, Numbers n, const Move& best);
+        const Entry* probe(std::uint64_t key) const;
+        std::uint64_t key(const GameState& s) const { return s.hash() ^ keySalt_; }
+        std::vector<Move> principalLine(GameState& s, int plies);
+        bool outOfBudget() const;
+
+        std::vector<Entry> table_;
+        std::vector<std::vector<Child>> plyChildren_; // one buffer per ply, kept between solves
+        MoveList scratch_;
+        Color attacker_{ Color::White };
+        std::uint64_t keySalt_{ 0 };
+        int rootPlies_{ 0 };
+        std::int64_t nodes_{ 0 };
+        std::int64_t maxNodes_{ 0 };
+        std::atomic<bool> stop_{ false };
+    };
+
+} // namespace hive
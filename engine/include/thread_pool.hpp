@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hive {
+
+    // Work-stealing task pool. Every worker has its own queue and runs it
+    // oldest first; an idle worker steals the newest task of another queue.
+    // Tasks submitted from outside are dealt round robin, tasks submitted by a
+    // task go to the back of the submitting worker's queue, so a task that
+    // resubmits itself (a time slice) waits behind the work already queued
+    // there. The destructor runs every queued task, then joins.
+    class ThreadPool {
+    public:
+        explicit ThreadPool(int threads = 0); // 0 = hardware concurrency
+        ~ThreadPool();
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void submit(std::function<void()> task);
+        // Blocks until every task submitted so far, and those they submit, has run.
+        // Not for use from inside a task.
+        void wait();
+        int size() const { return static_cast<int>(workers_.size()); }
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        void run(int self);
+        bool takeTask(int self, std::function<void()>& out);
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> workers_;
+        std::mutex sleepMutex_;
+        std::condition_variable wake_;     // a task was queued, or quit
+        std::condition_variable idle_;     // outstanding reached zero
+        std::atomic<std::size_t> outstanding_{ 0 }; // queued or running
+        std::atomic<unsigned> nextQueue_{ 0 };
+        bool quit_{ false };
+    };
+
+} // namespace hive
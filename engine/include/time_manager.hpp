@@ -0,0 +1,39 @@
+#pragma once
+#include "engine.hpp"
+
+namespace hive {
+
+    // A player's clock when it is asked to move. remainingMs == 0 means untimed.
+    struct TimeControl {
+        int remainingMs{ 0 };
+        int incrementMs{ 0 };  // added after each own move
+        int movesToGo{ 0 };    // own moves until the next time control; 0 = rest of the game
+        int overheadMs{ 20 };  // kept back per move for I/O and scheduling
+        bool timed() const { return remainingMs > 0; }
+    };
+
+    // Per-move time budgets for iterative deepening. start() splits the clock
+    // into an optimum (where a quiet search stops) and a maximum (never
+    // exceeded). After each iteration, keepSearching() stretches the optimum
+    // while the best move keeps changing or the score has just dropped, and
+    // stops once another iteration would likely overrun it.
+    class TimeManager {
+    public:
+        void start(const TimeControl& tc, int ply);
+        int optimumMs() const { return optimum_; }
+        int maximumMs() const { return maximum_; }
+        int budgetMs() const; // optimum stretched by the current instability, at most maximum
+
+        bool keepSearching(int elapsedMs, const Move& best, int score);
+
+    private:
+        int optimum_{ 0 };
+        int maximum_{ 0 };
+        bool haveLast_{ false };
+        Move lastBest_{ Move::pass() };
+        int lastScore_{ 0 };
+        double instability_{ 0 }; // decaying count of best-move changes
+        double dropScale_{ 1 };   // > 1 after a score drop
+    };
+
+} // namespace hive
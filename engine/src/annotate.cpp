@@ -0,0 +1,105 @@
+#include "annotate.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace hive {
+
+    namespace {
+        // Searchers are not thread-safe, so each task borrows one for its run.
+        class SearcherPool {
+        public:
+            explicit SearcherPool(std::shared_ptr<TranspositionTable> table) : table_(std::move(table)) {}
+
+            std::unique_ptr<Searcher> take() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (free_.empty()) {
+                    auto s = std::make_unique<Searcher>();
+                    s->setTable(table_);
+                    return s;
+                }
+                auto s = std::move(free_.back());
+                free_.pop_back();
+                return s;
+            }
+
+            void give(std::unique_ptr<Searcher> s) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                free_.push_back(std::move(s));
+            }
+
+        private:
+            std::shared_ptr<TranspositionTable> table_;
+            std::mutex mutex_;
+            std::vector<std::unique_ptr<Searcher>> free_;
+        };
+
+        std::string signedScore(int score) {
+            return (score > 0 ? "+" : "") + std::to_string(score);
+        }
+    }
+
+    std::vector<GameAnnotation> annotateGames(const std::vector<GameRecord>& games, const AnnotateOptions& o,
+        std::atomic<std::int64_t>* done) {
+        std::vector<GameAnnotation> out(games.size());
+        SearcherPool searchers(std::make_shared<TranspositionTable>(o.ttEntries));
+        SearchLimits limits;
+        limits.maxDepth = std::max(1, o.depth);
+        limits.maxNodes = o.maxNodes;
+        {
+            ThreadPool pool(o.threads);
+            for (std::size_t g = 0; g < games.size(); ++g) {
+                // one task per game, replayed inside it: only the running games hold a position
+                pool.submit([&, g] {
+                    const GameRecord& game = games[g];
+                    std::vector<PlyNote>& plies = out[g].plies;
+                    plies.resize(game.moves.size());
+                    auto searcher = searchers.take();
+                    GameState s(game.ruleset);
+                    for (std::size_t i = 0; i < game.moves.size(); ++i) {
+                        const Move played = game.moves[i];
+                        PlyNote& note = plies[i];
+                        const SearchResult r = searcher->search(s, limits);
+                        note.played = played;
+                        note.best = r.best;
+                        note.bestScore = note.playedScore = r.score;
+                        // a node budget can stop the search at any depth: the
+                        // played move is searched to exactly the same one
+                        if (!(r.best == played) && r.depth > 0) {
+                            SearchLimits only = limits;
+                            only.searchMoves.assign(1, played);
+                            only.maxDepth = r.depth;
+                            only.maxNodes = 0;
+                            note.playedScore = std::min(r.score, searcher->search(s, only).score);
+                        }
+                        if (done) done->fetch_add(1, std::memory_order_relaxed);
+                        s.play(played);
+                    }
+                    searchers.give(std::move(searcher));
+                });
+            }
+        } // the pool drains before it is destroyed
+
+        for (GameAnnotation& a : out) {
+            for (const PlyNote& p : a.plies) a.flagged += p.drop() >= o.threshold;
+        }
+        return out;
+    }
+
+    void writeAnnotated(std::ostream& out, const GameRecord& g, const GameAnnotation& a, int threshold) {
+        out << formatRecord(g) << "\n";
+        GameState s(g.ruleset);
+        for (std::size_t i = 0; i < a.plies.size() && i < g.moves.size(); ++i) {
+            const PlyNote& p = a.plies[i];
+            if (p.drop() >= threshold) {
+                out << "# ply " << (i + 1) << ": " << moveToString(s, p.played) << " ?? " << signedScore(p.playedScore)
+                    << ", best " << moveToString(s, p.best) << " " << signedScore(p.bestScore) << "\n";
+            }
+            s.play(g.moves[i]);
+        }
+    }
+
+} // namespace hive
@@ -0,0 +1,178 @@
+#include "book.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace hive {
+
+    namespace {
+        constexpr char kMagic[8] = { 'H', 'I', 'V', 'E', 'B', 'O', 'O', 'K' };
+        constexpr std::uint32_t kVersion = 1;
+
+        struct FileHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t ruleset;
+            std::uint64_t count;
+        };
+        struct FileEntry {
+            std::uint64_t key;
+            BookStats stats;
+        };
+        static_assert(sizeof(FileEntry) == 24, "book entries are written as raw 24-byte records");
+
+        std::uint64_t mix(std::uint64_t x) {
+            x += 0x9e3779b97f4a7c15ULL;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        // 60 degree rotation and a reflection in axial coordinates (cube x <-> z)
+        Axial rotate(Axial a) { return { -a.r, a.q + a.r }; }
+        Axial reflect(Axial a) { return { a.r, a.q }; }
+
+        struct Cell { Color color; Bug bug; Axial pos; int height; };
+    }
+
+    std::uint64_t canonicalHash(const GameState& s) {
+        SmallVector<Cell, 32> cells; // a whole base hive fits inline
+        for (const auto& [pos, stack] : s.board()) {
+            for (int id : stack) {
+                const Piece& p = s.pieces()[id];
+                cells.push_back({ p.color, p.bug, pos, p.height });
+            }
+        }
+        const std::uint64_t side = s.toMove() == Color::Black ? 0x6a09e667f3bcc909ULL : 0;
+
+        std::uint64_t best = std::numeric_limits<std::uint64_t>::max();
+        SmallVector<Axial, 32> t;
+        for (int sym = 0; sym < 12; ++sym) {
+            // transform, then translate so the smallest (q,r) cell sits at the origin
+            Axial lo{ std::numeric_limits<int>::max(), std::numeric_limits<int>::max() };
+            t.clear();
+            for (size_t i = 0; i < cells.size(); ++i) {
+                Axial a = sym >= 6 ? reflect(cells[i].pos) : cells[i].pos;
+                for (int k = 0; k < sym % 6; ++k) a = rotate(a);
+                t.push_back(a);
+                if (a.q < lo.q || (a.q == lo.q && a.r < lo.r)) lo = a;
+            }
+            std::uint64_t h = side;
+            for (size_t i = 0; i < cells.size(); ++i) {
+                const Axial a{ t[i].q - lo.q, t[i].r - lo.r };
+                h ^= mix((static_cast<std::uint64_t>(colorIndex(cells[i].color)) << 60) ^
+                    (static_cast<std::uint64_t>(bugIndex(cells[i].bug)) << 56) ^
+                    (static_cast<std::uint64_t>(static_cast<std::uint32_t>(a.q) & 0xFFFFFF) << 32) ^
+                    (static_cast<std::uint64_t>(static_cast<std::uint32_t>(a.r) & 0xFFFFFF) << 8) ^
+                    static_cast<std::uint64_t>(cells[i].height & 0xFF));
+            }
+            best = std::min(best, h);
+        }
+        return best;
+    }
+
+    double BookStats::scoreFor(Color c) const {
+        if (visits == 0) return 0.5;
+        const double wins = c == Color::White ? whiteWins : blackWins;
+        return (wins + 0.5 * draws) / visits;
+    }
+
+    bool BookBuilder::add(const GameRecord& g) {
+        if (g.ruleset != ruleset_) return false;
+        GameState s(g.ruleset);
+        auto tally = [&] {
+            BookStats& st = stats_[canonicalHash(s)];
+            ++st.visits;
+            if (g.result == GameOver::WhiteWins) ++st.whiteWins;
+            else if (g.result == GameOver::BlackWins) ++st.blackWins;
+            else ++st.draws; // unfinished games count as draws
+        };
+        tally();
+        for (size_t i = 0; i < g.moves.size() && static_cast<int>(i) < maxPly_; ++i) {
+            s.play(g.moves[i]);
+            tally();
+        }
+        return true;
+    }
+
+    bool BookBuilder::write(const std::string& path, std::uint32_t minVisits) const {
+        std::vector<FileEntry> entries;
+        entries.reserve(stats_.size());
+        for (const auto& [key, st] : stats_) {
+            if (st.visits >= minVisits) entries.push_back({ key, st });
+        }
+        std::sort(entries.begin(), entries.end(), [](const FileEntry& a, const FileEntry& b) { return a.key < b.key; });
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        FileHeader h{};
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.version = kVersion;
+        h.ruleset = static_cast<std::uint32_t>(ruleset_);
+        h.count = entries.size();
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(FileEntry)));
+        return static_cast<bool>(out);
+    }
+
+    bool OpeningBook::load(const std::string& path) {
+        keys_.clear();
+        stats_.clear();
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) return false;
+        const std::size_t bytes = static_cast<std::size_t>(in.tellg());
+        in.seekg(0);
+        FileHeader h{};
+        if (bytes < sizeof(h) || !in.read(reinterpret_cast<char*>(&h), sizeof(h))) return false;
+        if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion || h.ruleset > 1) return false;
+        // the count is checked against the file before anything is sized by it
+        if ((bytes - sizeof(h)) % sizeof(FileEntry) != 0 || h.count != (bytes - sizeof(h)) / sizeof(FileEntry)) return false;
+
+        std::vector<FileEntry> entries(h.count);
+        if (!in.read(reinterpret_cast<char*>(entries.data()), static_cast<std::streamsize>(h.count * sizeof(FileEntry)))) return false;
+        ruleset_ = static_cast<Ruleset>(h.ruleset);
+        keys_.reserve(entries.size());
+        stats_.reserve(entries.size());
+        for (const FileEntry& e : entries) {
+            keys_.push_back(e.key);
+            stats_.push_back(e.stats);
+        }
+        if (!std::is_sorted(keys_.begin(), keys_.end())) {
+            keys_.clear();
+            stats_.clear();
+            return false;
+        }
+        return true;
+    }
+
+    std::optional<BookStats> OpeningBook::find(std::uint64_t key) const {
+        auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+        if (it == keys_.end() || *it != key) return std::nullopt;
+        return stats_[it - keys_.begin()];
+    }
+
+    std::optional<Move> OpeningBook::pick(const GameState& s, std::uint32_t minVisits) const {
+        if (empty() || s.ruleset() != ruleset_) return std::nullopt;
+        const Color us = s.toMove();
+        GameState probe = s;
+        std::optional<Move> best;
+        double bestScore = -1.0;
+        std::uint32_t bestVisits = 0;
+        for (const Move& m : generateMoves(s)) {
+            probe.play(m);
+            const auto st = find(probe);
+            probe.undo();
+            if (!st || st->visits < minVisits) continue;
+            // mirrored moves reach the same entry; the first one found is kept
+            const double sc = st->scoreFor(us);
+            if (sc > bestScore || (sc == bestScore && st->visits > bestVisits)) {
+                best = m;
+                bestScore = sc;
+                bestVisits = st->visits;
+            }
+        }
+        return best;
+    }
+
+} // namespace hive
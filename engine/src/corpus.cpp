@@ -0,0 +1,114 @@
+#include "corpus.hpp"
+#include "book.hpp"
+#include <algorithm>
+#include <ostream>
+#include <random>
+#include <unordered_set>
+
+namespace hive {
+
+    namespace {
+        // chance of sampling any one ply, so a game's positions spread out
+        constexpr int kSampleOneIn = 3;
+
+        int moveWeight(const GameState& s, const Move& m) {
+            if (m.isPass() || m.isPlacement) return 1;
+            return occupied(s, m.to) ? 8 : 3;
+        }
+    }
+
+    int corpusBucket(const GameState& s) {
+        int pieces = 0, tallest = 0;
+        for (const auto& [pos, stack] : s.board()) {
+            pieces += static_cast<int>(stack.size());
+            tallest = std::max(tallest, static_cast<int>(stack.size()));
+        }
+        const int pieceBand = std::clamp((pieces - 2) / 4, 0, kCorpusPieceBands - 1);
+        const int stackBand = std::clamp(tallest - 1, 0, kCorpusStackBands - 1);
+        return pieceBand * kCorpusStackBands + stackBand;
+    }
+
+    const char* corpusBucketName(int bucket) {
+        static const char* const kNames[kCorpusBuckets] = {
+            "1-5 pieces, stack 1", "1-5 pieces, stack 2", "1-5 pieces, stack 3+",
+            "6-9 pieces, stack 1", "6-9 pieces, stack 2", "6-9 pieces, stack 3+",
+            "10-13 pieces, stack 1", "10-13 pieces, stack 2", "10-13 pieces, stack 3+",
+            "14-17 pieces, stack 1", "14-17 pieces, stack 2", "14-17 pieces, stack 3+",
+            "18+ pieces, stack 1", "18+ pieces, stack 2", "18+ pieces, stack 3+",
+        };
+        return bucket >= 0 && bucket < kCorpusBuckets ? kNames[bucket] : "?";
+    }
+
+    std::vector<GameRecord> generateCorpus(const CorpusOptions& o) {
+        std::vector<GameRecord> corpus;
+        if (o.positions <= 0) return corpus;
+        corpus.reserve(o.positions);
+
+        std::mt19937 rng(o.seed);
+        std::unordered_set<std::uint64_t> seen;
+        std::array<int, kCorpusBuckets> filled{};
+        const int quota = (o.positions + kCorpusBuckets - 1) / kCorpusBuckets;
+        // Quotas hold until a run of games adds nothing (the buckets games
+        // still reach are full) or as many games were played as positions
+        // asked for; after that any bucket takes positions. A second such run
+        // (every reachable position already taken) ends it.
+        constexpr int kIdleGames = 50;
+        bool evenly = true;
+        int games = 0, idle = 0;
+        MoveList moves;
+        std::vector<int> weights;
+        while (static_cast<int>(corpus.size()) < o.positions) {
+            if (evenly && (idle == kIdleGames || games == o.positions)) evenly = false, idle = 0;
+            else if (idle == kIdleGames) break;
+            ++games;
+            const std::size_t before = corpus.size();
+            GameState s(o.ruleset);
+            GameRecord g{ o.ruleset, GameOver::None, {} };
+            for (int ply = 0; ply < o.maxPly && evaluateGameOver(s) == GameOver::None; ++ply) {
+                if (ply > 0 && rng() % kSampleOneIn == 0) {
+                    const int b = corpusBucket(s);
+                    if ((!evenly || filled[b] < quota) && seen.insert(canonicalHash(s)).second) {
+                        ++filled[b];
+                        corpus.push_back(g);
+                        if (static_cast<int>(corpus.size()) == o.positions) break;
+                    }
+                }
+                generateMoves(s, moves);
+                if (moves.empty()) moves.push_back(Move::pass());
+                std::size_t pick = rng() % moves.size();
+                if (o.weighted) {
+                    weights.clear();
+                    for (const Move& m : moves) weights.push_back(moveWeight(s, m));
+                    std::discrete_distribution<std::size_t> d(weights.begin(), weights.end());
+                    pick = d(rng);
+                }
+                g.moves.push_back(moves[pick]);
+                s.play(moves[pick]);
+            }
+            idle = corpus.size() == before ? idle + 1 : 0;
+        }
+        return corpus;
+    }
+
+    std::array<int, kCorpusBuckets> corpusHistogram(const std::vector<GameRecord>& corpus) {
+        std::array<int, kCorpusBuckets> counts{};
+        for (const GameRecord& g : corpus) ++counts[corpusBucket(replay(g))];
+        return counts;
+    }
+
+    void writeCorpus(std::ostream& out, const std::vector<GameRecord>& corpus) {
+        const auto counts = corpusHistogram(corpus);
+        out << "# hive position corpus: " << corpus.size() << " positions, one record each\n";
+        for (int b = 0; b < kCorpusBuckets; ++b) {
+            if (counts[b]) out << "#   " << corpusBucketName(b) << ": " << counts[b] << "\n";
+        }
+        for (const GameRecord& g : corpus) out << formatRecord(g) << "\n";
+    }
+
+    GameState replay(const GameRecord& g) {
+        GameState s(g.ruleset);
+        for (const Move& m : g.moves) s.play(m);
+        return s;
+    }
+
+} // namespace hive
@@ -0,0 +1,138 @@
+#include "encode.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+
+namespace hive {
+
+    namespace {
+        constexpr int kHalf = kEncodeWindow / 2;
+
+        // cell index within a plane, or -1 outside the window
+        int cellIndex(Axial a, Axial center) {
+            const int col = a.q - center.q + kHalf, row = a.r - center.r + kHalf;
+            if (col < 0 || col >= kEncodeWindow || row < 0 || row >= kEncodeWindow) return -1;
+            return row * kEncodeWindow + col;
+        }
+
+        // The piece's place in its color's hand: its bug's offset plus its index
+        // among that bug, as nextInHand() hands them out. -1 for setup pieces
+        // beyond the ruleset's hands.
+        int pieceSlot(const GameState& s, int pid) {
+            if (pid >= kColorCount * piecesPerColor(s.ruleset())) return -1;
+            const Piece& p = s.pieces()[pid];
+            const int b = bugIndex(p.bug);
+            const int index = pid - colorIndex(p.color) * piecesPerColor(s.ruleset()) - kHandOffset[b];
+            if (index < 0 || index >= startingHand(s.ruleset())[b]) return -1;
+            return kHandOffset[b] + index;
+        }
+
+        // Splits [0, count) into chunks for the pool; each chunk reports its clipped positions.
+        template <typename EncodeRange>
+        int runChunks(std::size_t count, int threads, const EncodeRange& encodeRange) {
+            if (threads == 1 || count < 2) return encodeRange(std::size_t{ 0 }, count);
+            std::atomic<int> clipped{ 0 };
+            ThreadPool pool(threads);
+            const std::size_t chunks = std::min(count, static_cast<std::size_t>(pool.size()) * 4);
+            for (std::size_t c = 0; c < chunks; ++c) {
+                pool.submit([&, c] {
+                    clipped += encodeRange(count * c / chunks, count * (c + 1) / chunks);
+                });
+            }
+            pool.wait();
+            return clipped.load();
+        }
+    }
+
+    Axial encodeCenter(const GameState& s) {
+        if (s.board().empty()) return { 0, 0 };
+        int minQ = INT_MAX, maxQ = INT_MIN, minR = INT_MAX, maxR = INT_MIN;
+        for (const auto& [pos, stack] : s.board()) {
+            minQ = std::min(minQ, pos.q); maxQ = std::max(maxQ, pos.q);
+            minR = std::min(minR, pos.r); maxR = std::max(maxR, pos.r);
+        }
+        // floor of the midpoint, so negative coordinates round the same way
+        auto mid = [](int lo, int hi) { const int sum = lo + hi; return sum >= 0 ? sum / 2 : -((1 - sum) / 2); };
+        return { mid(minQ, maxQ), mid(minR, maxR) };
+    }
+
+    int moveIndex(const GameState& s, const Move& m) {
+        if (m.isPass()) return -1;
+        const int cell = cellIndex(m.to, encodeCenter(s));
+        const int slot = pieceSlot(s, m.pieceId);
+        if (cell < 0 || slot < 0) return -1;
+        return maskPlane(slot, s.pieces()[m.pieceId].color == s.toMove()) * static_cast<int>(kEncodeCells) + cell;
+    }
+
+    template <typename T>
+    bool encodePosition(const GameState& s, T* planes, T* mask) {
+        const Color us = s.toMove();
+        const Axial center = encodeCenter(s);
+        bool complete = true;
+
+        std::fill(planes, planes + kEncodePlanes * kEncodeCells, T{});
+        for (const auto& [pos, stack] : s.board()) {
+            const int cell = cellIndex(pos, center);
+            if (cell < 0) { complete = false; continue; }
+            for (std::size_t h = 0; h < stack.size(); ++h) {
+                const Piece& p = s.pieces()[stack[h]];
+                planes[piecePlane(p.bug, p.color == us, static_cast<int>(h)) * kEncodeCells + cell] = T{ 1 };
+            }
+        }
+        for (int c = 0; c < kColorCount; ++c) {
+            for (int b = 0; b < kBugCount; ++b) {
+                const int n = s.inHand(static_cast<Color>(c), static_cast<Bug>(b));
+                if (n == 0) continue;
+                T* plane = planes + handPlane(static_cast<Bug>(b), static_cast<Color>(c) == us) * kEncodeCells;
+                std::fill(plane, plane + kEncodeCells, static_cast<T>(n));
+            }
+        }
+
+        if (!mask) return complete;
+        std::fill(mask, mask + kMaskPlanes * kEncodeCells, T{});
+        MoveList moves;
+        generateMoves(s, moves);
+        for (const Move& m : moves) {
+            const int cell = cellIndex(m.to, center);
+            const int slot = pieceSlot(s, m.pieceId);
+            if (cell < 0 || slot < 0) { complete = false; continue; }
+            mask[maskPlane(slot, s.pieces()[m.pieceId].color == us) * kEncodeCells + cell] = T{ 1 };
+        }
+        return complete;
+    }
+
+    template <typename T>
+    int encodeBatch(const GameState* states, std::size_t count, T* planes, T* masks, int threads) {
+        return runChunks(count, threads, [&](std::size_t first, std::size_t last) {
+            int clipped = 0;
+            for (std::size_t i = first; i < last; ++i) {
+                clipped += !encodePosition(states[i], planes + i * kEncodePlanes * kEncodeCells,
+                    masks ? masks + i * kMaskPlanes * kEncodeCells : nullptr);
+            }
+            return clipped;
+        });
+    }
+
+    template <typename T>
+    int encodeBatch(const PositionSnapshot* positions, std::size_t count, T* planes, T* masks, int threads) {
+        return runChunks(count, threads, [&](std::size_t first, std::size_t last) {
+            int clipped = 0;
+            GameState s;
+            for (std::size_t i = first; i < last; ++i) {
+                s.restore(positions[i]);
+                clipped += !encodePosition(s, planes + i * kEncodePlanes * kEncodeCells,
+                    masks ? masks + i * kMaskPlanes * kEncodeCells : nullptr);
+            }
+            return clipped;
+        });
+    }
+
+    template bool encodePosition<float>(const GameState&, float*, float*);
+    template bool encodePosition<std::int8_t>(const GameState&, std::int8_t*, std::int8_t*);
+    template int encodeBatch<float>(const GameState*, std::size_t, float*, float*, int);
+    template int encodeBatch<std::int8_t>(const GameState*, std::size_t, std::int8_t*, std::int8_t*, int);
+    template int encodeBatch<float>(const PositionSnapshot*, std::size_t, float*, float*, int);
+    template int encodeBatch<std::int8_t>(const PositionSnapshot*, std::size_t, std::int8_t*, std::int8_t*, int);
+
+} // namespace hive
@@ -1,38 +1,376 @@
 #include "engine.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
 #include <stdexcept>
 
 namespace hive {
 
-    GameState::GameState() {}
+    namespace {
+        std::uint64_t splitmix64(std::uint64_t x) {
+            x += 0x9e3779b97f4a7c15ULL;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
 
-    int GameState::addDemoPiece(Bug bug, Color color, Axial at, int height) {
-        int id = static_cast<int>(pieces_.size());
-        pieces_.push_back(Piece{ id, bug, color, true, at, height });
+        // Zobrist keys are hashed from the fields rather than tabled: the board is unbounded.
+        std::uint64_t pieceKey(const Piece& p) {
+            return splitmix64((static_cast<std::uint64_t>(colorIndex(p.color)) << 60) ^
+                (static_cast<std::uint64_t>(bugIndex(p.bug)) << 56) ^
+                (static_cast<std::uint64_t>(static_cast<std::uint32_t>(p.pos.q) & 0xFFFFFF) << 32) ^
+                (static_cast<std::uint64_t>(static_cast<std::uint32_t>(p.pos.r) & 0xFFFFFF) << 8) ^
+                static_cast<std::uint64_t>(p.height & 0xFF));
+        }
+
+        constexpr std::uint64_t kBlackToMoveKey = 0x6a09e667f3bcc909ULL;
+    }
+
+    GameState::GameState(Ruleset ruleset) : ruleset_(ruleset) {
+        const auto hand = startingHand(ruleset);
+        pieces_.reserve(kColorCount * piecesPerColor(ruleset));
+        for (int c = 0; c < kColorCount; ++c) {
+            for (int b = 0; b < kBugCount; ++b) {
+                for (int k = 0; k < hand[b]; ++k) {
+                    int id = static_cast<int>(pieces_.size());
+                    pieces_.push_back(Piece{ id, static_cast<Bug>(b), static_cast<Color>(c), false, {}, 0 });
+                }
+                hand_[c][b] = hand[b];
+                handSize_[c][b] = hand[b];
+            }
+        }
+        recordPosition(true);
+    }
+
+    void GameState::toggleStack(const PieceStack& stack) {
+        for (int id : stack) hash_ ^= pieceKey(pieces_[id]);
+    }
+
+    void GameState::CellSet::insert(Axial a) {
+        if (!slot.emplace(a, static_cast<int>(cells.size())).second) return;
+        cells.push_back(a);
+    }
+
+    void GameState::CellSet::erase(Axial a) {
+        auto it = slot.find(a);
+        if (it == slot.end()) return;
+        const int i = it->second;
+        slot.erase(it);
+        if (i + 1 < static_cast<int>(cells.size())) {
+            cells[i] = cells.back();
+            slot[cells[i]] = i;
+        }
+        cells.pop_back();
+    }
+
+    void GameState::refreshPlaceable(Axial a) {
+        auto it = adjacent_.find(a);
+        const bool empty = board_.find(a) == board_.end();
+        for (int c = 0; c < kColorCount; ++c) {
+            const bool ok = empty && it != adjacent_.end() && it->second[c] > 0 && it->second[1 - c] == 0;
+            if (ok) placeable_[c].insert(a);
+            else placeable_[c].erase(a);
+        }
+    }
+
+    void GameState::topChanged(Axial at, int oldTop, int newTop) {
+        if (oldTop >= 0 && newTop >= 0 && pieces_[oldTop].color == pieces_[newTop].color) return;
+        for (int i = 0; i < kHexDirCount; ++i) {
+            const Axial n = add(at, dir(i));
+            auto& counts = adjacent_[n];
+            if (oldTop >= 0) --counts[colorIndex(pieces_[oldTop].color)];
+            if (newTop >= 0) ++counts[colorIndex(pieces_[newTop].color)];
+            if (counts[0] == 0 && counts[1] == 0) adjacent_.erase(n);
+            refreshPlaceable(n);
+        }
+        if (oldTop < 0 || newTop < 0) refreshPlaceable(at); // occupied <-> empty
+    }
+
+    void GameState::recordPosition(bool irreversible) {
+        if (ply_ >= static_cast<int>(positions_.size()) && static_cast<int>(positions_.size()) < kHashHistory) {
+            std::size_t size = std::max<std::size_t>(positions_.size(), 64);
+            while (static_cast<int>(size) <= ply_ && static_cast<int>(size) < kHashHistory) size *= 2;
+            // live slots hold distinct plies, so they stay distinct modulo the larger size
+            std::vector<PositionEntry> grown(size);
+            for (const PositionEntry& old : positions_) {
+                if (old.ply >= 0) grown[old.ply & (size - 1)] = old;
+            }
+            positions_ = std::move(grown);
+        }
+        PositionEntry e;
+        e.hash = hash_;
+        e.ply = ply_;
+        if (!irreversible) {
+            const PositionEntry& prev = positionAt(ply_ - 1);
+            if (prev.ply == ply_ - 1) e.window = static_cast<std::int16_t>(std::min(prev.window + 1, kHashHistory - 1));
+        }
+        // same side to move means an even distance; stop at the first earlier occurrence
+        for (int back = 2; back <= e.window; back += 2) {
+            const PositionEntry& old = positionAt(ply_ - back);
+            if (old.ply != ply_ - back) break;
+            if (old.hash == hash_) { e.reps = static_cast<std::int16_t>(old.reps + 1); break; }
+        }
+        positions_[ply_ & (positions_.size() - 1)] = e;
+    }
+
+    int GameState::nextInHand(Color c, Bug b) const {
+        int left = inHand(c, b);
+        if (left <= 0) return -1;
+        // pieces leave the hand in index order
+        return colorIndex(c) * piecesPerColor(ruleset_) + kHandOffset[bugIndex(b)]
+            + (handSize_[colorIndex(c)][bugIndex(b)] - left);
+    }
+
+    void GameState::limitHand(Color c, Bug b, int count) {
+        int& size = handSize_[colorIndex(c)][bugIndex(b)];
+        if (hand_[colorIndex(c)][bugIndex(b)] != size) throw std::runtime_error("limitHand after placement");
+        size = std::clamp(count, 0, size);
+        hand_[colorIndex(c)][bugIndex(b)] = size;
+    }
+
+    void GameState::setToMove(Color c) {
+        if (c == toMove_) return;
+        toMove_ = c;
+        hash_ ^= kBlackToMoveKey;
+        recordPosition(true);
+    }
+
+    PositionSnapshot GameState::snapshot() const {
+        PositionSnapshot snap;
+        if (pieces_.size() != static_cast<size_t>(kColorCount * piecesPerColor(ruleset_))) throw std::runtime_error("snapshot of a setup position");
+        for (int c = 0; c < kColorCount; ++c) {
+            for (int b = 0; b < kBugCount; ++b) {
+                if (handSize_[c][b] != startingHand(ruleset_)[b]) throw std::runtime_error("snapshot of a reduced hand");
+            }
+        }
+        auto slot = [](Axial a, int height) {
+            if (std::max(std::abs(a.q), std::abs(a.r)) > 127) throw std::runtime_error("snapshot coordinate out of range");
+            return PositionSnapshot::Slot{ static_cast<std::int8_t>(a.q), static_cast<std::int8_t>(a.r), static_cast<std::int8_t>(height) };
+        };
+        for (const Piece& p : pieces_) {
+            if (p.onBoard) snap.pieces[p.id] = slot(p.pos, p.height);
+        }
+        if (!history_.empty()) {
+            const Undo& u = history_.back();
+            snap.hasLast = true;
+            snap.last = u.move;
+            if (!u.move.isPass() && !u.move.isPlacement) snap.lastFrom = slot(u.from, u.fromHeight);
+        }
+        snap.ply = ply_;
+        snap.ruleset = ruleset_;
+        snap.toMove = toMove_;
+        return snap;
+    }
+
+    void GameState::restore(const PositionSnapshot& snap) {
+        const int moveLimit = moveLimit_;
+        *this = GameState(snap.ruleset);
+        moveLimit_ = moveLimit;
+        // bottom pieces first, so every stack is rebuilt in order
+        const int n = static_cast<int>(pieces_.size());
+        for (int h = 0, left = n; left > 0; ++h) {
+            left = 0;
+            for (int id = 0; id < n; ++id) {
+                const auto& slot = snap.pieces[id];
+                left += slot.height > h;
+                if (slot.height != h) continue;
+                const Piece& p = pieces_[id];
+                hand_[colorIndex(p.color)][bugIndex(p.bug)] -= 1;
+                putOnBoard(id, { slot.q, slot.r }, h);
+            }
+        }
+        if (snap.toMove != toMove_) {
+            toMove_ = snap.toMove;
+            hash_ ^= kBlackToMoveKey;
+        }
+        ply_ = snap.ply;
+        recordPosition(true);
+        if (snap.hasLast) history_.push_back({ snap.last, { snap.lastFrom.q, snap.lastFrom.r }, snap.lastFrom.height });
+    }
+
+    void GameState::putOnBoard(int pieceId, Axial at, int height) {
+        Piece& p = pieces_[pieceId];
         auto& stack = board_[at];
         if (height < 0 || height > static_cast<int>(stack.size())) height = static_cast<int>(stack.size());
-        stack.insert(stack.begin() + height, id);
+        const int oldTop = stack.empty() ? -1 : stack.back();
+        toggleStack(stack);
+        stack.insert(stack.begin() + height, pieceId);
+        p.onBoard = true;
+        p.pos = at;
         for (int i = 0; i < (int)stack.size(); ++i) pieces_[stack[i]].height = i;
+        toggleStack(stack);
+        topChanged(at, oldTop, stack.back());
+
+        const int c = colorIndex(p.color);
+        placed_[c] += 1;
+        if (p.bug == Bug::Queen && queenId_[c] < 0) queenId_[c] = pieceId;
+    }
+
+    void GameState::liftOff(int pieceId) {
+        Piece& p = pieces_[pieceId];
+        auto it = board_.find(p.pos);
+        auto& stack = it->second;
+        const int oldTop = stack.back();
+        toggleStack(stack);
+        stack.erase(stack.begin() + p.height);
+        for (int i = 0; i < (int)stack.size(); ++i) pieces_[stack[i]].height = i;
+        toggleStack(stack);
+        const int newTop = stack.empty() ? -1 : stack.back();
+        if (stack.empty()) board_.erase(it);
+        topChanged(p.pos, oldTop, newTop);
+        p.onBoard = false;
+        p.height = 0;
+
+        const int c = colorIndex(p.color);
+        placed_[c] -= 1;
+        if (queenId_[c] == pieceId) queenId_[c] = -1;
+    }
+
+    int GameState::addDemoPiece(Bug bug, Color color, Axial at, int height) {
+        int id = nextInHand(color, bug);
+        if (id >= 0) {
+            hand_[colorIndex(color)][bugIndex(bug)] -= 1;
+        }
+        else {
+            id = static_cast<int>(pieces_.size());
+            pieces_.push_back(Piece{ id, bug, color, false, {}, 0 });
+        }
+        putOnBoard(id, at, height);
+        recordPosition(true);
         return id;
     }
 
+    void GameState::play(const Move& m) {
+        if (m.isPass()) {
+            history_.push_back({ m, {}, 0 });
+            toMove_ = opponent(toMove_);
+            hash_ ^= kBlackToMoveKey;
+            ++ply_;
+            recordPosition(false);
+            return;
+        }
+        // validated before anything changes, so a throw leaves the state as it was
+        if (m.pieceId >= (int)pieces_.size()) throw std::runtime_error("bad pieceId");
+        const Piece& p = pieces_[m.pieceId];
+        if (m.isPlacement && (p.onBoard || nextInHand(p.color, p.bug) != m.pieceId)) throw std::runtime_error("piece not next in hand");
+        if (!m.isPlacement && !p.onBoard) throw std::runtime_error("piece not on board");
+        history_.push_back({ m, p.pos, p.height });
+        if (m.isPlacement) {
+            hand_[colorIndex(p.color)][bugIndex(p.bug)] -= 1;
+            putOnBoard(m.pieceId, m.to, -1);
+        }
+        else {
+            relocate(m.pieceId, m.to, /*allowStack=*/true);
+        }
+        toMove_ = opponent(toMove_);
+        hash_ ^= kBlackToMoveKey;
+        ++ply_;
+        recordPosition(m.isPlacement);
+    }
+
+    void GameState::undo() {
+        if (history_.empty()) throw std::runtime_error("nothing to undo");
+        const Undo u = history_.back();
+        history_.pop_back();
+        // the ring slot for the restored ply is still there; hash_ unwinds with the board
+        toMove_ = opponent(toMove_);
+        hash_ ^= kBlackToMoveKey;
+        --ply_;
+        if (u.move.isPass()) return;
+
+        const Piece& p = pieces_[u.move.pieceId];
+        if (u.move.isPlacement) {
+            liftOff(u.move.pieceId);
+            hand_[colorIndex(p.color)][bugIndex(p.bug)] += 1;
+            return;
+        }
+        // back to its old cell at its old height
+        liftOff(u.move.pieceId);
+        putOnBoard(u.move.pieceId, u.from, u.fromHeight);
+    }
+
     void GameState::movePiece(int pieceId, Axial to, bool allowStack) {
+        relocate(pieceId, to, allowStack);
+        recordPosition(true);
+    }
+
+    void GameState::relocate(int pieceId, Axial to, bool allowStack) {
         if (pieceId < 0 || pieceId >= (int)pieces_.size()) throw std::runtime_error("bad pieceId");
         Piece& p = pieces_[pieceId];
         if (!p.onBoard) throw std::runtime_error("piece not on board");
 
-        auto itOld = board_.find(p.pos);
+        const Axial from = p.pos;
+        auto itOld = board_.find(from);
         auto& oldStack = itOld->second;
+        const int oldFromTop = oldStack.back();
+        toggleStack(oldStack);
         oldStack.erase(oldStack.begin() + p.height);
         for (int i = 0; i < (int)oldStack.size(); ++i) pieces_[oldStack[i]].height = i;
+        toggleStack(oldStack);
+        const int newFromTop = oldStack.empty() ? -1 : oldStack.back();
         if (oldStack.empty()) board_.erase(itOld);
+        topChanged(from, oldFromTop, newFromTop);
 
         auto& newStack = board_[to];
+        const int oldToTop = newStack.empty() ? -1 : newStack.back();
         int newH = allowStack ? (int)newStack.size() : 0;
+        toggleStack(newStack);
         newStack.insert(newStack.begin() + newH, pieceId);
+        p.pos = to;
         for (int i = 0; i < (int)newStack.size(); ++i) pieces_[newStack[i]].height = i;
+        toggleStack(newStack);
+        topChanged(to, oldToTop, newStack.back());
+    }
 
-        p.pos = to;
-        p.height = newH;
+    std::string pieceName(const GameState& s, int pieceId) {
+        const Piece& p = s.pieces()[pieceId];
+        std::string name;
+        name += p.color == Color::White ? 'w' : 'b';
+        name += bugChar(p.bug);
+        if (startingHand(s.ruleset())[bugIndex(p.bug)] > 1) {
+            // 1-based index among pieces of the same color and bug
+            int index = 1;
+            for (int i = 0; i < pieceId; ++i) {
+                const Piece& o = s.pieces()[i];
+                if (o.color == p.color && o.bug == p.bug) ++index;
+            }
+            name += std::to_string(index);
+        }
+        return name;
+    }
+
+    std::string moveToString(const GameState& s, const Move& m) {
+        if (m.isPass()) return "pass";
+        return pieceName(s, m.pieceId) + "@" + std::to_string(m.to.q) + "," + std::to_string(m.to.r);
+    }
+
+    std::optional<Move> parseMove(const GameState& s, std::string_view text) {
+        if (text == "pass") return Move::pass();
+        const auto at = text.find('@');
+        const auto comma = text.find(',', at);
+        if (at == std::string_view::npos || comma == std::string_view::npos || at < 2) return std::nullopt;
+
+        auto toInt = [](std::string_view t, int& out) {
+            auto [end, ec] = std::from_chars(t.data(), t.data() + t.size(), out);
+            return ec == std::errc() && end == t.data() + t.size();
+        };
+
+        // piece: color, bug letter, optional 1-based index
+        if (text[0] != 'w' && text[0] != 'b') return std::nullopt;
+        const Color color = text[0] == 'w' ? Color::White : Color::Black;
+        int bug = -1;
+        for (int b = 0; b < kBugCount; ++b) if (bugChar(static_cast<Bug>(b)) == text[1]) bug = b;
+        if (bug < 0) return std::nullopt;
+        const int count = startingHand(s.ruleset())[bug];
+        int index = 1;
+        if (at > 2 && !toInt(text.substr(2, at - 2), index)) return std::nullopt;
+        if (index < 1 || index > count) return std::nullopt;
+
+        Axial to;
+        if (!toInt(text.substr(at + 1, comma - at - 1), to.q) || !toInt(text.substr(comma + 1), to.r)) return std::nullopt;
+
+        const int id = colorIndex(color) * piecesPerColor(s.ruleset()) + kHandOffset[bug] + index - 1;
+        return Move{ id, to, !s.pieces()[id].onBoard };
     }
 
     Pixel axialToPixel(Axial a, float s) {
@@ -0,0 +1,124 @@
+#include "game_record.hpp"
+#include <algorithm>
+#include <istream>
+
+namespace hive {
+
+    namespace {
+        const char* resultText(GameOver r) {
+            switch (r) {
+            case GameOver::WhiteWins: return "1-0";
+            case GameOver::BlackWins: return "0-1";
+            case GameOver::Draw: return "1/2";
+            case GameOver::None: break;
+            }
+            return "*";
+        }
+
+        std::optional<GameOver> resultFromText(std::string_view t) {
+            if (t == "1-0") return GameOver::WhiteWins;
+            if (t == "0-1") return GameOver::BlackWins;
+            if (t == "1/2") return GameOver::Draw;
+            if (t == "*") return GameOver::None;
+            return std::nullopt;
+        }
+
+        // next whitespace-separated token, advancing pos
+        std::string_view nextToken(std::string_view line, size_t& pos) {
+            while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r')) ++pos;
+            const size_t start = pos;
+            while (pos < line.size() && line[pos] != ' ' && line[pos] != '\t' && line[pos] != '\r') ++pos;
+            return line.substr(start, pos - start);
+        }
+    }
+
+    std::string formatRecord(const GameRecord& g) {
+        std::string out = g.ruleset == Ruleset::MLP ? "mlp " : "base ";
+        out += resultText(g.result);
+        GameState s(g.ruleset);
+        for (const Move& m : g.moves) {
+            out += ' ';
+            out += moveToString(s, m);
+            s.play(m);
+        }
+        return out;
+    }
+
+    std::optional<GameRecord> parseRecord(std::string_view line) {
+        size_t pos = 0;
+        GameRecord g;
+        const std::string_view rules = nextToken(line, pos);
+        if (rules == "base") g.ruleset = Ruleset::Base;
+        else if (rules == "mlp") g.ruleset = Ruleset::MLP;
+        else return std::nullopt;
+
+        const auto result = resultFromText(nextToken(line, pos));
+        if (!result) return std::nullopt;
+        g.result = *result;
+
+        GameState s(g.ruleset);
+        MoveList legal;
+        for (std::string_view tok = nextToken(line, pos); !tok.empty(); tok = nextToken(line, pos)) {
+            const auto m = parseMove(s, tok);
+            if (!m || evaluateGameOver(s) != GameOver::None) return std::nullopt;
+            // only legal moves, as hive_server accepts them: a pass only when nothing else is
+            generateMoves(s, legal);
+            if (legal.empty() ? !m->isPass() : std::find(legal.begin(), legal.end(), *m) == legal.end()) return std::nullopt;
+            s.play(*m);
+            g.moves.push_back(*m);
+        }
+        return g;
+    }
+
+    std::vector<GameRecord> readRecords(std::istream& in, int* rejected) {
+        std::vector<GameRecord> out;
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t pos = 0;
+            const std::string_view first = nextToken(line, pos);
+            if (first.empty() || first[0] == '#') continue;
+            if (auto g = parseRecord(line)) out.push_back(std::move(*g));
+            else if (rejected) ++*rejected;
+        }
+        return out;
+    }
+
+    bool RecordArchive::open(const std::string& path) {
+        in_ = std::ifstream(path, std::ios::binary);
+        offsets_.clear();
+        scanned_ = 0;
+        complete_ = !in_;
+        return static_cast<bool>(in_);
+    }
+
+    bool RecordArchive::indexNext() {
+        if (complete_) return false;
+        in_.clear();
+        in_.seekg(scanned_);
+        std::string line;
+        while (true) {
+            const std::streamoff at = in_.tellg();
+            if (!std::getline(in_, line)) break;
+            scanned_ = in_.eof() ? at + static_cast<std::streamoff>(line.size()) : static_cast<std::streamoff>(in_.tellg());
+            size_t pos = 0;
+            const std::string_view first = nextToken(line, pos);
+            if (first.empty() || first[0] == '#' || !parseRecord(line)) continue;
+            offsets_.push_back(at);
+            return true;
+        }
+        complete_ = true;
+        return false;
+    }
+
+    std::optional<GameRecord> RecordArchive::get(std::size_t index) {
+        while (offsets_.size() <= index) {
+            if (!indexNext()) return std::nullopt;
+        }
+        in_.clear();
+        in_.seekg(offsets_[index]);
+        std::string line;
+        if (!std::getline(in_, line)) return std::nullopt;
+        return parseRecord(line);
+    }
+
+} // namespace hive
@@ -0,0 +1,91 @@
+#include "player.hpp"
+#include <algorithm>
+
+namespace hive {
+
+    EnginePlayer::EnginePlayer(std::shared_ptr<TranspositionTable> table) {
+        if (table) searcher_.setTable(std::move(table));
+    }
+
+    EnginePlayer::~EnginePlayer() { stopPonder(); }
+
+    void EnginePlayer::setBook(std::shared_ptr<const OpeningBook> book, std::uint32_t minVisits) {
+        book_ = std::move(book);
+        bookMinVisits_ = minVisits;
+    }
+
+    EnginePlayer::Decision EnginePlayer::finish(const SearchResult& r, Source source) const {
+        Decision d;
+        d.move = r.best;
+        d.source = source;
+        d.score = r.score;
+        d.depth = r.depth;
+        d.nodes = r.nodes;
+        if (r.pv.size() > 1 && r.pv.front() == r.best) {
+            d.ponder = r.pv[1];
+            d.hasPonder = true;
+        }
+        return d;
+    }
+
+    EnginePlayer::Decision EnginePlayer::go(const GameState& s, const TimeControl& clock, const InfoCallback& onInfo) {
+        if (pondering()) {
+            if (s.hash() == ponderHash_ && s.ply() == ponderPly_) {
+                searcher_.ponderHit(clock);
+                ponderThread_.join();
+                return finish(ponderResult_, Source::PonderHit);
+            }
+            stopPonder();
+        }
+
+        if (book_ && book_->ruleset() == s.ruleset()) {
+            if (auto m = book_->pick(s, bookMinVisits_)) {
+                Decision d;
+                d.move = *m;
+                d.source = Source::Book;
+                return d;
+            }
+        }
+        const auto moves = generateMoves(s);
+        if (moves.size() <= 1) {
+            Decision d;
+            d.move = moves.empty() ? Move::pass() : moves.front();
+            d.source = Source::Forced;
+            return d;
+        }
+
+        SearchLimits limits;
+        limits.maxDepth = maxDepth_;
+        limits.clock = clock;
+        return finish(searcher_.search(s, limits, onInfo), Source::Search);
+    }
+
+    bool EnginePlayer::startPonder(const GameState& s, const Move& expected, const InfoCallback& onInfo) {
+        stopPonder();
+        auto moves = generateMoves(s);
+        if (moves.empty()) moves.push_back(Move::pass());
+        if (std::find(moves.begin(), moves.end(), expected) == moves.end()) return false;
+
+        GameState next = s;
+        next.play(expected);
+        if (evaluateGameOver(next) != GameOver::None) return false;
+        ponderHash_ = next.hash();
+        ponderPly_ = next.ply();
+
+        SearchLimits limits;
+        limits.maxDepth = maxDepth_;
+        limits.ponder = true;
+        ponderThread_ = std::thread([this, next = std::move(next), limits, onInfo] {
+            ponderResult_ = searcher_.search(next, limits, onInfo);
+        });
+        return true;
+    }
+
+    void EnginePlayer::stopPonder() {
+        if (!ponderThread_.joinable()) return;
+        searcher_.stop();
+        ponderThread_.join();
+        searcher_.clearStop();
+    }
+
+} // namespace hive
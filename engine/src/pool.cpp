@@ -0,0 +1,108 @@
+#include "pool.hpp"
+#include <atomic>
+#include <mutex>
+#include <new>
+
+namespace hive::pool {
+
+    namespace {
+
+        constexpr std::size_t kGranule = 16;
+        constexpr std::size_t kClasses = kMaxBlock / kGranule;
+        constexpr std::size_t kChunkBytes = 64 * 1024;
+
+        struct FreeBlock { FreeBlock* next; };
+
+        std::atomic<bool> gEnabled{ true };
+        std::atomic<std::size_t> gReserved{ 0 };
+
+        // Free lists handed back by finished threads, one per size class.
+        struct Depot {
+            std::mutex mutex;
+            FreeBlock* lists[kClasses]{};
+        };
+        Depot& depot() {
+            static Depot d;
+            return d;
+        }
+
+        // Trivially destructible, so still usable while the thread's other
+        // thread_locals are being torn down.
+        thread_local FreeBlock* tlsFree[kClasses]{};
+
+        // Gives this thread's blocks to the depot when the thread exits. Only
+        // constructed once named, so both refill() and a free into an empty
+        // list name it: a thread that only frees must hand its lists back too.
+        struct ThreadReturn {
+            ~ThreadReturn() {
+                Depot& d = depot();
+                std::lock_guard<std::mutex> lock(d.mutex);
+                for (std::size_t c = 0; c < kClasses; ++c) {
+                    FreeBlock* head = tlsFree[c];
+                    if (!head) continue;
+                    FreeBlock* tail = head;
+                    while (tail->next) tail = tail->next;
+                    tail->next = d.lists[c];
+                    d.lists[c] = head;
+                    tlsFree[c] = nullptr;
+                }
+            }
+        };
+        thread_local ThreadReturn tlsReturn;
+
+        std::size_t classOf(std::size_t bytes) { return (bytes - 1) / kGranule; }
+
+        void armReturn() { (void)&tlsReturn; }
+
+        // Slow path: the depot's list for this class, else a fresh chunk.
+        FreeBlock* refill(std::size_t c) {
+            armReturn();
+            {
+                Depot& d = depot();
+                std::lock_guard<std::mutex> lock(d.mutex);
+                if (FreeBlock* head = d.lists[c]) {
+                    d.lists[c] = nullptr;
+                    return head;
+                }
+            }
+            const std::size_t block = (c + 1) * kGranule;
+            char* chunk = static_cast<char*>(::operator new(kChunkBytes));
+            gReserved.fetch_add(kChunkBytes, std::memory_order_relaxed);
+            FreeBlock* head = nullptr;
+            for (std::size_t off = kChunkBytes / block * block; off >= block; off -= block) {
+                auto* b = reinterpret_cast<FreeBlock*>(chunk + off - block);
+                b->next = head;
+                head = b;
+            }
+            return head;
+        }
+
+    }
+
+    void* allocate(std::size_t bytes) {
+        if (bytes == 0 || bytes > kMaxBlock || !gEnabled.load(std::memory_order_relaxed)) return ::operator new(bytes);
+        const std::size_t c = classOf(bytes);
+        FreeBlock* b = tlsFree[c];
+        if (!b) b = refill(c);
+        tlsFree[c] = b->next;
+        return b;
+    }
+
+    void deallocate(void* p, std::size_t bytes) noexcept {
+        if (!p) return;
+        if (bytes == 0 || bytes > kMaxBlock || !gEnabled.load(std::memory_order_relaxed)) {
+            ::operator delete(p);
+            return;
+        }
+        auto* b = static_cast<FreeBlock*>(p);
+        const std::size_t c = classOf(bytes);
+        if (!tlsFree[c]) armReturn();
+        b->next = tlsFree[c];
+        tlsFree[c] = b;
+    }
+
+    void setEnabled(bool on) { gEnabled.store(on, std::memory_order_relaxed); }
+    bool enabled() { return gEnabled.load(std::memory_order_relaxed); }
+    std::size_t reservedBytes() { return gReserved.load(std::memory_order_relaxed); }
+
+} // namespace hive::pool
@@ -0,0 +1,202 @@
+#include "profile.hpp"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hive::profile {
+
+    const char* zoneName(Zone z) {
+        static constexpr const char* kNames[kZoneCount] = {
+            "generateMoves", "placement", "pinned", "connectivity",
+            "queen", "beetle", "spider", "grasshopper", "ant", "mosquito", "ladybug", "pillbug",
+            "throws", "gameOver",
+        };
+        return kNames[static_cast<int>(z)];
+    }
+
+    const char* counterName(Counter c) {
+        static constexpr const char* kNames[kCounterCount] = {
+            "moves generated", "placement cells",
+            "conn: stack top", "conn: ring", "conn: bounded", "conn: full bfs",
+        };
+        return kNames[static_cast<int>(c)];
+    }
+
+    Snapshot operator-(const Snapshot& later, const Snapshot& earlier) {
+        Snapshot d = later;
+        for (int i = 0; i < kZoneCount; ++i) {
+            d.zones[i].calls -= earlier.zones[i].calls;
+            d.zones[i].ns -= earlier.zones[i].ns;
+        }
+        for (int i = 0; i < kCounterCount; ++i) d.counters[i] -= earlier.counters[i];
+        return d;
+    }
+
+    void printSummary(std::FILE* out, const Snapshot& s) {
+        if (!kEnabled) {
+            std::fprintf(out, "profile: not compiled in (configure with -DHIVE_PROFILE=ON)\n");
+            return;
+        }
+        int order[kZoneCount];
+        for (int i = 0; i < kZoneCount; ++i) order[i] = i;
+        std::sort(order, order + kZoneCount, [&](int a, int b) { return s.zones[a].ns > s.zones[b].ns; });
+
+        std::fprintf(out, "%-16s %12s %12s %10s\n", "zone (inclusive)", "calls", "ms", "ns/call");
+        for (int i : order) {
+            const ZoneStats& z = s.zones[i];
+            if (z.calls == 0) continue;
+            std::fprintf(out, "%-16s %12llu %12.2f %10.0f\n", zoneName(static_cast<Zone>(i)),
+                static_cast<unsigned long long>(z.calls), z.ns / 1e6, double(z.ns) / z.calls);
+        }
+        for (int i = 0; i < kCounterCount; ++i) {
+            std::fprintf(out, "%-16s %12llu\n", counterName(static_cast<Counter>(i)),
+                static_cast<unsigned long long>(s.counters[i]));
+        }
+    }
+
+#ifdef HIVE_PROFILE
+
+    namespace {
+
+        struct Event {
+            Zone zone;
+            std::int64_t startNs; // since the trace epoch
+            std::int64_t durNs;
+        };
+
+        // Written only by its own thread; relaxed load/store keeps cross-thread
+        // reads well-defined without a locked add on the hot path.
+        struct ThreadBlock {
+            int tid{};
+            std::atomic<std::uint64_t> calls[kZoneCount]{};
+            std::atomic<std::uint64_t> ns[kZoneCount]{};
+            std::atomic<std::uint64_t> counters[kCounterCount]{};
+            std::vector<Event> events;
+            std::uint64_t dropped{};
+        };
+
+        void bump(std::atomic<std::uint64_t>& a, std::uint64_t n) {
+            a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        // Blocks outlive their threads so a finished worker still shows up in the totals.
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadBlock>> blocks;
+            std::atomic<bool> tracing{ false };
+            std::atomic<std::size_t> maxEvents{ std::size_t{ 1 } << 20 };
+            detail::Clock::time_point epoch{ detail::Clock::now() };
+        };
+
+        Registry& registry() {
+            static Registry r;
+            return r;
+        }
+
+        ThreadBlock& threadBlock() {
+            thread_local ThreadBlock* block = nullptr;
+            if (!block) {
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.blocks.push_back(std::make_unique<ThreadBlock>());
+                block = r.blocks.back().get();
+                block->tid = static_cast<int>(r.blocks.size());
+            }
+            return *block;
+        }
+
+    }
+
+    namespace detail {
+
+        void count(Counter c, std::uint64_t n) {
+            bump(threadBlock().counters[static_cast<int>(c)], n);
+        }
+
+        void record(Zone z, Clock::time_point t0, Clock::time_point t1) {
+            ThreadBlock& b = threadBlock();
+            const auto dur = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+            bump(b.calls[static_cast<int>(z)], 1);
+            bump(b.ns[static_cast<int>(z)], static_cast<std::uint64_t>(dur));
+            Registry& r = registry();
+            if (!r.tracing.load(std::memory_order_relaxed)) return;
+            if (b.events.size() >= r.maxEvents.load(std::memory_order_relaxed)) { ++b.dropped; return; }
+            const auto start = std::chrono::duration_cast<std::chrono::nanoseconds>(t0 - r.epoch).count();
+            b.events.push_back({ z, start, dur });
+        }
+
+    }
+
+    Snapshot snapshot() {
+        Snapshot s;
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (const auto& b : r.blocks) {
+            for (int i = 0; i < kZoneCount; ++i) {
+                s.zones[i].calls += b->calls[i].load(std::memory_order_relaxed);
+                s.zones[i].ns += b->ns[i].load(std::memory_order_relaxed);
+            }
+            for (int i = 0; i < kCounterCount; ++i) s.counters[i] += b->counters[i].load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+    void reset() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (const auto& b : r.blocks) {
+            for (auto& a : b->calls) a.store(0, std::memory_order_relaxed);
+            for (auto& a : b->ns) a.store(0, std::memory_order_relaxed);
+            for (auto& a : b->counters) a.store(0, std::memory_order_relaxed);
+            b->events.clear();
+            b->dropped = 0;
+        }
+        r.epoch = detail::Clock::now();
+    }
+
+    void setTracing(bool on, std::size_t maxEventsPerThread) {
+        Registry& r = registry();
+        r.maxEvents.store(maxEventsPerThread, std::memory_order_relaxed);
+        r.tracing.store(on, std::memory_order_relaxed);
+    }
+
+    bool writeChromeTrace(const std::string& path) {
+        std::ofstream out(path);
+        if (!out) return false;
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        char buf[160];
+        for (const auto& b : r.blocks) {
+            for (const Event& e : b->events) {
+                // complete events ("X"); timestamps are microseconds
+                std::snprintf(buf, sizeof buf, "%s\n{\"name\":\"%s\",\"cat\":\"hive\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    first ? "" : ",", zoneName(e.zone), b->tid, e.startNs / 1e3, e.durNs / 1e3);
+                out << buf;
+                first = false;
+            }
+            if (b->dropped) {
+                std::snprintf(buf, sizeof buf, "%s\n{\"name\":\"dropped %llu events\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":0}",
+                    first ? "" : ",", static_cast<unsigned long long>(b->dropped), b->tid);
+                out << buf;
+                first = false;
+            }
+        }
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+
+#else
+
+    Snapshot snapshot() { return {}; }
+    void reset() {}
+    void setTracing(bool, std::size_t) {}
+    bool writeChromeTrace(const std::string&) { return false; }
+
+#endif
+
+} // namespace hive::profile
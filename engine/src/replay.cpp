@@ -0,0 +1,53 @@
+#include "replay.hpp"
+#include <algorithm>
+
+namespace hive {
+
+    GameReplay::GameReplay(GameRecord record, int every) : record_(std::move(record)), every_(std::max(1, every)) {
+        GameState s(record_.ruleset);
+        keyframes_.reserve(record_.moves.size() / every_ + 1);
+        for (int ply = 0;; ++ply) {
+            if (ply % every_ == 0) keyframes_.push_back(s.snapshot());
+            if (ply == length()) break;
+            s.play(record_.moves[ply]);
+        }
+    }
+
+    void GameReplay::seek(GameState& s, int ply) const {
+        ply = std::clamp(ply, 0, length());
+        // moving forward from the current ply is cheaper while it is within reach
+        const int from = s.ply();
+        if (from > ply || ply - from >= every_ || s.ruleset() != record_.ruleset) restoreAt(s, ply);
+        else while (s.ply() < ply) s.play(record_.moves[s.ply()]);
+    }
+
+    void GameReplay::restoreAt(GameState& s, int ply) const {
+        // a snapshot carries no repetition history, and the repetition window
+        // starts at the last placement: replay from a keyframe at or before it
+        int since = ply;
+        while (since > 0 && !record_.moves[since - 1].isPlacement) --since;
+        s.restore(keyframes_[since / every_]);
+        while (s.ply() < ply) s.play(record_.moves[s.ply()]);
+    }
+
+    bool GameReplay::forward(GameState& s) const {
+        if (s.ply() >= length()) return false;
+        s.play(record_.moves[s.ply()]);
+        return true;
+    }
+
+    bool GameReplay::back(GameState& s) const {
+        if (s.ply() <= 0) return false;
+        if (s.lastMove()) {
+            s.undo();
+            // the rules need the move before, which a restored state may not have
+            if (s.lastMove() || s.ply() == 0) return true;
+            restoreAt(s, s.ply());
+        }
+        else {
+            restoreAt(s, s.ply() - 1);
+        }
+        return true;
+    }
+
+} // namespace hive
@@ -0,0 +1,463 @@
+#include "retro.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HIVE_RETRO_MMAP 1
+#endif
+
+namespace hive {
+
+    namespace {
+        constexpr char kMagic[8] = { 'H', 'I', 'V', 'E', 'R', 'E', 'T', 'R' };
+        constexpr std::uint32_t kVersion = 1;
+
+        struct FileHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t bucketBits;
+            std::uint64_t count;
+            std::int32_t hand[kColorCount][kBaseBugCount];
+        };
+        static_assert(sizeof(FileHeader) == 64, "retro tables start with a raw 64-byte header");
+
+        // results: value in the top two bits, distance below
+        constexpr std::uint16_t kDistanceMask = 0x3fff;
+        std::uint16_t encode(RetroValue v, int distance) {
+            return static_cast<std::uint16_t>(static_cast<unsigned>(v) << 14 | std::min(distance, int{ kDistanceMask }));
+        }
+
+        std::size_t bucketsBytes(int bits) { return ((std::size_t{ 1 } << bits) + 1) * sizeof(std::uint32_t); }
+        std::size_t align8(std::size_t n) { return (n + 7) & ~std::size_t{ 7 }; }
+
+        // One board piece of a stored position. Positions are kept as a fixed
+        // number of these (one slot per variant piece, unused slots marked),
+        // bottom of each stack first and translated so min q and min r are 0.
+        struct Cell {
+            std::int8_t q, r;
+            std::uint8_t height;
+            std::uint8_t piece; // color << 4 | bug, or kNoPiece
+        };
+        constexpr std::uint8_t kNoPiece = 0xff;
+
+        void pack(const GameState& s, Cell* out, int stride) {
+            int n = 0, minQ = 0, minR = 0;
+            for (const auto& [pos, stack] : s.board()) {
+                if (n == 0 || pos.q < minQ) minQ = pos.q;
+                if (n == 0 || pos.r < minR) minR = pos.r;
+                n += static_cast<int>(stack.size());
+            }
+            n = 0;
+            for (const auto& [pos, stack] : s.board()) {
+                for (int id : stack) {
+                    const Piece& p = s.pieces()[id];
+                    out[n++] = { static_cast<std::int8_t>(pos.q - minQ), static_cast<std::int8_t>(pos.r - minR),
+                        static_cast<std::uint8_t>(p.height), static_cast<std::uint8_t>(colorIndex(p.color) << 4 | bugIndex(p.bug)) };
+                }
+            }
+            std::sort(out, out + n, [](const Cell& a, const Cell& b) { return a.height < b.height; });
+            for (int i = n; i < stride; ++i) out[i] = { 0, 0, 0, kNoPiece };
+        }
+
+        // start is variantStart(v): copying it is cheaper than constructing a state
+        GameState unpack(const GameState& start, const Cell* in, int stride, Color toMove) {
+            GameState s = start;
+            for (int i = 0; i < stride && in[i].piece != kNoPiece; ++i) {
+                s.addDemoPiece(static_cast<Bug>(in[i].piece & 0xf), static_cast<Color>(in[i].piece >> 4), { in[i].q, in[i].r });
+            }
+            s.setToMove(toMove);
+            return s;
+        }
+
+        bool isTerminal(const GameState& s) {
+            return queenSurrounded(s, Color::White) || queenSurrounded(s, Color::Black);
+        }
+
+        // Value of a finished position for its side to move.
+        RetroValue terminalValue(const GameState& s) {
+            const bool own = queenSurrounded(s, s.toMove());
+            const bool other = queenSurrounded(s, opponent(s.toMove()));
+            return own == other ? RetroValue::Draw : own ? RetroValue::Loss : RetroValue::Win;
+        }
+
+        // fn(begin, end, worker) over [0, n) in one contiguous slice per thread
+        template <typename Fn>
+        void parallelFor(std::size_t n, int threads, const Fn& fn) {
+            const std::size_t workers = std::min<std::size_t>(threads, (n + 63) / 64);
+            if (workers <= 1) {
+                if (n) fn(std::size_t{ 0 }, n, 0);
+                return;
+            }
+            std::vector<std::thread> pool;
+            const std::size_t chunk = (n + workers - 1) / workers;
+            for (std::size_t w = 0; w < workers; ++w) {
+                const std::size_t begin = w * chunk, end = std::min(n, begin + chunk);
+                if (begin < end) pool.emplace_back([&, begin, end, w] { fn(begin, end, static_cast<int>(w)); });
+            }
+            for (auto& t : pool) t.join();
+        }
+
+        // A piece of s in token form, for rebuilding s with one piece changed.
+        struct Token { Bug bug; Color color; Axial at; int height; };
+
+        GameState rebuild(const GameState& start, std::vector<Token> tokens, Color toMove) {
+            std::stable_sort(tokens.begin(), tokens.end(), [](const Token& a, const Token& b) { return a.height < b.height; });
+            GameState s = start;
+            for (const Token& t : tokens) s.addDemoPiece(t.bug, t.color, t.at);
+            s.setToMove(toMove);
+            return s;
+        }
+
+        // the side to move may put bug on at (it is in hand)
+        bool canPlace(const GameState& s, Bug bug, Axial at) {
+            const Color us = s.toMove();
+            if (bug != Bug::Queen && !s.queenPlaced(us) && s.placementsMade(us) >= 3) return false;
+            const auto cells = placementTargets(s, us);
+            return std::find(cells.begin(), cells.end(), at) != cells.end();
+        }
+
+    }
+
+    std::optional<RetroVariant> RetroVariant::parse(std::string_view text) {
+        RetroVariant v;
+        const auto slash = text.find('/');
+        const std::string_view sides[kColorCount] = { text.substr(0, slash), slash == std::string_view::npos ? text.substr(0, slash) : text.substr(slash + 1) };
+        for (int c = 0; c < kColorCount; ++c) {
+            for (char ch : sides[c]) {
+                int bug = -1;
+                for (int b = 0; b < kBaseBugCount; ++b) if (bugChar(static_cast<Bug>(b)) == ch) bug = b;
+                if (bug < 0 || ++v.hand[c][bug] > startingHand(Ruleset::Base)[bug]) return std::nullopt;
+            }
+            if (v.hand[c][bugIndex(Bug::Queen)] != 1) return std::nullopt;
+        }
+        return v;
+    }
+
+    std::string RetroVariant::name() const {
+        std::string side[kColorCount];
+        for (int c = 0; c < kColorCount; ++c) {
+            for (int b = 0; b < kBaseBugCount; ++b) side[c].append(hand[c][b], bugChar(static_cast<Bug>(b)));
+        }
+        return side[0] == side[1] ? side[0] : side[0] + "/" + side[1];
+    }
+
+    int RetroVariant::pieces() const {
+        int n = 0;
+        for (const auto& h : hand) n += std::accumulate(h.begin(), h.end(), 0);
+        return n;
+    }
+
+    GameState variantStart(const RetroVariant& v) {
+        GameState s(Ruleset::Base);
+        for (int c = 0; c < kColorCount; ++c) {
+            for (int b = 0; b < kBaseBugCount; ++b) s.limitHand(static_cast<Color>(c), static_cast<Bug>(b), v.hand[c][b]);
+        }
+        return s;
+    }
+
+    // Base moves reverse: a piece can go back where it came from, through the
+    // same gates and over the same hive (which never included it). So the
+    // origins of a move to X are exactly the piece's own destinations from X.
+    void forEachPredecessor(const RetroVariant& v, const GameState& s, const std::function<void(const GameState&)>& fn) {
+        const Color mover = opponent(s.toMove());
+        const GameState start = variantStart(v);
+        std::vector<Token> tokens;
+        for (const auto& [pos, stack] : s.board()) {
+            for (int id : stack) {
+                const Piece& p = s.pieces()[id];
+                tokens.push_back({ p.bug, p.color, pos, p.height });
+            }
+        }
+
+        // a forced pass leaves the board as it was
+        if (!isTerminal(s)) {
+            GameState p = s;
+            p.setToMove(mover);
+            if (generateMoves(p).empty()) fn(p);
+        }
+
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            const Token t = tokens[i];
+            if (t.color != mover || t.height != stackHeight(s, t.at)) continue; // only a top piece moved last
+
+            // a placement, taken back into the hand
+            if (t.height == 0) {
+                std::vector<Token> fewer = tokens;
+                fewer.erase(fewer.begin() + static_cast<std::ptrdiff_t>(i));
+                GameState p = rebuild(start, fewer, mover);
+                if (!isTerminal(p) && canPlace(p, t.bug, t.at)) fn(p);
+            }
+
+            // a move from any cell the piece could move back to; the mover's
+            // queen must have been down, and the position not already over
+            if (!s.queenPlaced(mover)) continue;
+            const int pid = s.board().at(t.at).back();
+            for (const LegalMove& m : legalMovesForPiece(s, pid)) {
+                GameState p = s;
+                p.movePiece(pid, m.to);
+                p.setToMove(mover);
+                if (!isTerminal(p)) fn(p);
+            }
+        }
+    }
+
+    std::optional<RetroStats> buildRetroTable(const RetroVariant& v, const std::string& path, int threads) {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int c = 0; c < kColorCount; ++c) {
+            if (v.hand[c][bugIndex(Bug::Queen)] != 1) return std::nullopt;
+        }
+        if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        const int stride = v.pieces();
+        const GameState start = variantStart(v);
+
+        // ---- forward enumeration: breadth first, so each level is an index range
+        std::vector<Cell> cells;
+        std::vector<Color> sides;
+        std::vector<std::uint64_t> keys;
+        std::unordered_map<std::uint64_t, std::uint32_t> index;
+        std::vector<std::uint32_t> succ;            // distinct successor positions
+        std::vector<std::uint8_t> terminal;          // RetroValue + 1 of a finished position, else 0
+
+        auto add = [&](std::uint64_t key, const Cell* c, Color side) {
+            if (!index.try_emplace(key, static_cast<std::uint32_t>(keys.size())).second) return;
+            keys.push_back(key);
+            cells.insert(cells.end(), c, c + stride);
+            sides.push_back(side);
+        };
+        {
+            std::vector<Cell> c(stride);
+            pack(start, c.data(), stride);
+            add(canonicalHash(start), c.data(), start.toMove());
+        }
+
+        struct Out {
+            std::vector<std::uint64_t> keys;
+            std::vector<Cell> cells;
+            std::vector<Color> sides;
+        };
+        constexpr std::size_t kBatch = 1 << 14; // parents per merge, bounds the child buffers
+        for (std::size_t lo = 0; lo < keys.size();) {
+            const std::size_t hi = std::min(keys.size(), lo + kBatch);
+            succ.resize(hi);
+            terminal.resize(hi);
+            std::vector<Out> outs(threads);
+            parallelFor(hi - lo, threads, [&](std::size_t begin, std::size_t end, int w) {
+                Out& out = outs[w];
+                MoveList moves;
+                std::vector<std::pair<std::uint64_t, std::size_t>> children;
+                std::vector<Cell> childCells;
+                for (std::size_t i = lo + begin; i < lo + end; ++i) {
+                    GameState s = unpack(start, &cells[i * stride], stride, sides[i]);
+                    if (isTerminal(s)) {
+                        terminal[i] = static_cast<std::uint8_t>(terminalValue(s)) + 1;
+                        succ[i] = 0;
+                        continue;
+                    }
+                    terminal[i] = 0;
+                    generateMoves(s, moves);
+                    if (moves.empty()) moves.push_back(Move::pass());
+                    children.clear();
+                    childCells.resize(moves.size() * stride);
+                    for (std::size_t k = 0; k < moves.size(); ++k) {
+                        s.play(moves[k]);
+                        children.push_back({ canonicalHash(s), k });
+                        pack(s, &childCells[k * stride], stride);
+                        s.undo();
+                    }
+                    std::sort(children.begin(), children.end());
+                    children.erase(std::unique(children.begin(), children.end(),
+                        [](const auto& a, const auto& b) { return a.first == b.first; }), children.end());
+                    succ[i] = static_cast<std::uint32_t>(children.size());
+                    for (const auto& [key, k] : children) {
+                        out.keys.push_back(key);
+                        out.cells.insert(out.cells.end(), &childCells[k * stride], &childCells[k * stride] + stride);
+                        out.sides.push_back(opponent(sides[i]));
+                    }
+                }
+            });
+            for (const Out& out : outs) {
+                for (std::size_t k = 0; k < out.keys.size(); ++k) add(out.keys[k], &out.cells[k * stride], out.sides[k]);
+            }
+            lo = hi;
+        }
+        const std::size_t n = keys.size();
+
+        // ---- backward passes, one distance level at a time
+        enum : std::uint8_t { kUnknown, kWin, kLoss, kDraw };
+        std::vector<std::atomic<std::uint8_t>> value(n);
+        std::vector<std::atomic<std::uint32_t>> remaining(n);
+        std::vector<std::uint16_t> distance(n, 0);
+        std::vector<std::uint32_t> level;
+        for (std::size_t i = 0; i < n; ++i) {
+            remaining[i].store(succ[i], std::memory_order_relaxed);
+            std::uint8_t v0 = kUnknown;
+            if (terminal[i] == static_cast<std::uint8_t>(RetroValue::Win) + 1) v0 = kWin;
+            else if (terminal[i] == static_cast<std::uint8_t>(RetroValue::Loss) + 1) v0 = kLoss;
+            else if (terminal[i]) v0 = kDraw;
+            value[i].store(v0, std::memory_order_relaxed);
+            if (v0 == kWin || v0 == kLoss) level.push_back(static_cast<std::uint32_t>(i));
+        }
+        for (int d = 0; !level.empty(); ++d) {
+            std::vector<std::vector<std::uint32_t>> next(threads);
+            parallelFor(level.size(), threads, [&](std::size_t begin, std::size_t end, int w) {
+                std::vector<std::uint32_t> preds;
+                for (std::size_t k = begin; k < end; ++k) {
+                    const std::uint32_t c = level[k];
+                    const bool childLost = value[c].load(std::memory_order_relaxed) == kLoss;
+                    preds.clear();
+                    forEachPredecessor(v, unpack(start, &cells[c * stride], stride, sides[c]), [&](const GameState& p) {
+                        auto it = index.find(canonicalHash(p));
+                        if (it != index.end()) preds.push_back(it->second);
+                    });
+                    std::sort(preds.begin(), preds.end());
+                    preds.erase(std::unique(preds.begin(), preds.end()), preds.end());
+                    for (std::uint32_t p : preds) {
+                        if (value[p].load(std::memory_order_relaxed) != kUnknown) continue;
+                        // won through one lost child; lost once the last child is won
+                        if (!childLost && remaining[p].fetch_sub(1, std::memory_order_relaxed) != 1) continue;
+                        std::uint8_t expected = kUnknown;
+                        if (value[p].compare_exchange_strong(expected, childLost ? kWin : kLoss, std::memory_order_relaxed)) {
+                            distance[p] = static_cast<std::uint16_t>(std::min(d + 1, int{ kDistanceMask }));
+                            next[w].push_back(p);
+                        }
+                    }
+                }
+            });
+            level.clear();
+            for (const auto& part : next) level.insert(level.end(), part.begin(), part.end());
+        }
+
+        // ---- sorted table with a bucket directory on the top key bits
+        RetroStats stats;
+        stats.positions = n;
+        std::vector<std::uint32_t> order(n);
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) { return keys[a] < keys[b]; });
+        int bits = 0;
+        while (bits < 24 && (std::size_t{ 8 } << bits) < n) ++bits; // ~8 keys per bucket
+        std::vector<std::uint32_t> buckets((std::size_t{ 1 } << bits) + 1, 0);
+        std::vector<std::uint64_t> sortedKeys(n);
+        std::vector<std::uint16_t> results(n);
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::uint32_t i = order[k];
+            sortedKeys[k] = keys[i];
+            if (bits) ++buckets[(keys[i] >> (64 - bits)) + 1];
+            RetroValue rv = RetroValue::Draw;
+            const std::uint8_t val = value[i].load(std::memory_order_relaxed);
+            if (val == kWin) { rv = RetroValue::Win; ++stats.wins; stats.longestWin = std::max<int>(stats.longestWin, distance[i]); }
+            else if (val == kLoss) { rv = RetroValue::Loss; ++stats.losses; }
+            else ++stats.draws;
+            results[k] = encode(rv, rv == RetroValue::Draw ? 0 : distance[i]);
+        }
+        if (bits) std::partial_sum(buckets.begin(), buckets.end(), buckets.begin());
+        else buckets[1] = static_cast<std::uint32_t>(n);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) return std::nullopt;
+        FileHeader h{};
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.version = kVersion;
+        h.bucketBits = static_cast<std::uint32_t>(bits);
+        h.count = n;
+        for (int c = 0; c < kColorCount; ++c) {
+            for (int b = 0; b < kBaseBugCount; ++b) h.hand[c][b] = v.hand[c][b];
+        }
+        const char pad[8]{};
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(reinterpret_cast<const char*>(buckets.data()), static_cast<std::streamsize>(bucketsBytes(bits)));
+        out.write(pad, static_cast<std::streamsize>(align8(bucketsBytes(bits)) - bucketsBytes(bits)));
+        out.write(reinterpret_cast<const char*>(sortedKeys.data()), static_cast<std::streamsize>(n * sizeof(std::uint64_t)));
+        out.write(reinterpret_cast<const char*>(results.data()), static_cast<std::streamsize>(n * sizeof(std::uint16_t)));
+        if (!out) return std::nullopt;
+        stats.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        return stats;
+    }
+
+    RetroTable::~RetroTable() { release(); }
+
+    void RetroTable::release() {
+#ifdef HIVE_RETRO_MMAP
+        if (mapping_) munmap(mapping_, mappedBytes_);
+#endif
+        mapping_ = nullptr;
+        mappedBytes_ = 0;
+        buffer_.clear();
+        count_ = 0;
+        bucketBits_ = 0;
+        buckets_ = nullptr;
+        keys_ = nullptr;
+        results_ = nullptr;
+    }
+
+    bool RetroTable::load(const std::string& path) {
+        release();
+        const unsigned char* base = nullptr;
+        std::size_t bytes = 0;
+#ifdef HIVE_RETRO_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st {};
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* m = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m != MAP_FAILED) {
+                mapping_ = m;
+                mappedBytes_ = static_cast<std::size_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+        if (!mapping_) return false;
+        base = static_cast<const unsigned char*>(mapping_);
+        bytes = mappedBytes_;
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) return false;
+        bytes = static_cast<std::size_t>(in.tellg());
+        buffer_.resize((bytes + 7) / 8);
+        in.seekg(0);
+        if (!in.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(bytes))) return false;
+        base = reinterpret_cast<const unsigned char*>(buffer_.data());
+#endif
+
+        FileHeader h{};
+        if (bytes < sizeof(h)) { release(); return false; }
+        std::memcpy(&h, base, sizeof(h));
+        const std::size_t keysAt = sizeof(h) + align8(h.bucketBits <= 24 ? bucketsBytes(static_cast<int>(h.bucketBits)) : 0);
+        if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion || h.bucketBits > 24 ||
+            bytes != keysAt + h.count * (sizeof(std::uint64_t) + sizeof(std::uint16_t))) {
+            release();
+            return false;
+        }
+        for (int c = 0; c < kColorCount; ++c) {
+            for (int b = 0; b < kBaseBugCount; ++b) variant_.hand[c][b] = h.hand[c][b];
+        }
+        count_ = static_cast<std::size_t>(h.count);
+        bucketBits_ = static_cast<int>(h.bucketBits);
+        buckets_ = reinterpret_cast<const std::uint32_t*>(base + sizeof(h));
+        keys_ = reinterpret_cast<const std::uint64_t*>(base + keysAt);
+        results_ = reinterpret_cast<const std::uint16_t*>(base + keysAt + count_ * sizeof(std::uint64_t));
+        return true;
+    }
+
+    std::optional<RetroResult> RetroTable::find(std::uint64_t key) const {
+        if (count_ == 0) return std::nullopt;
+        const std::size_t b = bucketBits_ ? static_cast<std::size_t>(key >> (64 - bucketBits_)) : 0;
+        const std::uint64_t* first = keys_ + buckets_[b];
+        const std::uint64_t* last = keys_ + buckets_[b + 1];
+        const std::uint64_t* it = std::lower_bound(first, last, key);
+        if (it == last || *it != key) return std::nullopt;
+        const std::uint16_t r = results_[it - keys_];
+        return RetroResult{ static_cast<RetroValue>(r >> 14), r & kDistanceMask };
+    }
+
+} // namespace hive
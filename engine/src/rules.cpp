@@ -1,7 +1,13 @@
 #include "rules.hpp"
-#include <unordered_set>
-#include <queue>
+#include "profile.hpp"
 #include <functional>
+#include <algorithm>
+#include <cstdlib>
+#include <array>
+#include <bitset>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 namespace hive {
 
@@ -15,38 +21,180 @@ namespace hive {
     }
 
     bool queenSurrounded(const GameState& s, Color c) {
-        // Find the queen's current cell (if any)
-        std::optional<Axial> qpos;
-        for (const auto& [cell, stack] : s.board()) {
-            for (int pid : stack) {
-                const Piece& p = s.pieces()[pid];
-                if (p.color == c && p.bug == Bug::Queen) {
-                    qpos = cell;
-                    break;
-                }
-            }
-            if (qpos) break;
-        }
-        if (!qpos) return false; // queen not placed yet
+        int qid = s.queenId(c);
+        if (qid < 0) return false; // queen not placed yet
+        const Axial qpos = s.pieces()[qid].pos;
 
         // Surrounded if all 6 neighbors are occupied (any color/stack)
         for (int i = 0; i < kHexDirCount; ++i) {
-            Axial n = add(*qpos, dir(i));
+            Axial n = add(qpos, dir(i));
             if (!occupied(s, n)) return false;
         }
         return true;
     }
 
     GameOver evaluateGameOver(const GameState& s) {
+        HIVE_PROFILE_ZONE(profile::Zone::GameOver);
         bool w = queenSurrounded(s, Color::White);
         bool b = queenSurrounded(s, Color::Black);
         if (w && b) return GameOver::Draw;
         if (w)      return GameOver::BlackWins;
         if (b)      return GameOver::WhiteWins;
+        if (s.repetitions() >= 2) return GameOver::Draw; // threefold
+        if (s.moveLimit() > 0 && s.ply() >= s.moveLimit()) return GameOver::Draw;
         return GameOver::None;
     }
 
 
+    // ===== connectivity oracle =====
+    // Questions about lifting one piece off a connected hive, cheapest test
+    // first. Removing a cell only matters where its occupied neighbors split into
+    // separate runs around it; every other cell reaches one of those neighbors
+    // without passing through it. So the hive stays connected iff one
+    // representative of each run (and the landing cell) are mutually reachable.
+
+    namespace {
+
+        void countTier(ConnectivityTier t) {
+            switch (t) {
+            case ConnectivityTier::StackTop: HIVE_PROFILE_COUNT(profile::Counter::ConnectivityStackTop, 1); break;
+            case ConnectivityTier::Ring: HIVE_PROFILE_COUNT(profile::Counter::ConnectivityRing, 1); break;
+            case ConnectivityTier::Bounded: HIVE_PROFILE_COUNT(profile::Counter::ConnectivityBounded, 1); break;
+            case ConnectivityTier::Full: HIVE_PROFILE_COUNT(profile::Counter::ConnectivityFull, 1); break;
+            }
+        }
+
+        using RunHeads = SmallVector<Axial, 4>;
+
+        // First cell of each run of occupied neighbors around a; a full ring is one run.
+        RunHeads occupiedRuns(const GameState& s, Axial a) {
+            bool occ[kHexDirCount];
+            for (int i = 0; i < kHexDirCount; ++i) occ[i] = occupied(s, add(a, dir(i)));
+            RunHeads heads;
+            for (int i = 0; i < kHexDirCount; ++i) {
+                if (occ[i] && !occ[(i + kHexDirCount - 1) % kHexDirCount]) heads.push_back(add(a, dir(i)));
+            }
+            if (heads.empty() && occ[0]) heads.push_back(add(a, dir(0)));
+            return heads;
+        }
+
+        int hexDistance(Axial a, Axial b) {
+            const int dq = a.q - b.q, dr = a.r - b.r;
+            return (std::abs(dq) + std::abs(dr) + std::abs(dq + dr)) / 2;
+        }
+
+        // cells searched around the vacated one before falling back to the whole hive
+        constexpr int kLocalRadius = 3;
+
+        enum class Reach { Yes, No, Unknown };
+
+        // Whether goals[1..] are all reachable from goals[0] over the hive with
+        // `gone` vacated and `extra` occupied. With radius > 0 only cells that
+        // close to `gone` are visited; the answer is Unknown when the goals were
+        // not all found and the search was cut off at that radius.
+        Reach reachesAll(const GameState& s, Axial gone, const Axial* extra, const RunHeads& goals, int radius) {
+            auto occ = [&](Axial a) { return (extra && a == *extra) || (!(a == gone) && occupied(s, a)); };
+            PoolSet<Axial, AxialHash> seen;
+            SmallVector<Axial, 32> queue{ goals[0] }; // FIFO by index
+            seen.insert(goals[0]);
+            std::size_t found = 1;
+            bool cut = false;
+            for (std::size_t head = 0; head < queue.size() && found < goals.size(); ++head) {
+                const Axial cur = queue[head];
+                for (int i = 0; i < kHexDirCount; ++i) {
+                    const Axial n = add(cur, dir(i));
+                    if (!occ(n)) continue;
+                    if (radius > 0 && hexDistance(n, gone) > radius) { cut = true; continue; }
+                    if (!seen.insert(n).second) continue;
+                    if (std::find(goals.begin(), goals.end(), n) != goals.end()) ++found;
+                    queue.push_back(n);
+                }
+            }
+            if (found == goals.size()) return Reach::Yes;
+            return cut ? Reach::Unknown : Reach::No;
+        }
+
+        // Bounded searches first, then the whole hive; goals are distinct cells.
+        // A split usually leaves one small side, so each goal gets a turn as the
+        // start: exhausting its side within the radius proves the split.
+        bool connectedThrough(const GameState& s, Axial gone, const Axial* extra, RunHeads goals, ConnectivityTier& tier) {
+            tier = ConnectivityTier::Bounded;
+            for (std::size_t i = 0; i < goals.size(); ++i) {
+                std::swap(goals[0], goals[i]);
+                const Reach local = reachesAll(s, gone, extra, goals, kLocalRadius);
+                if (local != Reach::Unknown) return local == Reach::Yes;
+            }
+            tier = ConnectivityTier::Full;
+            return reachesAll(s, gone, extra, goals, 0) == Reach::Yes;
+        }
+
+    }
+
+    bool isPinned(const GameState& s, int pieceId) {
+        HIVE_PROFILE_ZONE(profile::Zone::Pinned);
+        const Piece& p = s.pieces()[pieceId];
+        if (!p.onBoard || stackHeight(s, p.pos) > 0) return false; // a stack keeps its cell occupied
+        if (s.board().size() <= 2) return false;
+
+        const RunHeads runs = occupiedRuns(s, p.pos);
+        ConnectivityTier tier = ConnectivityTier::Ring;
+        const bool pinned = runs.size() > 1 && !connectedThrough(s, p.pos, nullptr, runs, tier);
+        countTier(tier);
+        return pinned;
+    }
+
+    PoolSet<Axial, AxialHash> pinnedCells(const GameState& s) {
+        // Iterative Tarjan articulation points over occupied cells
+        HIVE_PROFILE_ZONE(profile::Zone::Pinned);
+        PoolSet<Axial, AxialHash> out;
+        if (s.board().size() <= 2) return out;
+
+        PoolMap<Axial, int, AxialHash> index;
+        index.reserve(s.board().size() * 2);
+        SmallVector<Axial, 32> cells;
+        cells.reserve(s.board().size());
+        for (const auto& [pos, stack] : s.board()) { index.emplace(pos, (int)cells.size()); cells.push_back(pos); }
+
+        const int n = (int)cells.size();
+        // a hive has at most 28 cells; a setup with more spills to the heap
+        SmallVector<int, 32> disc, low, parent, children;
+        for (int i = 0; i < n; ++i) { disc.push_back(-1); low.push_back(0); parent.push_back(-1); children.push_back(0); }
+        struct Frame { int v; int nextDir; };
+        SmallVector<Frame, 32> stack;
+        int timer = 0;
+
+        stack.push_back({ 0, 0 });
+        disc[0] = low[0] = timer++;
+        while (!stack.empty()) {
+            Frame& f = stack.back();
+            if (f.nextDir < kHexDirCount) {
+                Axial nb = add(cells[f.v], dir(f.nextDir++));
+                auto it = index.find(nb);
+                if (it == index.end()) continue;
+                int w = it->second;
+                if (disc[w] < 0) {
+                    parent[w] = f.v;
+                    children[f.v] += 1;
+                    disc[w] = low[w] = timer++;
+                    stack.push_back({ w, 0 });
+                }
+                else if (w != parent[f.v]) {
+                    low[f.v] = std::min(low[f.v], disc[w]);
+                }
+                continue;
+            }
+            int v = f.v;
+            stack.pop_back();
+            int pv = parent[v];
+            if (pv >= 0) {
+                low[pv] = std::min(low[pv], low[v]);
+                if (parent[pv] >= 0 && low[v] >= disc[pv]) out.insert(cells[pv]);
+            }
+        }
+        if (children[0] > 1) out.insert(cells[0]);
+        return out;
+    }
+
     bool canSlideBetween(const GameState& s, Axial from, Axial to) {
         int dirIndex = -1;
         for (int i = 0; i < kHexDirCount; ++i) { if (add(from, dir(i)) == to) { dirIndex = i; break; } }
@@ -58,289 +206,671 @@ namespace hive {
         return !(leftBlocked && rightBlocked);
     }
 
-    bool keepsHiveConnectedAfter(const GameState& s, int movingPid, Axial to) {
-        // If destination equals source, connectivity is unchanged.
-        const Piece& mp = s.pieces()[movingPid];
-        const Axial from = mp.pos;
-        if (to.q == from.q && to.r == from.r) return true;
+    bool keepsHiveConnectedAfter(const GameState& s, int movingPid, Axial to, ConnectivityTier* decidedBy) {
+        HIVE_PROFILE_ZONE(profile::Zone::Connectivity);
+        const Axial from = s.pieces()[movingPid].pos;
+        ConnectivityTier tier = ConnectivityTier::StackTop;
+        auto decide = [&](bool connected) {
+            countTier(tier);
+            if (decidedBy) *decidedBy = tier;
+            return connected;
+        };
+        if (to == from) return decide(true);
+
+        // leaving a stack: the rest of the hive is untouched, only the landing matters
+        const bool vacates = stackHeight(s, from) == 0;
+        auto landsOnHive = [&] {
+            if (occupied(s, to)) return !(to == from); // climbing onto a stack
+            for (int i = 0; i < kHexDirCount; ++i) {
+                const Axial n = add(to, dir(i));
+                if (occupied(s, n) && !(vacates && n == from)) return true;
+            }
+            return false;
+        };
+        if (!vacates) return decide(landsOnHive());
+        if (s.board().size() == 1) return decide(true); // the piece is the whole hive
+
+        // a landing cell touching nothing is cut off; with one run around the
+        // vacated cell the rest stays in one piece
+        tier = ConnectivityTier::Ring;
+        if (!landsOnHive()) return decide(false);
+        RunHeads goals = occupiedRuns(s, from);
+        if (goals.size() <= 1) return decide(true);
+
+        // several runs: the landing cell may bridge them, so it joins the goals
+        if (!occupied(s, to)) goals.push_back(to);
+        return decide(connectedThrough(s, from, &to, goals, tier));
+    }
+
+
+    // ===== move generation =====
+    // Every bug is built from a few shared primitives over a Surface (the board
+    // as seen by the piece in transit). bugMoves<B> is specialized per bug at
+    // compile time and reached through a table indexed by Bug. Generation is
+    // templated on the Ruleset: the base game's table stops at the Ant and its
+    // Pillbug/Mosquito paths compile away; generateMoves() dispatches once.
+    // The primitives are also templated on where moves go: a LegalMoveList, or
+    // a MoveCount that only counts them for countLegalMoves().
+
+    namespace {
 
-        // Pack (q,r) into 64 bits
-        auto pack = [](Axial a)->std::int64_t {
+        std::int64_t packAxial(Axial a) {
             return (static_cast<std::int64_t>(a.q) << 32) |
                 static_cast<std::int64_t>(static_cast<std::uint32_t>(a.r));
-            };
-
-        // Build the set of occupied cells AFTER the move:
-        //  - remove the moving piece from 'from' (assume legal/top move elsewhere)
-        //  - add it onto 'to'
-        std::unordered_map<std::int64_t, int> occCount;
-        occCount.reserve(s.board().size() + 1);
+        }
 
-        for (const auto& [pos, stack] : s.board()) {
-            int count = static_cast<int>(stack.size());
-            // If this is the 'from' cell, remove the moving piece from its count
-            if (pos.q == from.q && pos.r == from.r) {
-                // Normally only the top can move; we just decrement count
-                if (count > 0) --count;
-            }
-            if (count > 0) {
-                occCount[pack(pos)] += count;
-            }
+        // Stands in for a LegalMoveList when only the number of moves is wanted.
+        // Walks that can stop early do so once limit is reached.
+        struct MoveCount {
+            int n{};
+            int limit{ std::numeric_limits<int>::max() };
+            void push_back(const LegalMove&) { ++n; }
+            bool full() const { return n >= limit; }
+        };
+
+        template <typename Out>
+        bool full(const Out& out) {
+            if constexpr (std::is_same_v<Out, MoveCount>) return out.full();
+            else return false;
         }
-        // Add destination occupancy for the moved piece
-        occCount[pack(to)] += 1;
 
-        // Prune any zero-count entries (defensive)
-        std::vector<std::int64_t> toErase;
-        for (auto& kv : occCount) if (kv.second <= 0) toErase.push_back(kv.first);
-        for (auto k : toErase) occCount.erase(k);
+        // Distinct destinations: a Mosquito copying two bugs may reach a cell twice.
+        struct DestinationCount {
+            PoolSet<std::int64_t> cells;
+            void push_back(const LegalMove& m) { cells.insert(packAxial(m.to)); }
+        };
 
-        // If no occupied cells remain (shouldn't really happen), treat as connected.
-        if (occCount.empty()) return true;
+        // The board with the moving piece lifted: its cell reads empty when it was alone there.
+        struct Surface {
+            const GameState& s;
+            Axial start;
+            bool startVacated;
 
-        // BFS over occupied cells (nodes are cells with occCount>0; edges between adjacent occupied cells)
-        auto unpack = [](std::int64_t k)->Axial {
-            int q = static_cast<int>(k >> 32);
-            int r = static_cast<int>(static_cast<std::int32_t>(k & 0xFFFFFFFFll));
-            return { q, r };
-            };
+            Surface(const GameState& st, int pid)
+                : s(st), start(st.pieces()[pid].pos), startVacated(stackHeight(st, start) == 0) {}
 
-        std::queue<std::int64_t> q;
-        std::unordered_set<std::int64_t> seen;
-        seen.reserve(occCount.size() * 2);
+            // a lone piece is the whole hive: single steps keep it connected, but
+            // there is no edge to walk along
+            bool lone() const { return startVacated && s.board().size() == 1; }
 
-        // start from any occupied cell
-        q.push(occCount.begin()->first);
-        seen.insert(occCount.begin()->first);
+            bool occ(Axial a) const { return !(startVacated && a == start) && occupied(s, a); }
 
-        while (!q.empty()) {
-            auto curK = q.front(); q.pop();
-            Axial cur = unpack(curK);
+            // empty cell next to the rest of the hive: a legal resting place
+            bool touchesHive(Axial a) const {
+                for (int i = 0; i < kHexDirCount; ++i) if (occ(add(a, dir(i)))) return true;
+                return false;
+            }
 
-            for (int i = 0; i < kHexDirCount; ++i) {
-                Axial n = add(cur, dir(i));
-                auto nk = pack(n);
-                // neighbor is "connected" if that cell is occupied (count > 0)
-                auto it = occCount.find(nk);
-                if (it != occCount.end() && it->second > 0) {
-                    if (seen.insert(nk).second) q.push(nk);
+            // ground-level freedom to move between neighbors: not both flanking cells occupied
+            bool slideOk(Axial from, int d) const {
+                return !(occ(add(from, dir(d + kHexDirCount - 1))) && occ(add(from, dir(d + 1))));
+            }
+        };
+
+        // Occupied cells near the moving piece, one bit each, for counting Ant
+        // moves: the walk tests the neighbors of every edge cell, and a bit is
+        // far cheaper than a board lookup. A setup spread wider than the window
+        // does not fit and is walked on the board instead.
+        class NearbyCells {
+        public:
+            explicit NearbyCells(const Surface& sf) : center_(sf.start) {
+                for (const auto& [pos, stack] : sf.s.board()) {
+                    if (!sf.occ(pos)) continue;
+                    if (!inside(pos, kReach - 2)) { fits_ = false; return; }
+                    occupied_.set(index(pos));
                 }
             }
-        }
 
-        // Connected iff we visited every occupied cell
-        return (seen.size() == occCount.size());
-    }
+            bool fits() const { return fits_; }
+            bool occ(Axial a) const { return inside(a, kReach) && occupied_.test(index(a)); }
+            bool touchesHive(Axial a) const {
+                for (int i = 0; i < kHexDirCount; ++i) if (occ(add(a, dir(i)))) return true;
+                return false;
+            }
+            bool slideOk(Axial from, int d) const {
+                return !(occ(add(from, dir(d + kHexDirCount - 1))) && occ(add(from, dir(d + 1))));
+            }
+            // for cells next to the hive; false when already visited
+            bool visit(Axial a) {
+                const std::size_t i = index(a);
+                if (seen_.test(i)) return false;
+                seen_.set(i);
+                return true;
+            }
 
+        private:
+            static constexpr int kReach = 32;
+            static constexpr int kSide = 2 * kReach + 1;
 
-    static void queenMoves(const GameState& s, int pid, std::vector<LegalMove>& out) {
-        const auto& p = s.pieces()[pid];
-        for (int i = 0; i < kHexDirCount; ++i) {
-            Axial dest = add(p.pos, dir(i));
-            if (!occupied(s, dest) && canSlideBetween(s, p.pos, dest) && keepsHiveConnectedAfter(s, pid, dest)) {
-                out.push_back({ pid,p.pos,dest,MoveKind::Slide,1 });
+            bool inside(Axial a, int reach) const { return std::abs(a.q - center_.q) <= reach && std::abs(a.r - center_.r) <= reach; }
+            std::size_t index(Axial a) const {
+                return static_cast<std::size_t>((a.q - center_.q + kReach) * kSide + (a.r - center_.r + kReach));
             }
-        }
-    }
 
-    static void beetleMoves(const GameState& s, int pid, std::vector<LegalMove>& out) {
-        const auto& p = s.pieces()[pid];
-        const Axial from = p.pos;
+            Axial center_;
+            bool fits_{ true };
+            std::bitset<kSide * kSide> occupied_, seen_;
+        };
 
-        // Height of the stack at `from` (top index), -1 if empty (defensive)
-        int hFrom = stackHeight(s, from);
+        // Ground crawl along the hive edge. steps > 0: exactly that many steps with no
+        // revisits (Queen 1, Spider 3); steps == 0: any distance (Ant).
+        void listCrawl(const Surface& sf, int pid, int steps, LegalMoveList& out) {
+            PoolSet<std::int64_t> seen;
+            seen.insert(packAxial(sf.start)); // never ends where it started
 
-        // Helper: corridor (freedom-to-move) check at ground level
-        auto canSlideBetweenGround = [&](Axial a, Axial b)->bool {
-            return canSlideBetween(s, a, b);
+            auto canStep = [&](Axial cur, int d, Axial nxt) {
+                return !sf.occ(nxt) && (sf.touchesHive(nxt) || (steps == 1 && sf.lone())) && sf.slideOk(cur, d);
             };
 
-        for (int i = 0; i < kHexDirCount; ++i) {
-            Axial to = add(from, dir(i));
-            bool destOcc = occupied(s, to);
+            if (steps == 0) {
+                // BFS; every reached cell is a destination, so out doubles as the queue
+                const std::size_t first = out.size();
+                Axial cur = sf.start;
+                for (std::size_t next = first;; cur = out[next++].to) {
+                    for (int i = 0; i < kHexDirCount; ++i) {
+                        Axial nxt = add(cur, dir(i));
+                        if (!canStep(cur, i, nxt) || !seen.insert(packAxial(nxt)).second) continue;
+                        out.push_back({ pid, nxt, MoveKind::Slide, 0 });
+                    }
+                    if (next == out.size()) break;
+                }
+                return;
+            }
 
-            // If destination is occupied, Beetle may always climb there (ignores corridor rule).
-            if (destOcc) {
-                if (keepsHiveConnectedAfter(s, pid, to)) {
-                    out.push_back({ pid, from, to, MoveKind::Climb, 1 });
+            // depth-limited DFS; several paths can end on the same cell
+            PoolSet<std::int64_t> found;
+            std::function<void(Axial, int)> dfs = [&](Axial cur, int depth) {
+                if (depth == steps) {
+                    if (found.insert(packAxial(cur)).second) out.push_back({ pid, cur, MoveKind::Slide, static_cast<std::uint8_t>(steps) });
+                    return;
                 }
-                continue;
+                for (int i = 0; i < kHexDirCount; ++i) {
+                    Axial nxt = add(cur, dir(i));
+                    if (!canStep(cur, i, nxt)) continue;
+                    auto key = packAxial(nxt);
+                    if (seen.insert(key).second) {
+                        dfs(nxt, depth + 1);
+                        seen.erase(key); // backtrack
+                    }
+                }
+            };
+            dfs(sf.start, 0);
+        }
+
+        // The same walks as crawl() over a NearbyCells grid. The Ant's count is
+        // the size of the edge component it reaches; the few cells of a short
+        // path are checked directly. Both stop once out is full.
+        template <typename Out>
+        void countCrawl(const Surface& sf, NearbyCells& grid, int pid, int steps, Out& out) {
+            auto canStep = [&](Axial cur, int d, Axial nxt) {
+                return !grid.occ(nxt) && (grid.touchesHive(nxt) || (steps == 1 && sf.lone())) && grid.slideOk(cur, d);
+            };
+            grid.visit(sf.start); // never ends where it started
+
+            if (steps == 0) {
+                SmallVector<Axial, 64> queue{ sf.start };
+                for (std::size_t next = 0; next < queue.size() && !full(out); ++next) {
+                    const Axial cur = queue[next];
+                    for (int i = 0; i < kHexDirCount; ++i) {
+                        Axial nxt = add(cur, dir(i));
+                        if (!canStep(cur, i, nxt) || !grid.visit(nxt)) continue;
+                        queue.push_back(nxt);
+                        out.push_back({ pid, nxt, MoveKind::Slide, 0 });
+                    }
+                }
+                return;
             }
 
-            // Destination is empty:
-            // - If Beetle is on TOP of a stack (hFrom > 0), it can step down to any adjacent empty
-            //   and it ignores the corridor rule (its moving along/over the hive).
-            // - If Beetle is on ground (hFrom == 0), it must obey the corridor rule to slide.
-            bool allowed = (hFrom > 0) ? true : canSlideBetweenGround(from, to);
+            std::array<Axial, 4> path{ sf.start }; // Spider paths are the longest
+            auto dfs = [&](auto& self, int depth) -> void {
+                if (full(out)) return;
+                if (depth == steps) {
+                    if (grid.visit(path[depth])) out.push_back({ pid, path[depth], MoveKind::Slide, static_cast<std::uint8_t>(steps) });
+                    return;
+                }
+                for (int i = 0; i < kHexDirCount; ++i) {
+                    Axial nxt = add(path[depth], dir(i));
+                    if (!canStep(path[depth], i, nxt)) continue;
+                    if (std::find(path.begin(), path.begin() + depth + 1, nxt) != path.begin() + depth + 1) continue;
+                    path[depth + 1] = nxt;
+                    self(self, depth + 1);
+                }
+            };
+            dfs(dfs, 0);
+        }
 
-            if (allowed && keepsHiveConnectedAfter(s, pid, to)) {
-                // Tag as Slide when landing on empty; Climb when moving onto a piece
-                out.push_back({ pid, from, to, MoveKind::Slide, 1 });
+        template <typename Out>
+        void crawl(const Surface& sf, int pid, int steps, Out& out) {
+            if constexpr (std::is_same_v<Out, LegalMoveList>) {
+                listCrawl(sf, pid, steps, out);
+            }
+            else {
+                // Ant and Spider walks are counted on the grid; a single step, or a
+                // setup too wide for the grid, is generated and counted
+                if (steps != 1) {
+                    NearbyCells grid(sf);
+                    if (grid.fits()) {
+                        countCrawl(sf, grid, pid, steps, out);
+                        return;
+                    }
+                }
+                LegalMoveList moves;
+                listCrawl(sf, pid, steps, moves);
+                for (const LegalMove& m : moves) out.push_back(m);
             }
         }
-    }
 
+        // One step in any direction, climbing onto pieces (Beetle). On top of the
+        // hive the corridor rule does not apply.
+        template <typename Out>
+        void climbStep(const Surface& sf, int pid, Out& out) {
+            const bool onTop = !sf.startVacated;
+            for (int i = 0; i < kHexDirCount; ++i) {
+                Axial to = add(sf.start, dir(i));
+                if (sf.occ(to)) {
+                    out.push_back({ pid, to, MoveKind::Climb, 1 });
+                }
+                else if ((onTop || sf.slideOk(sf.start, i)) && (sf.touchesHive(to) || sf.lone())) {
+                    out.push_back({ pid, to, MoveKind::Slide, 1 });
+                }
+            }
+        }
 
-    static void grasshopperMoves(const GameState& s, int pid, std::vector<LegalMove>& out) {
-        const auto& p = s.pieces()[pid];
-        for (int i = 0; i < kHexDirCount; ++i) {
-            Axial cur = add(p.pos, dir(i));
-            bool jumped = false;
-            while (occupied(s, cur)) { jumped = true; cur = add(cur, dir(i)); }
-            if (jumped && !occupied(s, cur) && keepsHiveConnectedAfter(s, pid, cur)) {
-                out.push_back({ pid,p.pos,cur,MoveKind::Jump,0 });
+        // Straight jumps over at least one piece (Grasshopper).
+        template <typename Out>
+        void jumpLines(const Surface& sf, int pid, Out& out) {
+            for (int i = 0; i < kHexDirCount; ++i) {
+                Axial cur = add(sf.start, dir(i));
+                if (!sf.occ(cur)) continue;
+                while (sf.occ(cur)) cur = add(cur, dir(i));
+                out.push_back({ pid, cur, MoveKind::Jump, 0 });
             }
         }
-    }
 
-    static void antMoves(const GameState& s, int pid, std::vector<LegalMove>& out) {
-        const auto& p = s.pieces()[pid];
-        const Axial start = p.pos;
+        // Two steps over the hive, then one down into an empty cell (Ladybug).
+        template <typename Out>
+        void hiveWalk(const Surface& sf, int pid, Out& out) {
+            PoolSet<std::int64_t> found;
+            for (int i = 0; i < kHexDirCount; ++i) {
+                Axial up = add(sf.start, dir(i));
+                if (!sf.occ(up)) continue;
+                for (int j = 0; j < kHexDirCount; ++j) {
+                    Axial over = add(up, dir(j));
+                    if (over == sf.start || !sf.occ(over)) continue;
+                    for (int k = 0; k < kHexDirCount; ++k) {
+                        Axial down = add(over, dir(k));
+                        if (down == sf.start || sf.occ(down)) continue;
+                        if (found.insert(packAxial(down)).second) out.push_back({ pid, down, MoveKind::Slide, 3 });
+                    }
+                }
+            }
+        }
 
-        // Treat the start hex as empty while exploring.
-        auto occ = [&](Axial a)->bool {
-            return !(a.q == start.q && a.r == start.r) && occupied(s, a);
-            };
+        template <typename Out>
+        void mosquitoMoves(const Surface& sf, int pid, Out& out);
+
+        template <Bug B, typename Out>
+        void bugMoves(const Surface& sf, int pid, Out& out) {
+            if constexpr (B == Bug::Queen || B == Bug::Pillbug) crawl(sf, pid, 1, out);
+            else if constexpr (B == Bug::Spider) crawl(sf, pid, 3, out);
+            else if constexpr (B == Bug::Ant) crawl(sf, pid, 0, out);
+            else if constexpr (B == Bug::Beetle) climbStep(sf, pid, out);
+            else if constexpr (B == Bug::Grasshopper) jumpLines(sf, pid, out);
+            else if constexpr (B == Bug::Ladybug) hiveWalk(sf, pid, out);
+            else mosquitoMoves(sf, pid, out);
+        }
+
+        template <typename Out>
+        using BugMovesFn = void (*)(const Surface&, int, Out&);
 
-        // A cell is "on the hive perimeter" if it's empty and adjacent to at least one occupied cell.
-        auto adjacentToHive = [&](Axial a)->bool {
+        template <typename Out, std::size_t... I>
+        constexpr std::array<BugMovesFn<Out>, sizeof...(I)> makeBugMovesTable(std::index_sequence<I...>) {
+            return { &bugMoves<static_cast<Bug>(I), Out>... };
+        }
+        template <Ruleset R, typename Out>
+        constexpr auto kBugMoves = makeBugMovesTable<Out>(std::make_index_sequence<RulesetTraits<R>::kBugs>{});
+
+        // Moves as any bug it touches (never as another Mosquito); as a Beetle while on top.
+        template <typename Out>
+        void mosquitoMoves(const Surface& sf, int pid, Out& out) {
+            if (!sf.startVacated) {
+                climbStep(sf, pid, out);
+                return;
+            }
+            bool copied[kBugCount]{};
+            using Borrowed = std::conditional_t<std::is_same_v<Out, MoveCount>, DestinationCount, LegalMoveList>;
+            Borrowed borrowed;
             for (int i = 0; i < kHexDirCount; ++i) {
-                Axial n = add(a, dir(i));
-                if (occ(n)) return true;
+                auto it = sf.s.board().find(add(sf.start, dir(i)));
+                if (it == sf.s.board().end()) continue;
+                const Bug b = sf.s.pieces()[it->second.back()].bug;
+                if (b == Bug::Mosquito || copied[bugIndex(b)]) continue;
+                copied[bugIndex(b)] = true;
+                kBugMoves<Ruleset::MLP, Borrowed>[bugIndex(b)](sf, pid, borrowed);
             }
-            return false;
-            };
+            if constexpr (std::is_same_v<Out, MoveCount>) {
+                out.n += static_cast<int>(borrowed.cells.size());
+            }
+            else {
+                PoolSet<std::int64_t> found;
+                for (const LegalMove& m : borrowed) {
+                    if (found.insert(packAxial(m.to)).second) out.push_back(m);
+                }
+            }
+        }
 
-        // Slide corridor check that considers the start cell empty.
-        auto canSlideBetweenConsideringStart = [&](Axial from, Axial to)->bool {
-            int dirIndex = -1;
-            for (int i = 0; i < kHexDirCount; ++i) { if (add(from, dir(i)) == to) { dirIndex = i; break; } }
-            if (dirIndex < 0) return false;
-            Axial left = add(from, dir((dirIndex + kHexDirCount - 1) % kHexDirCount));
-            Axial right = add(from, dir((dirIndex + 1) % kHexDirCount));
-            bool leftBlocked = occ(left);
-            bool rightBlocked = occ(right);
-            return !(leftBlocked && rightBlocked);
-            };
+        constexpr profile::Zone bugZone(Bug b) {
+            return static_cast<profile::Zone>(static_cast<int>(profile::Zone::Queen) + bugIndex(b));
+        }
+        static_assert(bugZone(Bug::Pillbug) == profile::Zone::Pillbug);
 
-        auto pack = [](Axial a)->std::int64_t {
-            return (static_cast<std::int64_t>(a.q) << 32) |
-                static_cast<std::int64_t>(static_cast<std::uint32_t>(a.r));
-            };
+        template <Ruleset R, typename Out>
+        void pieceMoves(const GameState& s, int pid, Out& out) {
+            HIVE_PROFILE_ZONE(bugZone(s.pieces()[pid].bug));
+            const Surface sf(s, pid);
+            kBugMoves<R, Out>[bugIndex(s.pieces()[pid].bug)](sf, pid, out);
+        }
 
-        std::queue<Axial> q;
-        std::unordered_set<std::int64_t> seen;
+        bool isTopPiece(const GameState& s, int pid) {
+            const Piece& p = s.pieces()[pid];
+            if (!p.onBoard) return false;
+            auto it = s.board().find(p.pos);
+            return it != s.board().end() && it->second.back() == pid;
+        }
 
-        // Seed from starts slide-legal empty neighbors that are on the hive perimeter.
-        for (int i = 0; i < kHexDirCount; ++i) {
-            Axial n = add(start, dir(i));
-            if (!occ(n) && adjacentToHive(n) && canSlideBetweenConsideringStart(start, n)) {
-                auto key = pack(n);
-                if (seen.insert(key).second) q.push(n);
-            }
+        int frozenPiece(const GameState& s) {
+            const Move* last = s.lastMove();
+            return last ? last->pieceId : -1;
         }
 
-        // BFS across empty perimeter cells only
-        while (!q.empty()) {
-            Axial cur = q.front(); q.pop();
+        // Gate at height 1: both cells flanking a->b are stacks.
+        bool gatedAbove(const GameState& s, Axial a, Axial b) {
+            for (int i = 0; i < kHexDirCount; ++i) {
+                if (!(add(a, dir(i)) == b)) continue;
+                return stackHeight(s, add(a, dir(i + kHexDirCount - 1))) >= 1 &&
+                    stackHeight(s, add(a, dir(i + 1))) >= 1;
+            }
+            return false;
+        }
 
-            // Any visited perimeter cell is a legal destination (if hive stays connected)
-            if (keepsHiveConnectedAfter(s, pid, cur)) {
-                out.push_back({ pid, start, cur, MoveKind::Slide, /*steps*/0 });
+        bool canThrow(const GameState& s, int pid) {
+            const Piece& p = s.pieces()[pid];
+            if (!isTopPiece(s, pid) || stackHeight(s, p.pos) != 0 || pid == frozenPiece(s)) return false;
+            if (p.bug == Bug::Pillbug) return true;
+            if (p.bug != Bug::Mosquito) return false;
+            for (int i = 0; i < kHexDirCount; ++i) {
+                auto it = s.board().find(add(p.pos, dir(i)));
+                if (it != s.board().end() && s.pieces()[it->second.back()].bug == Bug::Pillbug) return true;
             }
+            return false;
+        }
 
+        template <typename IsPinnedCell>
+        void throwMoves(const GameState& s, int thrower, const IsPinnedCell& pinnedAt, LegalMoveList& out) {
+            HIVE_PROFILE_ZONE(profile::Zone::Throws);
+            if (!canThrow(s, thrower)) return;
+            const Axial center = s.pieces()[thrower].pos;
+            const int frozen = frozenPiece(s);
             for (int i = 0; i < kHexDirCount; ++i) {
-                Axial nxt = add(cur, dir(i));
-                if (occ(nxt)) continue;                              // cannot occupy a piece
-                if (!adjacentToHive(nxt)) continue;                  // stay on the hive perimeter
-                if (!canSlideBetweenConsideringStart(cur, nxt)) continue;
-
-                auto key = pack(nxt);
-                if (seen.insert(key).second) {
-                    q.push(nxt);
+                const Axial from = add(center, dir(i));
+                auto it = s.board().find(from);
+                if (it == s.board().end() || it->second.size() != 1) continue;
+                const int victim = it->second.back();
+                if (victim == frozen || pinnedAt(from) || gatedAbove(s, from, center)) continue;
+                for (int j = 0; j < kHexDirCount; ++j) {
+                    const Axial to = add(center, dir(j));
+                    if (occupied(s, to) || gatedAbove(s, center, to)) continue;
+                    out.push_back({ victim, to, MoveKind::Throw, 2 });
                 }
             }
         }
+
+    } // namespace
+
+    void legalMovesForPiece(const GameState& s, int pid, LegalMoveList& out) {
+        if (!isTopPiece(s, pid) || isPinned(s, pid)) return;
+        if (s.ruleset() == Ruleset::MLP) pieceMoves<Ruleset::MLP>(s, pid, out);
+        else pieceMoves<Ruleset::Base>(s, pid, out);
     }
 
+    std::vector<LegalMove> legalMovesForPiece(const GameState& s, int pid) {
+        LegalMoveList out;
+        legalMovesForPiece(s, pid, out);
+        return { out.begin(), out.end() };
+    }
 
+    static int countUnpinnedMoves(const GameState& s, int pid, int limit) {
+        MoveCount count;
+        count.limit = limit;
+        if (s.ruleset() == Ruleset::MLP) pieceMoves<Ruleset::MLP>(s, pid, count);
+        else pieceMoves<Ruleset::Base>(s, pid, count);
+        return count.n;
+    }
 
-    static void spiderMoves(const GameState& s, int pid, std::vector<LegalMove>& out) {
-        const auto& piece = s.pieces()[pid];
-        const Axial start = piece.pos;
+    int countLegalMovesForPiece(const GameState& s, int pid, int limit) {
+        if (!isTopPiece(s, pid) || isPinned(s, pid)) return 0;
+        return countUnpinnedMoves(s, pid, limit);
+    }
 
-        // Treat the start hex as empty while exploring
-        auto occ = [&](Axial a)->bool {
-            return !(a.q == start.q && a.r == start.r) && occupied(s, a);
-            };
+    int countLegalMovesForPiece(const GameState& s, int pid, const PoolSet<Axial, AxialHash>& pinned, int limit) {
+        if (!isTopPiece(s, pid) || (stackHeight(s, s.pieces()[pid].pos) == 0 && pinned.count(s.pieces()[pid].pos))) return 0;
+        return countUnpinnedMoves(s, pid, limit);
+    }
+
+    std::vector<LegalMove> pillbugThrows(const GameState& s, int throwerId) {
+        LegalMoveList out;
+        throwMoves(s, throwerId, [&](Axial a) { return isPinned(s, s.board().at(a).back()); }, out);
+        return { out.begin(), out.end() };
+    }
 
-        // Perimeter check: empty cell that touches at least one occupied cell
-        auto adjacentToHive = [&](Axial a)->bool {
+    namespace {
+        using CellList = SmallVector<Axial, 64>;
+    }
+
+    static void placementCells(const GameState& s, Color c, CellList& out) {
+        HIVE_PROFILE_ZONE(profile::Zone::Placement);
+        if (s.board().empty()) {
+            out.push_back({ 0,0 });
+            return;
+        }
+        if (s.placementsMade(c) > 0) {
+            // later pieces touch own color only: the state keeps exactly that set
+            for (const Axial& a : s.placeableCells(c)) out.push_back(a);
+            HIVE_PROFILE_COUNT(profile::Counter::PlacementCells, out.size());
+            return;
+        }
+        // the first own piece may touch anything
+        PoolSet<Axial, AxialHash> uniq;
+        uniq.reserve(s.board().size() * 4);
+        for (const auto& [pos, stack] : s.board()) {
             for (int i = 0; i < kHexDirCount; ++i) {
-                if (occ(add(a, dir(i)))) return true;
+                Axial n = add(pos, dir(i));
+                if (!occupied(s, n) && uniq.insert(n).second) out.push_back(n);
             }
-            return false;
-            };
+        }
+        HIVE_PROFILE_COUNT(profile::Counter::PlacementCells, out.size());
+    }
 
-        // Sliding corridor check that treats the start as empty
-        auto canSlideBetweenConsideringStart = [&](Axial from, Axial to)->bool {
-            int dirIndex = -1;
-            for (int i = 0; i < kHexDirCount; ++i) { if (add(from, dir(i)) == to) { dirIndex = i; break; } }
-            if (dirIndex < 0) return false;
-            Axial left = add(from, dir((dirIndex + kHexDirCount - 1) % kHexDirCount));
-            Axial right = add(from, dir((dirIndex + 1) % kHexDirCount));
-            bool leftBlocked = occ(left);
-            bool rightBlocked = occ(right);
-            return !(leftBlocked && rightBlocked);
-            };
+    std::vector<Axial> placementTargets(const GameState& s, Color c) {
+        CellList out;
+        placementCells(s, c, out);
+        return { out.begin(), out.end() };
+    }
 
-        auto pack = [](Axial a)->std::int64_t {
-            return (static_cast<std::int64_t>(a.q) << 32) |
-                static_cast<std::int64_t>(static_cast<std::uint32_t>(a.r));
-            };
+    static int placementCount(const GameState& s, Color c) {
+        if (!s.board().empty() && s.placementsMade(c) > 0) {
+            HIVE_PROFILE_ZONE(profile::Zone::Placement);
+            const int n = static_cast<int>(s.placeableCells(c).size());
+            HIVE_PROFILE_COUNT(profile::Counter::PlacementCells, n);
+            return n;
+        }
+        CellList cells; // the first piece of a side or of the game: twice per game
+        placementCells(s, c, cells);
+        return static_cast<int>(cells.size());
+    }
 
-        // Depth-limited DFS (exactly 3 steps), no revisits
-        std::unordered_set<std::int64_t> visited;
-        visited.insert(pack(start));
+    template <Ruleset R>
+    void generateMovesFor(const GameState& s, MoveList& out) {
+        using Traits = RulesetTraits<R>;
+        HIVE_PROFILE_ZONE(profile::Zone::GenerateMoves);
+        out.clear();
+        const Color us = s.toMove();
+
+        // placements: one per bug kind; the queen must be down by the 4th placement
+        const bool queenForced = !s.queenPlaced(us) && s.placementsMade(us) >= 3;
+        CellList cells;
+        for (int b = 0; b < Traits::kBugs; ++b) {
+            const Bug bug = static_cast<Bug>(b);
+            if (queenForced && bug != Bug::Queen) continue;
+            const int pid = s.nextInHand(us, bug);
+            if (pid < 0) continue;
+            if (cells.empty()) placementCells(s, us, cells);
+            for (const Axial& a : cells) out.push_back({ pid, a, true });
+        }
 
-        std::function<void(Axial, int)> dfs = [&](Axial cur, int depth) {
-            if (depth == 3) {
-                if (!(cur.q == start.q && cur.r == start.r)) {
-                    if (keepsHiveConnectedAfter(s, pid, cur)) {
-                        out.push_back({ pid, start, cur, MoveKind::Slide, /*steps*/3 });
-                    }
-                }
-                return;
+        // piece moves only once the own queen is placed
+        if (!s.queenPlaced(us)) {
+            HIVE_PROFILE_COUNT(profile::Counter::MovesGenerated, out.size());
+            return;
+        }
+        const auto pinned = pinnedCells(s);
+        LegalMoveList lm;
+        for (const auto& [pos, stack] : s.board()) {
+            const int pid = stack.back();
+            if (s.pieces()[pid].color != us) continue;
+            if (stack.size() == 1 && pinned.count(pos)) continue;
+            lm.clear();
+            pieceMoves<R>(s, pid, lm);
+            for (const auto& m : lm) out.push_back({ pid, m.to, false });
+        }
+
+        if constexpr (Traits::has(Bug::Pillbug)) {
+            // the piece moved last turn is frozen: only ever ours after a throw
+            const int frozen = frozenPiece(s);
+            if (frozen >= 0 && s.pieces()[frozen].color == us) {
+                out.erase(std::remove_if(out.begin(), out.end(), [&](const Move& m) { return m.pieceId == frozen; }), out.end());
             }
 
-            for (int i = 0; i < kHexDirCount; ++i) {
-                Axial nxt = add(cur, dir(i));
-                if (occ(nxt)) continue;                         // cannot step onto occupied
-                if (!adjacentToHive(nxt)) continue;             // stay on perimeter
-                if (!canSlideBetweenConsideringStart(cur, nxt)) continue;
-
-                auto key = pack(nxt);
-                if (visited.insert(key).second) {
-                    dfs(nxt, depth + 1);
-                    visited.erase(key);                          // backtrack
+            // throws use the thrower in place, so a pinned Pillbug still throws; the
+            // same piece may land on the same cell by more than one route
+            for (const Piece& p : s.pieces()) {
+                if (p.color != us || !p.onBoard || (p.bug != Bug::Pillbug && p.bug != Bug::Mosquito)) continue;
+                lm.clear();
+                throwMoves(s, p.id, [&](Axial a) { return pinned.count(a) > 0; }, lm);
+                for (const auto& m : lm) {
+                    const Move mv{ m.pieceId, m.to, false };
+                    if (std::find(out.begin(), out.end(), mv) == out.end()) out.push_back(mv);
                 }
             }
-            };
+        }
+        HIVE_PROFILE_COUNT(profile::Counter::MovesGenerated, out.size());
+    }
 
-        dfs(start, 0);
+    template <Ruleset R>
+    std::vector<Move> generateMovesFor(const GameState& s) {
+        MoveList out;
+        generateMovesFor<R>(s, out);
+        return { out.begin(), out.end() };
     }
 
+    template void generateMovesFor<Ruleset::Base>(const GameState&, MoveList&);
+    template void generateMovesFor<Ruleset::MLP>(const GameState&, MoveList&);
+    template std::vector<Move> generateMovesFor<Ruleset::Base>(const GameState&);
+    template std::vector<Move> generateMovesFor<Ruleset::MLP>(const GameState&);
 
-    std::vector<LegalMove> legalMovesForPiece(const GameState& s, int pid) {
-        std::vector<LegalMove> out;
-        switch (s.pieces()[pid].bug) {
-        case Bug::Queen: queenMoves(s, pid, out); break;
-        case Bug::Beetle: beetleMoves(s, pid, out); break;
-        case Bug::Grasshopper: grasshopperMoves(s, pid, out); break;
-        case Bug::Ant: antMoves(s, pid, out); break;
-        case Bug::Spider: spiderMoves(s, pid, out); break;
+    void generateMoves(const GameState& s, MoveList& out) {
+        if (s.ruleset() == Ruleset::MLP) generateMovesFor<Ruleset::MLP>(s, out);
+        else generateMovesFor<Ruleset::Base>(s, out);
+    }
+
+    std::vector<Move> generateMoves(const GameState& s) {
+        return s.ruleset() == Ruleset::MLP ? generateMovesFor<Ruleset::MLP>(s) : generateMovesFor<Ruleset::Base>(s);
+    }
+
+    // Mirrors generateMovesFor<R> step by step, counting instead of storing;
+    // profiled under the same zones and counters.
+    template <Ruleset R>
+    int countLegalMovesFor(const GameState& s) {
+        using Traits = RulesetTraits<R>;
+        HIVE_PROFILE_ZONE(profile::Zone::GenerateMoves);
+        const Color us = s.toMove();
+
+        const bool queenForced = !s.queenPlaced(us) && s.placementsMade(us) >= 3;
+        int kinds = 0;
+        for (int b = 0; b < Traits::kBugs; ++b) {
+            const Bug bug = static_cast<Bug>(b);
+            if ((queenForced && bug != Bug::Queen) || s.nextInHand(us, bug) < 0) continue;
+            ++kinds;
         }
-        return out;
+        int n = kinds > 0 ? kinds * placementCount(s, us) : 0;
+        if (!s.queenPlaced(us)) {
+            HIVE_PROFILE_COUNT(profile::Counter::MovesGenerated, n);
+            return n;
+        }
+
+        const int frozen = Traits::has(Bug::Pillbug) ? frozenPiece(s) : -1;
+        const auto pinned = pinnedCells(s);
+        MoveCount count;
+        for (const auto& [pos, stack] : s.board()) {
+            const int pid = stack.back();
+            if (s.pieces()[pid].color != us || pid == frozen) continue;
+            if (stack.size() == 1 && pinned.count(pos)) continue;
+            pieceMoves<R>(s, pid, count);
+        }
+        n += count.n;
+
+        if constexpr (Traits::has(Bug::Pillbug)) {
+            // Throws are rare and few, so they are listed and each is checked
+            // against the earlier throws and the victim's own moves, which the
+            // generator would already hold.
+            LegalMoveList thrown, own;
+            for (const Piece& p : s.pieces()) {
+                if (p.color != us || !p.onBoard || (p.bug != Bug::Pillbug && p.bug != Bug::Mosquito)) continue;
+                throwMoves(s, p.id, [&](Axial a) { return pinned.count(a) > 0; }, thrown);
+            }
+            for (std::size_t i = 0; i < thrown.size(); ++i) {
+                const LegalMove& m = thrown[i];
+                auto same = [&](const LegalMove& o) { return o.pieceId == m.pieceId && o.to == m.to; };
+                if (std::any_of(thrown.begin(), thrown.begin() + i, same)) continue;
+                if (s.pieces()[m.pieceId].color == us) {
+                    own.clear();
+                    pieceMoves<R>(s, m.pieceId, own);
+                    if (std::any_of(own.begin(), own.end(), same)) continue;
+                }
+                ++n;
+            }
+        }
+        HIVE_PROFILE_COUNT(profile::Counter::MovesGenerated, n);
+        return n;
+    }
+
+    template int countLegalMovesFor<Ruleset::Base>(const GameState&);
+    template int countLegalMovesFor<Ruleset::MLP>(const GameState&);
+
+    int countLegalMoves(const GameState& s) {
+        return s.ruleset() == Ruleset::MLP ? countLegalMovesFor<Ruleset::MLP>(s) : countLegalMovesFor<Ruleset::Base>(s);
+    }
+
+    namespace {
+        template <Ruleset R>
+        std::uint64_t perftFor(GameState& s, int depth) {
+            if (depth == 0 || evaluateGameOver(s) != GameOver::None) return 1;
+            if (depth == 1) return std::max(countLegalMovesFor<R>(s), 1); // bulk count; a pass is one move
+            MoveList moves;
+            generateMovesFor<R>(s, moves);
+            if (moves.empty()) moves.push_back(Move::pass());
+            std::uint64_t n = 0;
+            for (const Move& m : moves) {
+                s.play(m);
+                n += perftFor<R>(s, depth - 1);
+                s.undo();
+            }
+            return n;
+        }
+    }
+
+    std::uint64_t perft(GameState& s, int depth) {
+        return s.ruleset() == Ruleset::MLP ? perftFor<Ruleset::MLP>(s, depth) : perftFor<Ruleset::Base>(s, depth);
     }
 
 } // namespace hive
\ No newline at end of file
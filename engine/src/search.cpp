@@ -0,0 +1,334 @@
+#include "search.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+
+namespace hive {
+
+    namespace {
+        constexpr int kQueenPressure = 60;  // per occupied neighbor of a queen
+        constexpr int kFreePiece = 8;       // per top piece that is not pinned
+        constexpr int kMobility = 2;        // per move of a free piece...
+        constexpr int kMobilityCap = 6;     // ...up to this many, so one Ant does not outweigh the rest
+
+        // The hash does not cover the ruleset, and a table may be shared by
+        // searches of both: salt MLP keys so a Base result never answers one.
+        constexpr std::uint64_t kMlpKey = 0x510e527fade682d1ULL;
+
+        template <Ruleset R>
+        std::uint64_t tableKey(const GameState& s) { return R == Ruleset::MLP ? s.hash() ^ kMlpKey : s.hash(); }
+
+        int queenPressure(const GameState& s, Color c) {
+            int qid = s.queenId(c);
+            if (qid < 0) return 0;
+            int n = 0;
+            for (int i = 0; i < kHexDirCount; ++i) {
+                if (occupied(s, add(s.pieces()[qid].pos, dir(i)))) ++n;
+            }
+            return n;
+        }
+
+        bool adjacent(Axial a, Axial b) {
+            for (int i = 0; i < kHexDirCount; ++i) if (add(a, dir(i)) == b) return true;
+            return false;
+        }
+    }
+
+    int evaluate(const GameState& s) {
+        const Color us = s.toMove();
+        const Color them = opponent(us);
+
+        const auto pinned = pinnedCells(s);
+        int freePieces[kColorCount]{};
+        int mobility[kColorCount]{};
+        for (const auto& [pos, stack] : s.board()) {
+            const Piece& top = s.pieces()[stack.back()];
+            if (stack.size() > 1 || !pinned.count(pos)) {
+                freePieces[colorIndex(top.color)] += 1;
+                mobility[colorIndex(top.color)] += std::min(countLegalMovesForPiece(s, top.id, pinned, kMobilityCap), kMobilityCap);
+            }
+        }
+
+        return kQueenPressure * (queenPressure(s, them) - queenPressure(s, us))
+            + kFreePiece * (freePieces[colorIndex(us)] - freePieces[colorIndex(them)])
+            + kMobility * (mobility[colorIndex(us)] - mobility[colorIndex(them)]);
+    }
+
+    namespace {
+        // Slot data: move key (24 bits), score + kScoreBias (20), depth (8), bound (2), age (6).
+        constexpr int kScoreBias = 1 << 19;
+
+        // Win scores count plies from the root; the table keeps them from the node.
+        int scoreToTable(int score, int ply) { return score >= kWinThreshold ? score + ply : score <= -kWinThreshold ? score - ply : score; }
+        int scoreFromTable(int score, int ply) { return score >= kWinThreshold ? score - ply : score <= -kWinThreshold ? score + ply : score; }
+    }
+
+    TranspositionTable::TranspositionTable(std::size_t entries) {
+        std::size_t size = 1;
+        while (size * 2 <= std::max<std::size_t>(entries, 1)) size *= 2;
+        slots_ = std::make_unique<Slot[]>(size);
+        mask_ = size - 1;
+    }
+
+    bool TranspositionTable::probe(std::uint64_t key, Hit& out) const {
+        const Slot& slot = slots_[key & mask_];
+        const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) != key || data == 0) return false;
+        out.move = PackedMove{ static_cast<std::uint32_t>(data & PackedMove::kIdentityMask) };
+        out.score = static_cast<int>((data >> 24) & 0xfffff) - kScoreBias;
+        out.depth = static_cast<int>((data >> 44) & 0xff);
+        out.bound = static_cast<Bound>((data >> 52) & 3);
+        return true;
+    }
+
+    void TranspositionTable::store(std::uint64_t key, int depth, int score, Bound bound, PackedMove move) {
+        Slot& slot = slots_[key & mask_];
+        const std::uint64_t old = slot.data.load(std::memory_order_relaxed);
+        const bool sameKey = (slot.check.load(std::memory_order_relaxed) ^ old) == key;
+        if (old && !sameKey && ((old >> 58) & 0x3f) == age_ && static_cast<int>((old >> 44) & 0xff) > depth) return;
+        const std::uint64_t data = (move.key() & PackedMove::kIdentityMask)
+            | static_cast<std::uint64_t>(std::clamp(score + kScoreBias, 0, 0xfffff)) << 24
+            | static_cast<std::uint64_t>(std::clamp(depth, 0, 0xff)) << 44
+            | static_cast<std::uint64_t>(bound) << 52
+            | static_cast<std::uint64_t>(age_) << 58;
+        slot.data.store(data, std::memory_order_relaxed);
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    void TranspositionTable::clear() {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            slots_[i].data.store(0, std::memory_order_relaxed);
+            slots_[i].check.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    int TranspositionTable::permilleFull() const {
+        const std::size_t n = std::min<std::size_t>(1000, mask_ + 1);
+        int used = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::uint64_t data = slots_[i].data.load(std::memory_order_relaxed);
+            used += data != 0 && ((data >> 58) & 0x3f) == age_;
+        }
+        return static_cast<int>(used * 1000 / n);
+    }
+
+    int Searcher::elapsedMs() const {
+        return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_).count());
+    }
+
+    void Searcher::startClock(const TimeControl& clock, int ply) {
+        start_ = std::chrono::steady_clock::now();
+        timed_ = clock.timed();
+        if (timed_) {
+            time_.start(clock, ply);
+            deadline_ = start_ + std::chrono::milliseconds(time_.maximumMs());
+        }
+    }
+
+    void Searcher::ponderHit(const TimeControl& clock) {
+        std::lock_guard<std::mutex> lock(ponderMutex_);
+        hitClock_ = clock;
+        ponderHit_.store(true, std::memory_order_release);
+    }
+
+    bool Searcher::outOfBudget() {
+        if (stop_.load(std::memory_order_relaxed)) return true;
+        if (pondering_) {
+            if (!ponderHit_.load(std::memory_order_acquire)) return false;
+            std::lock_guard<std::mutex> lock(ponderMutex_);
+            pondering_ = false;
+            startClock(hitClock_, rootPly_);
+        }
+        if (limits_.maxNodes > 0 && nodes_ >= limits_.maxNodes) return true;
+        if (limits_.moveTimeMs > 0 && elapsedMs() >= limits_.moveTimeMs) return true;
+        return timed_ && std::chrono::steady_clock::now() >= deadline_;
+    }
+
+    void Searcher::orderMoves(const GameState& s, MoveList& moves, int ply, PackedMove ttMove) const {
+        // previous iteration's PV move first, then the table's move, then moves that close in on the enemy queen
+        const Color them = opponent(s.toMove());
+        const int oq = s.queenId(them);
+        const Move* pvMove = ply < (int)prevPv_.size() ? &prevPv_[ply] : nullptr;
+
+        auto score = [&](const Move& m) {
+            if (pvMove && m == *pvMove) return 1 << 20;
+            if (!ttMove.isPass() && pack(m) == ttMove) return 1 << 19;
+            int sc = 0;
+            if (oq >= 0) {
+                const Axial qpos = s.pieces()[oq].pos;
+                if (adjacent(m.to, qpos)) sc += 100;
+                if (!m.isPlacement && adjacent(s.pieces()[m.pieceId].pos, qpos)) sc -= 100;
+            }
+            if (m.isPlacement) sc -= 10;
+            return sc;
+        };
+        // stable by score without std::stable_sort's heap buffer: sort (score, index) keys
+        SmallVector<std::int64_t, 256> keys;
+        for (int i = 0; i < (int)moves.size(); ++i) keys.push_back(static_cast<std::int64_t>(-score(moves[i])) * (1 << 16) + i);
+        std::sort(keys.begin(), keys.end());
+        const MoveList unordered = moves;
+        for (int i = 0; i < (int)keys.size(); ++i) moves[i] = unordered[static_cast<int>(keys[i] & 0xffff)];
+    }
+
+    template <Ruleset R>
+    int Searcher::negamax(GameState& s, int depth, int ply, int alpha, int beta, std::vector<Move>& pv) {
+        pv.clear();
+        ++nodes_;
+        if ((nodes_ & 255) == 0 && outOfBudget()) aborted_ = true;
+        if (aborted_) return 0;
+
+        const GameOver go = evaluateGameOver(s);
+        if (go == GameOver::Draw) return 0;
+        // a position repeated inside the tree leads nowhere new: score the cycle as a draw
+        if (go == GameOver::None && s.repetitions() > 0) return 0;
+        if (go != GameOver::None) {
+            const Color winner = go == GameOver::WhiteWins ? Color::White : Color::Black;
+            return winner == s.toMove() ? kWinScore - ply : -(kWinScore - ply);
+        }
+        if (depth == 0) return evaluate(s);
+
+        TranspositionTable::Hit hit;
+        const bool found = table_->probe(tableKey<R>(s), hit);
+        if (found && hit.depth >= depth) {
+            const int score = scoreFromTable(hit.score, ply);
+            if (hit.bound == TranspositionTable::Bound::Exact ||
+                (hit.bound == TranspositionTable::Bound::Lower && score >= beta) ||
+                (hit.bound == TranspositionTable::Bound::Upper && score <= alpha)) {
+                if (!hit.move.isPass()) pv.assign(1, unpackMove(hit.move));
+                return score;
+            }
+        }
+
+        MoveList& moves = plyMoves_[ply];
+        generateMovesFor<R>(s, moves);
+        if (moves.empty()) moves.push_back(Move::pass());
+        orderMoves(s, moves, ply, found ? hit.move : PackedMove{});
+
+        const int alphaIn = alpha;
+        int best = -kWinScore - 1;
+        std::vector<Move> childPv;
+        for (const Move& m : moves) {
+            s.play(m);
+            int score = -negamax<R>(s, depth - 1, ply + 1, -beta, -alpha, childPv);
+            s.undo();
+            if (aborted_) return 0;
+
+            if (score > best) {
+                best = score;
+                pv.assign(1, m);
+                pv.insert(pv.end(), childPv.begin(), childPv.end());
+            }
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) break;
+        }
+        const auto bound = best >= beta ? TranspositionTable::Bound::Lower
+            : best > alphaIn ? TranspositionTable::Bound::Exact : TranspositionTable::Bound::Upper;
+        table_->store(tableKey<R>(s), depth, scoreToTable(best, ply), bound, pack(pv.front()));
+        return best;
+    }
+
+    template <Ruleset R>
+    void Searcher::searchRoot(GameState& s, int depth, std::vector<RootMove>& roots) {
+        // Multi-PV: a root move only needs an exact score while it can still
+        // reach the top multiPv, so alpha is the multiPv-th best exact score so far.
+        const int k = std::max(1, limits_.multiPv);
+        std::vector<int> exact; // best exact scores so far, descending
+        std::vector<Move> childPv;
+        for (RootMove& rm : roots) {
+            const int alpha = (int)exact.size() >= k ? exact[k - 1] : -kWinScore - 1;
+            s.play(rm.move);
+            int score = -negamax<R>(s, depth - 1, 1, -kWinScore - 1, -alpha, childPv);
+            s.undo();
+            if (aborted_) return;
+
+            rm.score = score; // upper bound when <= alpha, ranked below the exact lines
+            rm.pv.assign(1, rm.move);
+            rm.pv.insert(rm.pv.end(), childPv.begin(), childPv.end());
+            if (score > alpha) {
+                exact.insert(std::upper_bound(exact.begin(), exact.end(), score, std::greater<int>()), score);
+            }
+        }
+        std::stable_sort(roots.begin(), roots.end(), [](const RootMove& a, const RootMove& b) { return a.score > b.score; });
+    }
+
+    SearchResult Searcher::search(const GameState& root, const SearchLimits& limits, const InfoCallback& onInfo) {
+        limits_ = limits;
+        nodes_ = 0;
+        aborted_ = false;
+        rootPly_ = root.ply();
+        pondering_ = limits.ponder; // a ponderHit() may already be waiting
+        startClock(limits.ponder ? TimeControl{} : limits.clock, rootPly_);
+        prevPv_.clear();
+        table_->newSearch();
+
+        GameState s = root;
+        SearchResult result;
+
+        // root moves: searchmoves filtered to what is legal here
+        // ply never exceeds the iteration depth; sized up front so no buffer moves mid-search
+        if ((int)plyMoves_.size() <= limits.maxDepth) plyMoves_.resize(limits.maxDepth + 1);
+        MoveList legal;
+        generateMoves(s, legal);
+        if (legal.empty()) legal.push_back(Move::pass());
+        std::vector<RootMove> roots;
+        for (const Move& m : legal) {
+            if (limits.searchMoves.empty() ||
+                std::find(limits.searchMoves.begin(), limits.searchMoves.end(), m) != limits.searchMoves.end()) {
+                roots.push_back({ m, 0, {} });
+            }
+        }
+        if (roots.empty()) {
+            pondering_ = false;
+            ponderHit_.store(false, std::memory_order_relaxed);
+            return result;
+        }
+        orderMoves(s, legal, 0);
+        std::stable_sort(roots.begin(), roots.end(), [&](const RootMove& a, const RootMove& b) {
+            return std::find(legal.begin(), legal.end(), a.move) < std::find(legal.begin(), legal.end(), b.move);
+        });
+        // always have a legal answer, even if the first iteration is interrupted
+        result.best = roots.front().move;
+        result.pv.assign(1, result.best);
+
+        for (int depth = 1; depth <= limits.maxDepth; ++depth) {
+            std::vector<RootMove> iter = roots; // previous iteration's order
+            if (s.ruleset() == Ruleset::MLP) searchRoot<Ruleset::MLP>(s, depth, iter);
+            else searchRoot<Ruleset::Base>(s, depth, iter);
+            if (aborted_) break;
+
+            roots = std::move(iter);
+            prevPv_ = roots.front().pv;
+            result.depth = depth;
+            result.score = roots.front().score;
+            result.pv = roots.front().pv;
+            result.best = roots.front().move;
+
+            if (onInfo) {
+                const int timeMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start_).count());
+                const int lines = std::min<int>(std::max(1, limits.multiPv), (int)roots.size());
+                for (int i = 0; i < lines; ++i) {
+                    SearchInfo info;
+                    info.depth = depth;
+                    info.multiPv = i + 1;
+                    info.score = roots[i].score;
+                    info.nodes = nodes_;
+                    info.timeMs = timeMs;
+                    info.pv = roots[i].pv;
+                    onInfo(info);
+                }
+            }
+            if (limits.multiPv <= 1 && std::abs(result.score) >= kWinThreshold) break; // forced result found
+            if (outOfBudget()) break;
+            if (timed_ && !pondering_ && (roots.size() == 1 || !time_.keepSearching(elapsedMs(), result.best, result.score))) break;
+        }
+        // a ponder search answers only once its move is played (or it is stopped)
+        while (pondering_ && !outOfBudget()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        pondering_ = false;
+        ponderHit_.store(false, std::memory_order_relaxed);
+        result.nodes = nodes_;
+        return result;
+    }
+
+} // namespace hive
@@ -0,0 +1,242 @@
+#include "solver.hpp"
+#include <algorithm>
+
+namespace hive {
+
+    namespace {
+
+        constexpr std::uint32_t kInf = std::uint32_t{ 1 } << 30;
+
+        std::uint32_t sat(std::uint32_t a, std::uint32_t b) { return std::min(kInf, a + b); }
+
+        // table key salts; White attacking a base game keeps the plain hash
+        constexpr std::uint64_t kBlackAttacksKey = 0xbb67ae8584caa73bULL;
+        constexpr std::uint64_t kMlpKey = 0x3c6ef372fe94f82bULL;
+
+        GameOver winFor(Color c) { return c == Color::White ? GameOver::WhiteWins : GameOver::BlackWins; }
+
+        // Empty cells around c's queen; 6 before it is placed. Fewer is closer to a surround.
+        std::uint32_t openNeighbors(const GameState& s, Color c) {
+            const int qid = s.queenId(c);
+            if (qid < 0) return 6;
+            const Axial q = s.pieces()[qid].pos;
+            std::uint32_t n = 0;
+            for (int i = 0; i < 6; ++i) n += !occupied(s, add(q, dir(i)));
+            return n;
+        }
+
+    }
+
+    std::optional<Move> findSurroundInOne(GameState& s) {
+        MoveList scratch;
+        return findSurroundInOne(s, scratch);
+    }
+
+    std::optional<Move> findSurroundInOne(GameState& s, MoveList& scratch) {
+        const Color us = s.toMove();
+        const int qid = s.queenId(opponent(us));
+        // without our queen down only placements are legal, and none may touch the enemy queen
+        if (qid < 0 || !s.queenPlaced(us)) return std::nullopt;
+
+        const Axial q = s.pieces()[qid].pos;
+        int open = 0;
+        Axial hole{};
+        bool throwable = false; // one of our Pillbugs (or Mosquitoes) touches the queen
+        for (int i = 0; i < 6; ++i) {
+            const Axial n = add(q, dir(i));
+            auto it = s.board().find(n);
+            if (it == s.board().end()) {
+                ++open;
+                hole = n;
+                continue;
+            }
+            const Piece& top = s.pieces()[it->second.back()];
+            if (top.color == us && (top.bug == Bug::Pillbug || top.bug == Bug::Mosquito)) throwable = true;
+        }
+        if (open != 1 && !throwable) return std::nullopt;
+
+        const GameOver win = winFor(us);
+        generateMoves(s, scratch);
+        for (const Move& m : scratch) {
+            if (!(open == 1 && m.to == hole) && !(throwable && m.pieceId == qid)) continue;
+            s.play(m);
+            const bool won = evaluateGameOver(s) == win;
+            s.undo();
+            if (won) return m;
+        }
+        return std::nullopt;
+    }
+
+    ProofSolver::ProofSolver(std::size_t ttEntries) {
+        std::size_t size = 1;
+        while (size < ttEntries) size <<= 1;
+        table_.resize(size);
+    }
+
+    void ProofSolver::clearTable() {
+        std::fill(table_.begin(), table_.end(), Entry{});
+    }
+
+    bool ProofSolver::outOfBudget() const {
+        return stop_.load(std::memory_order_relaxed) || (maxNodes_ > 0 && nodes_ >= maxNodes_);
+    }
+
+    const ProofSolver::Entry* ProofSolver::probe(std::uint64_t key) const {
+        const Entry& e = table_[key & (table_.size() - 1)];
+        return e.plies >= 0 && e.key == key ? &e : nullptr;
+    }
+
+    // A proof within p plies holds for any larger bound, a disproof for any smaller one.
+    bool ProofSolver::lookup(std::uint64_t key, int plies, Numbers& out) const {
+        const Entry* e = probe(key);
+        if (!e) return false;
+        if (e->pn == 0 && e->plies <= plies) out = { 0, kInf };
+        else if (e->dn == 0 && e->plies >= plies) out = { kInf, 0 };
+        else if (e->plies == plies) out = { e->pn, e->dn };
+        else return false;
+        return true;
+    }
+
+    void ProofSolver::store(std::uint64_t key, int plies, Numbers n, const Move& best) {
+        Entry& e = table_[key & (table_.size() - 1)];
+        e = { key, n.pn, n.dn, pack(best), static_cast<std::int16_t>(plies) };
+    }
+
+    // Children of the node at s with their starting numbers: game over, the
+    // table, the threat check for a final attacker move, else a guess from how
+    // open the defending queen is.
+    void ProofSolver::expand(GameState& s, int plies, std::vector<Child>& children) {
+        children.clear();
+        generateMoves(s, scratch_);
+        for (const Move& m : scratch_) children.push_back({ m, 0, 1, 1 });
+        if (children.empty()) children.push_back({ Move::pass(), 0, 1, 1 });
+
+        const GameOver win = winFor(attacker_);
+        const Color defender = opponent(attacker_);
+        const int childPlies = plies - 1;
+        const bool childAttacks = s.toMove() != attacker_;
+        for (Child& c : children) {
+            s.play(c.move);
+            c.key = key(s);
+            Numbers n{ kInf, 0 };
+            const GameOver g = evaluateGameOver(s);
+            if (g == win) n = { 0, kInf };
+            else if (g != GameOver::None || childPlies <= 0) n = { kInf, 0 };
+            else if (childAttacks && childPlies == 1) {
+                ++nodes_;
+                if (findSurroundInOne(s, scratch_)) n = { 0, kInf };
+            }
+            else if (!lookup(c.key, childPlies, n)) n = { openNeighbors(s, defender), 1 };
+            s.undo();
+            c.pn = n.pn;
+            c.dn = n.dn;
+        }
+    }
+
+    // Multiple-iterative-deepening step: expand the most-proving child until
+    // this node's numbers reach a threshold.
+    ProofSolver::Numbers ProofSolver::mid(GameState& s, int plies, std::uint32_t thPn, std::uint32_t thDn) {
+        ++nodes_;
+        const std::uint64_t nodeKey = key(s);
+        const bool orNode = s.toMove() == attacker_;
+        if (orNode) {
+            if (auto w = findSurroundInOne(s, scratch_)) {
+                store(nodeKey, 1, { 0, kInf }, *w);
+                return { 0, kInf };
+            }
+            if (plies <= 1) {
+                store(nodeKey, plies, { kInf, 0 }, Move::pass());
+                return { kInf, 0 };
+            }
+        }
+
+        std::vector<Child>& children = plyChildren_[rootPlies_ - plies];
+        expand(s, plies, children);
+
+        Numbers n{};
+        std::size_t best = 0;
+        for (;;) {
+            // OR: pn is the easiest child proof, dn the sum; AND the other way round
+            std::uint32_t second = kInf;
+            n = orNode ? Numbers{ kInf, 0 } : Numbers{ 0, kInf };
+            for (std::size_t i = 0; i < children.size(); ++i) {
+                const Child& c = children[i];
+                const std::uint32_t v = orNode ? c.pn : c.dn;
+                std::uint32_t& minField = orNode ? n.pn : n.dn;
+                std::uint32_t& sumField = orNode ? n.dn : n.pn;
+                sumField = sat(sumField, orNode ? c.dn : c.pn);
+                if (v < minField) {
+                    second = minField;
+                    minField = v;
+                    best = i;
+                }
+                else if (v < second) second = v;
+            }
+            if (n.pn >= thPn || n.dn >= thDn || outOfBudget()) break;
+
+            Child& c = children[best];
+            const std::uint32_t childThPn = orNode ? std::min(thPn, sat(second, 1)) : thPn - n.pn + c.pn;
+            const std::uint32_t childThDn = orNode ? thDn - n.dn + c.dn : std::min(thDn, sat(second, 1));
+            s.play(c.move);
+            const Numbers r = mid(s, plies - 1, childThPn, childThDn);
+            s.undo();
+            c.pn = r.pn;
+            c.dn = r.dn;
+        }
+        store(nodeKey, plies, n, children[best].move);
+        return n;
+    }
+
+    // Follows stored best moves from a proven root, playing them on s; the last
+    // attacker move was never stored and is found again.
+    std::vector<Move> ProofSolver::principalLine(GameState& s, int plies) {
+        std::vector<Move> line;
+        for (; plies > 0; --plies) {
+            if (s.toMove() == attacker_) {
+                if (auto w = findSurroundInOne(s, scratch_)) {
+                    line.push_back(*w);
+                    break;
+                }
+            }
+            const Entry* e = probe(key(s));
+            if (!e || e->pn != 0) break;
+            line.push_back(unpackMove(e->best));
+            s.play(line.back());
+        }
+        return line;
+    }
+
+    SolveResult ProofSolver::solve(const GameState& root, const SolveLimits& limits) {
+        SolveResult res;
+        GameState s = root;
+        attacker_ = s.toMove();
+        keySalt_ = (attacker_ == Color::Black ? kBlackAttacksKey : 0) ^ (s.ruleset() == Ruleset::MLP ? kMlpKey : 0);
+        nodes_ = 0;
+        maxNodes_ = limits.maxNodes;
+        if (evaluateGameOver(s) != GameOver::None) {
+            res.result = ProofResult::NoWin;
+            return res;
+        }
+
+        for (int moves = 1; moves <= limits.maxMoves; ++moves) {
+            rootPlies_ = 2 * moves - 1;
+            if (plyChildren_.size() < static_cast<std::size_t>(rootPlies_) + 1) plyChildren_.resize(rootPlies_ + 1);
+            const Numbers n = mid(s, rootPlies_, kInf, kInf);
+            if (n.pn == 0) {
+                res.result = ProofResult::Win;
+                res.winInMoves = moves;
+                res.pv = principalLine(s, rootPlies_);
+                if (!res.pv.empty()) res.best = res.pv.front();
+                break;
+            }
+            if (n.dn != 0) {
+                res.result = ProofResult::Unknown;
+                break;
+            }
+            res.result = ProofResult::NoWin;
+        }
+        res.nodes = nodes_;
+        return res;
+    }
+
+} // namespace hive
@@ -0,0 +1,96 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+
+namespace hive {
+
+    namespace {
+        // Which pool and queue the current thread works for, if any.
+        thread_local const ThreadPool* tlsPool = nullptr;
+        thread_local int tlsQueue = -1;
+    }
+
+    ThreadPool::ThreadPool(int threads) {
+        if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        for (int i = 0; i < threads; ++i) queues_.push_back(std::make_unique<Queue>());
+        for (int i = 0; i < threads; ++i) workers_.emplace_back([this, i] { run(i); });
+    }
+
+    ThreadPool::~ThreadPool() {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            quit_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& t : workers_) t.join();
+    }
+
+    void ThreadPool::submit(std::function<void()> task) {
+        const int self = tlsPool == this ? tlsQueue : -1;
+        const std::size_t q = self >= 0 ? static_cast<std::size_t>(self) : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+            queues_[q]->tasks.push_back(std::move(task));
+        }
+        // sleepers re-check the queues under this lock, so the wakeup is not lost
+        { std::lock_guard<std::mutex> lock(sleepMutex_); }
+        wake_.notify_one();
+    }
+
+    void ThreadPool::wait() {
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        idle_.wait(lock, [&] { return outstanding_.load(std::memory_order_acquire) == 0; });
+    }
+
+    bool ThreadPool::takeTask(int self, std::function<void()>& out) {
+        {
+            Queue& own = *queues_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                out = std::move(own.tasks.front());
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+        const int n = static_cast<int>(queues_.size());
+        for (int k = 1; k < n; ++k) {
+            Queue& victim = *queues_[(self + k) % n];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                out = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::run(int self) {
+        tlsPool = this;
+        tlsQueue = self;
+        std::function<void()> task;
+        for (;;) {
+            if (takeTask(self, task)) {
+                task();
+                task = nullptr;
+                if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(sleepMutex_);
+                    idle_.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            if (quit_) return;
+            // recheck under the lock: a submit in between has either queued
+            // its task already (found here) or not yet notified (wakes us)
+            bool queued = false;
+            for (const auto& q : queues_) {
+                std::lock_guard<std::mutex> qlock(q->mutex);
+                queued = queued || !q->tasks.empty();
+            }
+            if (!queued) wake_.wait(lock);
+        }
+    }
+
+} // namespace hive
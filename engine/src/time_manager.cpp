@@ -0,0 +1,44 @@
+#include "time_manager.hpp"
+#include <algorithm>
+
+namespace hive {
+
+    namespace {
+        // Hive games rarely last beyond 30 moves a side; plan for fewer as the
+        // game goes on, but never fewer than a dozen.
+        int expectedMovesLeft(int ply) { return std::clamp(30 - ply / 4, 12, 30); }
+
+        constexpr int kScoreDropStep = 30;     // eval units: half a queen neighbor
+        constexpr double kMaxDropScale = 2.0;
+        constexpr double kNextIterationRatio = 0.5; // stop when past this share of the budget
+    }
+
+    void TimeManager::start(const TimeControl& tc, int ply) {
+        const int usable = std::max(1, tc.remainingMs - tc.overheadMs);
+        const int movesLeft = tc.movesToGo > 0 ? tc.movesToGo : expectedMovesLeft(ply);
+        maximum_ = std::max(1, std::min(usable * 4 / 5, usable / movesLeft * 5 + tc.incrementMs));
+        optimum_ = std::clamp(usable / movesLeft + tc.incrementMs * 3 / 4, 1, maximum_);
+        haveLast_ = false;
+        lastBest_ = Move::pass();
+        lastScore_ = 0;
+        instability_ = 0;
+        dropScale_ = 1;
+    }
+
+    int TimeManager::budgetMs() const {
+        const double stretched = optimum_ * (1 + instability_ * 0.5) * dropScale_;
+        return static_cast<int>(std::min<double>(stretched, maximum_));
+    }
+
+    bool TimeManager::keepSearching(int elapsedMs, const Move& best, int score) {
+        instability_ *= 0.5;
+        if (haveLast_ && !(best == lastBest_)) instability_ += 1;
+        const int drop = haveLast_ ? lastScore_ - score : 0;
+        dropScale_ = drop >= kScoreDropStep ? std::min(kMaxDropScale, 1.0 + double(drop) / (5 * kScoreDropStep)) : 1.0;
+        haveLast_ = true;
+        lastBest_ = best;
+        lastScore_ = score;
+        return elapsedMs < budgetMs() * kNextIterationRatio;
+    }
+
+} // namespace hive
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "annotate.hpp"
+#include <sstream>
+
+using namespace hive;
+
+// A random game whose side to move now forces the surround in two, then a
+// move that throws it away.
+static GameRecord missedWin() {
+    auto rec = parseRecord(
+        "base * wS1@0,0 bG1@1,-1 wG1@-1,1 bA1@2,-2 wB1@0,1 bB1@2,-1 wQ@1,1 bQ@2,-3 wB2@1,2 bB2@1,-3 wG2@0,3 "
+        "bS1@3,-2 wS2@2,2 bB1@1,-1 wG3@-1,2 bS2@2,-1 wA1@-2,3 bG2@0,-2 wA1@4,-2 bG3@2,-4 wA1@3,-5 bB1@0,-1 "
+        "wA1@2,-5 bG1@-1,-1 wA2@-1,3 bG1@3,-5 wA3@3,1 bS2@1,-1 wA3@2,3 bS2@2,0 wA2@-1,4 bA2@0,-3 wA1@-1,3 "
+        "bA2@4,-3 wA3@4,-6 bA3@3,-1 wA2@4,-2 bA3@5,-6 wA2@-2,2 bA2@4,-7 wG3@1,0 bA3@4,-5 wA1@-1,0 bA2@0,2 "
+        "wA1@1,-4 bA2@3,-3 wA3@3,2 bA2@3,-1 wA1@-1,-1 bS2@4,-1 wA3@2,3 bA3@3,-4 wG3@-1,0 bB1@-1,0 wA3@-2,3 "
+        "bB1@-2,0 wS1@1,-2 bA3@2,1 wS2@4,0 bA3@-1,-2 wS1@1,0 bA3@1,3 wA3@-3,3 bA3@3,0 wA3@-2,1 bS2@4,1 "
+        "wA3@-1,-2 bS2@4,-1 wA3@4,1 bA3@1,-4 wA2@2,2 bB1@-2,1 wA3@2,3 bA3@-1,3 wA3@5,-1 bA3@1,-4 wA3@0,2 "
+        "bA3@4,-5 wS1@1,-2 bA3@1,0 wA3@2,1 bB1@-1,0 wA3@4,-3 bA3@3,2 wS1@1,-1 bA3@-1,-2 wA3@4,1 bA3@3,-3 "
+        "wA2@5,1 bA3@3,2 wA2@5,-2 bA3@5,0 wA2@5,1 bA3@6,1 wS1@2,0");
+    GameState s;
+    for (const Move& m : rec->moves) s.play(m);
+    Searcher searcher;
+    SearchLimits only;
+    only.maxDepth = 3;
+    for (const Move& m : generateMoves(s)) {
+        only.searchMoves.assign(1, m);
+        if (searcher.search(s, only).score < kWinThreshold) {
+            rec->moves.push_back(m);
+            break;
+        }
+    }
+    return *rec;
+}
+
+static AnnotateOptions options(int threads) {
+    AnnotateOptions o;
+    o.depth = 3;
+    o.threads = threads;
+    o.ttEntries = 1 << 16;
+    return o;
+}
+
+TEST(Annotate, FlagsAMissedForcedWinAndWritesComments) {
+    const GameRecord g = missedWin();
+    std::atomic<std::int64_t> done{ 0 };
+    const auto notes = annotateGames({ g }, options(3), &done);
+    ASSERT_EQ(notes.size(), 1u);
+    ASSERT_EQ(notes[0].plies.size(), g.moves.size());
+    EXPECT_EQ(done.load(), static_cast<std::int64_t>(g.moves.size()));
+
+    int flagged = 0;
+    for (std::size_t i = 0; i < g.moves.size(); ++i) {
+        const PlyNote& p = notes[0].plies[i];
+        EXPECT_EQ(p.played, g.moves[i]);
+        EXPECT_GE(p.drop(), 0);
+        if (p.played == p.best) { EXPECT_EQ(p.drop(), 0); }
+        flagged += p.drop() >= options(1).threshold;
+    }
+    EXPECT_EQ(notes[0].flagged, flagged);
+    const PlyNote& last = notes[0].plies.back();
+    EXPECT_GE(last.bestScore, kWinThreshold);
+    EXPECT_LT(last.playedScore, kWinThreshold);
+
+    std::stringstream out;
+    writeAnnotated(out, g, notes[0], options(1).threshold);
+    const std::string text = out.str();
+    EXPECT_NE(text.find("# ply " + std::to_string(g.moves.size()) + ": "), std::string::npos);
+
+    int rejected = 0;
+    const auto back = readRecords(out, &rejected);
+    EXPECT_EQ(rejected, 0);
+    ASSERT_EQ(back.size(), 1u);
+    EXPECT_EQ(formatRecord(back[0]), formatRecord(g));
+}
+
+TEST(Annotate, SingleThreadIsReproducible) {
+    GameRecord g = missedWin();
+    g.moves.resize(24);
+    const auto a = annotateGames({ g, g }, options(1));
+    const auto b = annotateGames({ g, g }, options(1));
+    ASSERT_EQ(a.size(), 2u);
+    for (std::size_t k = 0; k < a.size(); ++k) {
+        ASSERT_EQ(a[k].plies.size(), b[k].plies.size());
+        for (std::size_t i = 0; i < a[k].plies.size(); ++i) {
+            EXPECT_EQ(a[k].plies[i].best, b[k].plies[i].best);
+            EXPECT_EQ(a[k].plies[i].bestScore, b[k].plies[i].bestScore);
+            EXPECT_EQ(a[k].plies[i].playedScore, b[k].plies[i].playedScore);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include "book.hpp"
+
+using namespace hive;
+
+static Axial rotate(Axial a) { return { -a.r, a.q + a.r }; }
+static Axial reflect(Axial a) { return { a.r, a.q }; }
+
+// The first few legal moves of a game, deterministic but not trivial.
+static GameRecord openingRecord(int plies, size_t pick, GameOver result) {
+    GameRecord g;
+    GameState s;
+    for (int i = 0; i < plies; ++i) {
+        auto moves = generateMoves(s);
+        const Move m = moves[(pick + i) % moves.size()];
+        g.moves.push_back(m);
+        s.play(m);
+    }
+    g.result = result;
+    return g;
+}
+
+TEST(Book, ParseMoveRoundTrips) {
+    GameState s(Ruleset::MLP);
+    for (int i = 0; i < 8; ++i) {
+        for (const Move& m : generateMoves(s)) {
+            auto back = parseMove(s, moveToString(s, m));
+            ASSERT_TRUE(back.has_value()) << moveToString(s, m);
+            EXPECT_EQ(*back, m);
+        }
+        s.play(generateMoves(s)[i % 3]);
+    }
+    EXPECT_FALSE(parseMove(s, "wZ@0,0").has_value());
+    EXPECT_FALSE(parseMove(s, "wQ@0").has_value());
+}
+
+TEST(Book, RecordRoundTrips) {
+    GameRecord g = openingRecord(10, 5, GameOver::BlackWins);
+    const std::string line = formatRecord(g);
+    auto back = parseRecord(line);
+    ASSERT_TRUE(back.has_value()) << line;
+    EXPECT_EQ(back->ruleset, g.ruleset);
+    EXPECT_EQ(back->result, g.result);
+    EXPECT_EQ(back->moves, g.moves);
+
+    std::istringstream in("# comment\n\n" + line + "\nbase 1-0 wQ@0,0 nonsense\n");
+    int rejected = 0;
+    auto all = readRecords(in, &rejected);
+    EXPECT_EQ(all.size(), 1u);
+    EXPECT_EQ(rejected, 1);
+
+    // well-formed but illegal: not touching the hive, touching the enemy, a second queen
+    EXPECT_FALSE(parseRecord("base * wQ@0,0 wA1@1,0").has_value());
+    EXPECT_FALSE(parseRecord("base * wA1@0,0 bA1@5,5").has_value());
+    EXPECT_FALSE(parseRecord("base * wQ@0,0 bQ@1,0 wQ@9,9").has_value());
+    EXPECT_FALSE(parseRecord("base * wQ@0,0 pass").has_value()); // black has moves
+}
+
+TEST(Book, CanonicalHashFoldsSymmetries) {
+    const std::vector<std::pair<Bug, Axial>> white = { { Bug::Queen, { 0,0 } }, { Bug::Ant, { 1,0 } } };
+    const std::vector<std::pair<Bug, Axial>> black = { { Bug::Spider, { 0,1 } }, { Bug::Beetle, { -1,2 } } };
+    auto build = [&](auto map) {
+        GameState s;
+        for (auto& [b, a] : white) s.addDemoPiece(b, Color::White, map(a));
+        for (auto& [b, a] : black) s.addDemoPiece(b, Color::Black, map(a));
+        return s;
+    };
+    const std::uint64_t key = canonicalHash(build([](Axial a) { return a; }));
+    EXPECT_EQ(canonicalHash(build([](Axial a) { return rotate(a); })), key);
+    EXPECT_EQ(canonicalHash(build([](Axial a) { return rotate(rotate(rotate(a))); })), key);
+    EXPECT_EQ(canonicalHash(build([](Axial a) { return reflect(a); })), key);
+    EXPECT_EQ(canonicalHash(build([](Axial a) { return Axial{ a.q + 3, a.r - 5 }; })), key);
+    // a genuinely different shape does not fold onto it
+    EXPECT_NE(canonicalHash(build([](Axial a) { return Axial{ a.q * 2, a.r }; })), key);
+}
+
+TEST(Book, WrittenBookPicksTheWinningLine) {
+    BookBuilder builder(Ruleset::Base);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(builder.add(openingRecord(6, 0, GameOver::WhiteWins)));
+        EXPECT_TRUE(builder.add(openingRecord(6, 1, GameOver::BlackWins)));
+    }
+    GameRecord mlp;
+    mlp.ruleset = Ruleset::MLP;
+    EXPECT_FALSE(builder.add(mlp));
+    ASSERT_GT(builder.positions(), 0u);
+
+    const std::string path = ::testing::TempDir() + "hive_test.book";
+    ASSERT_TRUE(builder.write(path));
+    OpeningBook book;
+    ASSERT_TRUE(book.load(path));
+
+    // a header whose entry count disagrees with the file is refused before anything is sized by it
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    ASSERT_GT(bytes.size(), 24u);
+    for (const std::uint64_t count : { std::uint64_t{ 1 } << 60, std::uint64_t{ builder.positions() + 1 } }) {
+        std::string forged = bytes;
+        std::memcpy(forged.data() + 16, &count, sizeof(count)); // the count follows magic, version and ruleset
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << forged;
+        OpeningBook bad;
+        EXPECT_FALSE(bad.load(path));
+    }
+    std::remove(path.c_str());
+    EXPECT_EQ(book.size(), builder.positions());
+
+    GameState s;
+    auto first = book.pick(s);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(*first, generateMoves(s)[0]); // the line white won
+    s.play(*first);
+    auto stats = book.find(s);
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->whiteWins, 5u);
+
+    EXPECT_FALSE(book.pick(GameState(Ruleset::MLP)).has_value());
+}
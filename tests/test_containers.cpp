@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "rules.hpp"
+
+using namespace hive;
+
+TEST(Containers, SmallVectorSpillsAndCopies) {
+    SmallVector<int, 4> v{ 1, 2, 3 };
+    EXPECT_FALSE(v.onHeap());
+    v.insert(v.begin(), 0);
+    EXPECT_FALSE(v.onHeap());
+    v.push_back(v[0]); // aliasing an element while growing
+    EXPECT_TRUE(v.onHeap());
+    EXPECT_EQ(v, (SmallVector<int, 4>{ 0, 1, 2, 3, 0 }));
+
+    SmallVector<int, 4> copy = v;
+    v.erase(v.begin() + 1, v.begin() + 3);
+    EXPECT_EQ(v, (SmallVector<int, 4>{ 0, 3, 0 }));
+    EXPECT_EQ(copy.size(), 5u);
+
+    SmallVector<int, 4> moved = std::move(copy);
+    EXPECT_TRUE(moved.onHeap());
+    EXPECT_TRUE(copy.empty());
+    SmallVector<int, 4> small{ 7 };
+    moved = std::move(small);
+    EXPECT_FALSE(moved.onHeap());
+    EXPECT_EQ(moved, (SmallVector<int, 4>{ 7 }));
+}
+
+TEST(Containers, MoveListMatchesVectorApi) {
+    GameState s(Ruleset::MLP);
+    MoveList list;
+    for (int ply = 0; ply < 30; ++ply) {
+        const auto moves = generateMoves(s);
+        generateMoves(s, list);
+        ASSERT_EQ(std::vector<Move>(list.begin(), list.end()), moves);
+        if (moves.empty()) s.play(Move::pass());
+        else s.play(moves[(ply * 7) % moves.size()]);
+    }
+}
+
+// States are copied to and destroyed on other threads (the UI worker does this):
+// blocks freed on a thread that did not allocate them must stay usable.
+TEST(Containers, PoolSurvivesCrossThreadFrees) {
+    GameState s;
+    for (int ply = 0; ply < 12; ++ply) s.play(generateMoves(s)[ply % 3]);
+    std::vector<GameState> copies(8, s);
+    std::thread t([&] { copies.clear(); });
+    t.join();
+    for (int i = 0; i < 4; ++i) {
+        std::thread w([s]() mutable {
+            for (int ply = 0; ply < 20 && evaluateGameOver(s) == GameOver::None; ++ply) {
+                const auto moves = generateMoves(s);
+                s.play(moves.empty() ? Move::pass() : moves.back());
+            }
+        });
+        w.join();
+    }
+    GameState again = s;
+    EXPECT_EQ(again.board(), s.board());
+    EXPECT_EQ(again.hash(), s.hash());
+}
+
+// Blocks freed by a thread that never allocates still reach the depot when it
+// exits, so allocating them again here takes no new chunks.
+TEST(Containers, PoolReusesBlocksFreedByAnotherThread) {
+    if (!pool::enabled()) GTEST_SKIP();
+    constexpr std::size_t kBlocks = 20000, kBytes = 64;
+    std::vector<void*> blocks(kBlocks);
+    auto roundTrip = [&] {
+        for (void*& b : blocks) b = pool::allocate(kBytes);
+        std::thread([&] { for (void* b : blocks) pool::deallocate(b, kBytes); }).join();
+    };
+    roundTrip();
+    const std::size_t reserved = pool::reservedBytes();
+    for (int i = 0; i < 50; ++i) roundTrip();
+    EXPECT_EQ(pool::reservedBytes(), reserved);
+}
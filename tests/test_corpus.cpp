@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "corpus.hpp"
+#include <algorithm>
+#include <set>
+#include <sstream>
+
+using namespace hive;
+
+// Reference one-hive check: BFS over the occupied cells, with the cell `without`
+// not counted when its stack is a single piece.
+static bool connectedWithout(const GameState& s, Axial without) {
+    std::set<std::pair<int, int>> cells;
+    for (const auto& [pos, stack] : s.board()) {
+        if (!(pos == without && stack.size() == 1)) cells.insert({ pos.q, pos.r });
+    }
+    if (cells.empty()) return true;
+    std::set<std::pair<int, int>> seen{ *cells.begin() };
+    std::vector<std::pair<int, int>> todo{ *cells.begin() };
+    while (!todo.empty()) {
+        const Axial a{ todo.back().first, todo.back().second };
+        todo.pop_back();
+        for (int i = 0; i < kHexDirCount; ++i) {
+            const Axial n = add(a, dir(i));
+            if (cells.count({ n.q, n.r }) && seen.insert({ n.q, n.r }).second) todo.push_back({ n.q, n.r });
+        }
+    }
+    return seen.size() == cells.size();
+}
+
+static bool connected(const GameState& s) { return connectedWithout(s, { 1000, 1000 }); }
+
+static std::vector<GameRecord> smallCorpus(Ruleset r) {
+    CorpusOptions o;
+    o.ruleset = r;
+    o.positions = 120;
+    o.seed = 11;
+    o.weighted = true;
+    return generateCorpus(o);
+}
+
+TEST(Corpus, SeededAndBucketed) {
+    const auto corpus = smallCorpus(Ruleset::Base);
+    ASSERT_EQ(corpus.size(), 120u);
+    const auto again = smallCorpus(Ruleset::Base);
+    for (std::size_t i = 0; i < corpus.size(); ++i) EXPECT_EQ(formatRecord(corpus[i]), formatRecord(again[i]));
+
+    const auto counts = corpusHistogram(corpus);
+    EXPECT_GE(std::count_if(counts.begin(), counts.end(), [](int n) { return n > 0; }), 8);
+    EXPECT_GT(counts[corpusBucket(replay(corpus.back()))], 0);
+    int stacked = 0;
+    for (int b = 0; b < kCorpusBuckets; ++b) stacked += b % kCorpusStackBands ? counts[b] : 0;
+    EXPECT_GT(stacked, 20);
+
+    std::set<std::uint64_t> hashes;
+    for (const GameRecord& g : corpus) {
+        const GameState s = replay(g);
+        EXPECT_EQ(evaluateGameOver(s), GameOver::None);
+        EXPECT_TRUE(hashes.insert(s.hash()).second);
+    }
+}
+
+TEST(Corpus, FileRoundTrip) {
+    const auto corpus = smallCorpus(Ruleset::MLP);
+    std::stringstream file;
+    writeCorpus(file, corpus);
+    int rejected = 0;
+    const auto loaded = readRecords(file, &rejected);
+    EXPECT_EQ(rejected, 0);
+    ASSERT_EQ(loaded.size(), corpus.size());
+    for (std::size_t i = 0; i < corpus.size(); ++i) EXPECT_EQ(replay(loaded[i]).hash(), replay(corpus[i]).hash());
+}
+
+// Every generator entry point (and move counts) against the reference per-piece generator, and
+// the tiered connectivity and pin checks against a plain BFS.
+TEST(Corpus, GeneratorsAgreeWithReference) {
+    for (Ruleset r : { Ruleset::Base, Ruleset::MLP }) {
+        for (const GameRecord& g : smallCorpus(r)) {
+            GameState s = replay(g);
+            const std::string where = formatRecord(g);
+
+            std::vector<Move> moves = generateMoves(s);
+            MoveList list;
+            generateMoves(s, list);
+            EXPECT_TRUE(std::equal(moves.begin(), moves.end(), list.begin(), list.end())) << where;
+            const std::vector<Move> direct = r == Ruleset::Base ? generateMovesFor<Ruleset::Base>(s) : generateMovesFor<Ruleset::MLP>(s);
+            EXPECT_EQ(direct, moves) << where;
+            EXPECT_EQ(countLegalMoves(s), static_cast<int>(moves.size())) << where;
+
+            std::set<std::pair<int, int>> nextToHive;
+            for (const auto& [pos, _] : s.board()) {
+                for (int i = 0; i < kHexDirCount; ++i) nextToHive.insert({ pos.q + dir(i).q, pos.r + dir(i).r });
+            }
+            const auto pinned = pinnedCells(s);
+            for (const auto& [pos, stack] : s.board()) {
+                const int pid = stack.back();
+                const bool lone = stack.size() == 1;
+                EXPECT_EQ(isPinned(s, pid), lone && !connectedWithout(s, pos)) << where;
+                if (lone) {
+                    EXPECT_EQ(pinned.count(pos) > 0, !connectedWithout(s, pos)) << where;
+                }
+
+                const std::vector<LegalMove> reference = legalMovesForPiece(s, pid);
+                LegalMoveList fast;
+                legalMovesForPiece(s, pid, fast);
+                EXPECT_TRUE(std::equal(reference.begin(), reference.end(), fast.begin(), fast.end(),
+                    [](const LegalMove& a, const LegalMove& b) { return pack(a) == pack(b); })) << where;
+                EXPECT_EQ(countLegalMovesForPiece(s, pid), static_cast<int>(reference.size())) << where;
+
+                // destinations keep one hive, and the side to move gets them all
+                // (except for a piece of its own just thrown, which is frozen)
+                const bool thrown = s.lastMove() && s.lastMove()->pieceId == pid;
+                const bool ownTurn = s.pieces()[pid].color == s.toMove() && s.queenId(s.toMove()) >= 0 && !thrown;
+                for (const LegalMove& m : reference) {
+                    GameState after = s;
+                    after.movePiece(pid, m.to);
+                    EXPECT_TRUE(connected(after)) << where;
+                    if (ownTurn) {
+                        EXPECT_NE(std::find(moves.begin(), moves.end(), toMove(m)), moves.end()) << where;
+                    }
+                }
+
+                // the tiered one-hive test on every cell next to the hive
+                for (const auto& [q, rr] : nextToHive) {
+                    const Axial to{ q, rr };
+                    if (to == pos) continue;
+                    GameState after = s;
+                    after.movePiece(pid, to);
+                    EXPECT_EQ(keepsHiveConnectedAfter(s, pid, to), connected(after))
+                        << where << " moving " << pos.q << "," << pos.r << " to " << q << "," << rr;
+                }
+            }
+
+            for (const Move& m : moves) { // play/undo restores the hash
+                const std::uint64_t h = s.hash();
+                s.play(m);
+                s.undo();
+                EXPECT_EQ(s.hash(), h) << where;
+            }
+        }
+    }
+}
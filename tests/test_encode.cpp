@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "encode.hpp"
+#include <algorithm>
+#include <vector>
+
+using namespace hive;
+
+static std::vector<GameState> playedPositions(Ruleset r, int plies) {
+    std::vector<GameState> out;
+    GameState s(r);
+    for (int ply = 0; ply < plies && evaluateGameOver(s) == GameOver::None; ++ply) {
+        out.push_back(s);
+        const auto moves = generateMoves(s);
+        s.play(moves.empty() ? Move::pass() : moves[(ply * 11 + 3) % moves.size()]);
+    }
+    return out;
+}
+
+static int at(const std::vector<float>& planes, int plane, Axial a, Axial center) {
+    const int col = a.q - center.q + kEncodeWindow / 2, row = a.r - center.r + kEncodeWindow / 2;
+    return static_cast<int>(planes[plane * kEncodeCells + row * kEncodeWindow + col]);
+}
+
+TEST(Encode, PlanesFollowTheSideToMoveAndIgnoreTranslation) {
+    std::vector<float> a(kEncodePlanes * kEncodeCells), b(a.size());
+    GameState s(Ruleset::MLP), shifted(Ruleset::MLP);
+    for (GameState* g : { &s, &shifted }) {
+        const Axial o = g == &s ? Axial{ 0, 0 } : Axial{ 5, -3 };
+        g->addDemoPiece(Bug::Queen, Color::White, add(o, { 0, 0 }));
+        g->addDemoPiece(Bug::Ant, Color::Black, add(o, { 1, 0 }));
+        g->addDemoPiece(Bug::Beetle, Color::Black, add(o, { 1, 0 })); // on the Ant
+        g->setToMove(Color::Black);
+    }
+    ASSERT_TRUE(encodePosition(s, a.data(), static_cast<float*>(nullptr)));
+    ASSERT_TRUE(encodePosition(shifted, b.data(), static_cast<float*>(nullptr)));
+    EXPECT_EQ(a, b);
+
+    const Axial c = encodeCenter(s);
+    EXPECT_EQ(at(a, piecePlane(Bug::Queen, false, 0), { 0, 0 }, c), 1); // white is "theirs"
+    EXPECT_EQ(at(a, piecePlane(Bug::Ant, true, 0), { 1, 0 }, c), 1);
+    EXPECT_EQ(at(a, piecePlane(Bug::Beetle, true, 1), { 1, 0 }, c), 1);
+    EXPECT_EQ(at(a, piecePlane(Bug::Beetle, true, 0), { 1, 0 }, c), 0);
+    EXPECT_EQ(at(a, handPlane(Bug::Ant, false), { 4, 4 }, c), 3);
+    EXPECT_EQ(at(a, handPlane(Bug::Ant, true), { -4, 2 }, c), 2);
+    EXPECT_EQ(at(a, handPlane(Bug::Queen, false), { 0, 0 }, c), 0);
+    float ones = 0;
+    for (int p = 0; p < kPiecePlanes; ++p) ones += std::count(a.begin() + p * kEncodeCells, a.begin() + (p + 1) * kEncodeCells, 1.0f);
+    EXPECT_EQ(ones, 3);
+}
+
+TEST(Encode, MaskMarksExactlyTheLegalMoves) {
+    for (Ruleset r : { Ruleset::Base, Ruleset::MLP }) {
+        for (const GameState& s : playedPositions(r, 60)) {
+            std::vector<std::int8_t> planes(kEncodePlanes * kEncodeCells), mask(kMaskPlanes * kEncodeCells);
+            ASSERT_TRUE(encodePosition(s, planes.data(), mask.data()));
+            const auto moves = generateMoves(s);
+            for (const Move& m : moves) {
+                const int i = moveIndex(s, m);
+                ASSERT_GE(i, 0);
+                EXPECT_EQ(mask[i], 1);
+            }
+            // distinct moves map to distinct cells, and nothing else is set
+            EXPECT_EQ(std::count(mask.begin(), mask.end(), 1), static_cast<long>(moves.size()));
+        }
+    }
+}
+
+TEST(Encode, BatchesMatchSinglePositionsOnEveryThreadCount) {
+    const auto states = playedPositions(Ruleset::MLP, 80);
+    const std::size_t n = states.size(), planeSize = kEncodePlanes * kEncodeCells, maskSize = kMaskPlanes * kEncodeCells;
+    std::vector<float> want(n * planeSize), wantMask(n * maskSize);
+    for (std::size_t i = 0; i < n; ++i) encodePosition(states[i], want.data() + i * planeSize, wantMask.data() + i * maskSize);
+
+    std::vector<PositionSnapshot> snaps;
+    for (const GameState& s : states) snaps.push_back(s.snapshot());
+    for (int threads : { 1, 3, 0 }) {
+        std::vector<float> got(want.size(), -1), gotMask(wantMask.size(), -1);
+        EXPECT_EQ(encodeBatch(states.data(), n, got.data(), gotMask.data(), threads), 0);
+        EXPECT_EQ(got, want);
+        EXPECT_EQ(gotMask, wantMask);
+
+        std::vector<std::int8_t> small(want.size(), -1), smallMask(wantMask.size(), -1);
+        EXPECT_EQ(encodeBatch(snaps.data(), n, small.data(), smallMask.data(), threads), 0);
+        EXPECT_TRUE(std::equal(small.begin(), small.end(), want.begin(), [](std::int8_t x, float y) { return x == y; }));
+        EXPECT_TRUE(std::equal(smallMask.begin(), smallMask.end(), wantMask.begin(), [](std::int8_t x, float y) { return x == y; }));
+    }
+}
+
+TEST(Encode, PiecesOutsideTheWindowAreReported) {
+    GameState s;
+    s.addDemoPiece(Bug::Ant, Color::White, { 0, 0 });
+    s.addDemoPiece(Bug::Ant, Color::Black, { kEncodeWindow, 0 });
+    std::vector<float> planes(kEncodePlanes * kEncodeCells);
+    EXPECT_FALSE(encodePosition(s, planes.data(), static_cast<float*>(nullptr)));
+    EXPECT_EQ(encodeBatch(&s, 1, planes.data(), static_cast<float*>(nullptr), 1), 1);
+}
+
+TEST(Encode, SetupPiecesBeyondTheHandHaveNoSlot) {
+    GameState s; // base: three Ants a side
+    s.addDemoPiece(Bug::Queen, Color::White, { 0, 0 });
+    s.addDemoPiece(Bug::Queen, Color::Black, { 1, 0 });
+    int ants[4];
+    for (int i = 0; i < 4; ++i) ants[i] = s.addDemoPiece(Bug::Ant, Color::Black, { 2 + i, 0 });
+    s.setToMove(Color::Black);
+    ASSERT_GE(ants[3], kColorCount * piecesPerColor(Ruleset::Base));
+
+    EXPECT_EQ(moveIndex(s, { ants[3], { 5, -1 }, false }), -1);
+    EXPECT_EQ(moveIndex(s, { ants[2], { 5, -1 }, false }) / static_cast<int>(kEncodeCells),
+        maskPlane(kHandOffset[bugIndex(Bug::Ant)] + 2, true));
+    std::vector<float> planes(kEncodePlanes * kEncodeCells), mask(kMaskPlanes * kEncodeCells);
+    EXPECT_FALSE(encodePosition(s, planes.data(), mask.data())); // the extra Ant can move
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include "engine.hpp"
+#include "rules.hpp"
+#include <random>
+#include <unordered_set>
 using namespace hive;
 
 TEST(Axial, PixelMappingDeterministic) {
@@ -15,4 +18,197 @@ TEST(GameState, AddAndStack) {
     int b = s.addDemoPiece(Bug::Beetle, Color::Black, { 0,0 }, 1);
     ASSERT_EQ(s.board().at({ 0,0 }).size(), 2u);
     (void)q; (void)b;
-}
\ No newline at end of file
+
+    // without a height a piece goes on top; an explicit 0 still slides under
+    int top = s.addDemoPiece(Bug::Beetle, Color::Black, { 0,0 });
+    int under = s.addDemoPiece(Bug::Beetle, Color::White, { 0,0 }, 0);
+    EXPECT_EQ(s.board().at({ 0,0 }).back(), top);
+    EXPECT_EQ(s.board().at({ 0,0 }).front(), under);
+    EXPECT_EQ(s.pieces()[top].height, 3);
+}
+
+TEST(GameState, HandCountsFollowPlacements) {
+    GameState s;
+    EXPECT_EQ(s.inHand(Color::White, Bug::Ant), 3);
+    EXPECT_EQ(s.placementsMade(Color::White), 0);
+    EXPECT_FALSE(s.queenPlaced(Color::White));
+
+    s.addDemoPiece(Bug::Ant, Color::White, { 0,0 });
+    int q = s.addDemoPiece(Bug::Queen, Color::White, { 1,0 });
+    EXPECT_EQ(s.inHand(Color::White, Bug::Ant), 2);
+    EXPECT_EQ(s.inHand(Color::White, Bug::Queen), 0);
+    EXPECT_EQ(s.placementsMade(Color::White), 2);
+    EXPECT_TRUE(s.queenPlaced(Color::White));
+    EXPECT_EQ(s.queenId(Color::White), q);
+    EXPECT_EQ(s.nextInHand(Color::White, Bug::Queen), -1);
+    EXPECT_EQ(s.placementsMade(Color::Black), 0);
+}
+
+TEST(GameState, PlayPassesTurn) {
+    GameState s;
+    EXPECT_EQ(s.toMove(), Color::White);
+    s.play({ s.nextInHand(Color::White, Bug::Spider), { 0,0 }, true });
+    EXPECT_EQ(s.toMove(), Color::Black);
+    EXPECT_EQ(s.ply(), 1);
+    int bq = s.nextInHand(Color::Black, Bug::Queen);
+    s.play({ bq, { 1,0 }, true });
+    EXPECT_EQ(s.toMove(), Color::White);
+    EXPECT_EQ(s.ply(), 2);
+    EXPECT_TRUE(s.queenPlaced(Color::Black));
+
+    // only the next piece of a kind can leave the hand
+    int secondSpider = s.nextInHand(Color::White, Bug::Spider);
+    EXPECT_THROW(s.play({ secondSpider - 1, { -1,0 }, true }), std::runtime_error);
+}
+
+TEST(GameState, RejectedPlayChangesNothing) {
+    GameState s;
+    const int spider = s.nextInHand(Color::White, Bug::Spider);
+    s.play({ spider, { 0,0 }, true });
+    const std::uint64_t hash = s.hash();
+    const Move last = *s.lastMove();
+
+    const int bq = s.nextInHand(Color::Black, Bug::Queen);
+    EXPECT_THROW(s.play({ bq, { 1,0 }, false }), std::runtime_error); // not on board yet
+    EXPECT_THROW(s.play({ spider, { 1,0 }, true }), std::runtime_error); // already placed
+    EXPECT_THROW(s.play({ static_cast<int>(s.pieces().size()), { 1,0 }, true }), std::runtime_error);
+    EXPECT_EQ(*s.lastMove(), last);
+    EXPECT_EQ(s.ply(), 1);
+    EXPECT_EQ(s.hash(), hash);
+
+    s.undo();
+    EXPECT_EQ(s.lastMove(), nullptr);
+    EXPECT_TRUE(s.board().empty());
+    EXPECT_EQ(s.nextInHand(Color::White, Bug::Spider), spider);
+}
+
+static void place(GameState& s, Bug b, Axial at) {
+    s.play({ s.nextInHand(s.toMove(), b), at, true });
+}
+
+TEST(GameState, HashIsPositional) {
+    GameState a, b;
+    place(a, Bug::Queen, { 0,0 }); place(a, Bug::Queen, { 1,0 });
+    place(a, Bug::Ant, { -1,0 });  place(a, Bug::Ant, { 2,0 });
+    place(a, Bug::Spider, { -1,1 }); place(a, Bug::Spider, { 2,-1 });
+
+    // same cells reached in another order
+    place(b, Bug::Queen, { 0,0 }); place(b, Bug::Queen, { 1,0 });
+    place(b, Bug::Spider, { -1,1 }); place(b, Bug::Spider, { 2,-1 });
+    place(b, Bug::Ant, { -1,0 });  place(b, Bug::Ant, { 2,0 });
+    EXPECT_EQ(a.hash(), b.hash());
+
+    const std::uint64_t h = a.hash();
+    for (const Move& m : generateMoves(a)) {
+        a.play(m);
+        EXPECT_NE(a.hash(), h) << moveToString(a, m);
+        a.undo();
+        EXPECT_EQ(a.hash(), h) << moveToString(a, m);
+    }
+}
+
+TEST(GameState, ThreefoldRepetitionDraws) {
+    GameState s;
+    place(s, Bug::Queen, { 0,0 }); place(s, Bug::Queen, { 1,0 });
+    int wa = s.nextInHand(Color::White, Bug::Ant);
+    place(s, Bug::Ant, { -1,0 });
+    int ba = s.nextInHand(Color::Black, Bug::Ant);
+    place(s, Bug::Ant, { 2,0 });
+    EXPECT_EQ(s.repetitions(), 0);
+
+    auto shuffle = [&] {
+        s.play({ wa, { -1,1 }, false }); s.play({ ba, { 2,-1 }, false });
+        s.play({ wa, { -1,0 }, false }); s.play({ ba, { 2,0 }, false });
+    };
+    shuffle();
+    EXPECT_EQ(s.repetitions(), 1);
+    EXPECT_EQ(evaluateGameOver(s), GameOver::None);
+    shuffle();
+    EXPECT_EQ(s.repetitions(), 2);
+    EXPECT_EQ(evaluateGameOver(s), GameOver::Draw);
+
+    s.undo();
+    s.play({ ba, { 2,0 }, false });
+    EXPECT_EQ(s.repetitions(), 2); // undo/redo keeps the count
+
+    // a placement starts a fresh window
+    place(s, Bug::Spider, { -2,0 });
+    EXPECT_EQ(s.repetitions(), 0);
+
+    // the ring grows with the game; counts carry across its growth and copies
+    for (int k = 1; k <= 80; ++k) {
+        shuffle();
+        ASSERT_EQ(s.repetitions(), k) << "ply " << s.ply();
+        if (k == 10) {
+            GameState copy = s;
+            for (int j = 0; j < 10; ++j) {
+                copy.play({ wa, { -1,1 }, false }); copy.play({ ba, { 2,-1 }, false });
+                copy.play({ wa, { -1,0 }, false }); copy.play({ ba, { 2,0 }, false });
+            }
+            EXPECT_EQ(copy.repetitions(), 20);
+        }
+    }
+}
+
+TEST(GameState, MoveLimitDraws) {
+    GameState s;
+    s.setMoveLimit(4);
+    place(s, Bug::Queen, { 0,0 }); place(s, Bug::Queen, { 1,0 });
+    place(s, Bug::Ant, { -1,0 });
+    EXPECT_EQ(evaluateGameOver(s), GameOver::None);
+    place(s, Bug::Ant, { 2,0 });
+    EXPECT_EQ(evaluateGameOver(s), GameOver::Draw);
+}
+
+// Adjacency counts and placeable cells, recomputed from the board.
+static void expectAdjacencyMatchesBoard(const GameState& s) {
+    std::unordered_set<std::int64_t> cells, placeable[kColorCount];
+    for (const auto& [pos, stack] : s.board()) {
+        for (int i = 0; i < 6; ++i) cells.insert((std::int64_t(add(pos, dir(i)).q) << 32) ^ std::uint32_t(add(pos, dir(i)).r));
+    }
+    for (std::int64_t key : cells) {
+        const Axial a{ int(key >> 32), int(std::int32_t(key & 0xffffffff)) };
+        int tops[kColorCount]{};
+        for (int i = 0; i < 6; ++i) {
+            auto it = s.board().find(add(a, dir(i)));
+            if (it != s.board().end()) ++tops[colorIndex(s.pieces()[it->second.back()].color)];
+        }
+        EXPECT_EQ(s.adjacentTops(a, Color::White), tops[0]);
+        EXPECT_EQ(s.adjacentTops(a, Color::Black), tops[1]);
+        if (s.board().count(a)) continue;
+        for (int c = 0; c < kColorCount; ++c) {
+            if (tops[c] > 0 && tops[1 - c] == 0) placeable[c].insert(key);
+        }
+    }
+    for (int c = 0; c < kColorCount; ++c) {
+        const auto& list = s.placeableCells(static_cast<Color>(c));
+        std::unordered_set<std::int64_t> got;
+        for (const Axial& a : list) got.insert((std::int64_t(a.q) << 32) ^ std::uint32_t(a.r));
+        EXPECT_EQ(got.size(), list.size()); // no duplicates
+        EXPECT_EQ(got, placeable[c]);
+    }
+}
+
+TEST(GameState, AdjacencyFollowsMovesClimbsAndUndo) {
+    for (std::uint32_t seed = 1; seed <= 6; ++seed) {
+        std::mt19937 rng(seed);
+        GameState s(seed % 2 ? Ruleset::MLP : Ruleset::Base);
+        for (int ply = 0; ply < 160 && evaluateGameOver(s) == GameOver::None; ++ply) {
+            auto moves = generateMoves(s);
+            if (moves.empty()) moves.push_back(Move::pass());
+            // every reply, taken back, must leave the counts as they were
+            for (std::size_t i = 0; i < moves.size(); i += 7) {
+                s.play(moves[i]);
+                expectAdjacencyMatchesBoard(s);
+                s.undo();
+            }
+            // prefer climbs, so stacks change hands often
+            std::vector<Move> climbs;
+            for (const Move& m : moves) {
+                if (!m.isPass() && !m.isPlacement && s.board().count(m.to)) climbs.push_back(m);
+            }
+            s.play(!climbs.empty() && rng() % 2 ? climbs[rng() % climbs.size()] : moves[rng() % moves.size()]);
+            expectAdjacencyMatchesBoard(s);
+        }
+    }
+}
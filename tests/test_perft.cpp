@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include "rules.hpp"
+
+using namespace hive;
+
+// Depths 1-3 are counted by hand: every opening placement, then (with the
+// queen down first) the two queen slides around the lone enemy piece.
+// Depth 4 pins the current generator against regressions.
+
+TEST(Perft, BaseOpening) {
+    GameState s;
+    EXPECT_EQ(perft(s, 1), 5u);
+    EXPECT_EQ(perft(s, 2), 150u);
+    EXPECT_EQ(perft(s, 3), 2220u);
+    EXPECT_EQ(perft(s, 4), 32856u);
+}
+
+TEST(Perft, ExpansionOpening) {
+    GameState s(Ruleset::MLP);
+    EXPECT_EQ(perft(s, 1), 8u);
+    EXPECT_EQ(perft(s, 2), 384u);
+    EXPECT_EQ(perft(s, 3), 8736u);
+    EXPECT_EQ(perft(s, 4), 198744u);
+}
+
+TEST(Perft, LeavesPositionUnchanged) {
+    GameState s(Ruleset::MLP);
+    s.play({ s.nextInHand(Color::White, Bug::Pillbug), { 0,0 }, true });
+    s.play({ s.nextInHand(Color::Black, Bug::Queen), { 1,0 }, true });
+    const auto before = s.board();
+    perft(s, 3);
+    EXPECT_EQ(s.board(), before);
+    EXPECT_EQ(s.ply(), 2);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "player.hpp"
+#include <algorithm>
+#include <cstdio>
+
+using namespace hive;
+
+static bool legal(const GameState& s, const Move& m) {
+    auto moves = generateMoves(s);
+    if (moves.empty()) moves.push_back(Move::pass());
+    return std::find(moves.begin(), moves.end(), m) != moves.end();
+}
+
+static GameState middlegame() {
+    GameState s;
+    for (const char* m : { "wQ@0,0", "bQ@1,0", "wA1@-1,0", "bA1@2,0", "wG1@-1,1", "bS1@3,-1" }) s.play(*parseMove(s, m));
+    return s;
+}
+
+static TimeControl clock(int ms) {
+    TimeControl tc;
+    tc.remainingMs = ms;
+    return tc;
+}
+
+TEST(Player, BookHitSkipsSearch) {
+    GameState s;
+    GameRecord rec;
+    for (int i = 0; i < 4; ++i) {
+        const Move m = generateMoves(s).front();
+        rec.moves.push_back(m);
+        s.play(m);
+    }
+    rec.result = GameOver::WhiteWins;
+    BookBuilder builder(Ruleset::Base);
+    for (int i = 0; i < 4; ++i) builder.add(rec);
+    const std::string path = ::testing::TempDir() + "hive_test_player.book";
+    ASSERT_TRUE(builder.write(path));
+    auto book = std::make_shared<OpeningBook>();
+    ASSERT_TRUE(book->load(path));
+    std::remove(path.c_str());
+
+    EnginePlayer player;
+    player.setBook(book, 2);
+    const auto d = player.go(GameState{}, clock(1000));
+    EXPECT_EQ(d.source, EnginePlayer::Source::Book);
+    EXPECT_EQ(d.move, rec.moves.front());
+    EXPECT_EQ(d.nodes, 0);
+}
+
+TEST(Player, PonderHitContinuesTheSearch) {
+    const GameState s = middlegame();
+    EnginePlayer player;
+    player.setMaxDepth(3);
+    const auto first = player.go(s, clock(5000));
+    EXPECT_EQ(first.source, EnginePlayer::Source::Search);
+    ASSERT_TRUE(legal(s, first.move));
+    ASSERT_TRUE(first.hasPonder);
+
+    GameState after = s;
+    after.play(first.move);
+    ASSERT_TRUE(player.startPonder(after, first.ponder));
+    EXPECT_TRUE(player.pondering());
+    after.play(first.ponder);
+    const auto hit = player.go(after, clock(5000));
+    EXPECT_EQ(hit.source, EnginePlayer::Source::PonderHit);
+    EXPECT_FALSE(player.pondering());
+    EXPECT_TRUE(legal(after, hit.move));
+    EXPECT_EQ(hit.depth, 3);
+}
+
+TEST(Player, PonderMissSearchesAfresh) {
+    const GameState s = middlegame();
+    EnginePlayer player;
+    player.setMaxDepth(2);
+    const auto first = player.go(s, clock(5000));
+    GameState after = s;
+    after.play(first.move);
+
+    auto replies = generateMoves(after);
+    ASSERT_GT(replies.size(), 1u);
+    const Move other = replies.front() == first.ponder ? replies[1] : replies.front();
+    ASSERT_TRUE(player.startPonder(after, first.ponder));
+    after.play(other);
+    const auto d = player.go(after, clock(5000));
+    EXPECT_EQ(d.source, EnginePlayer::Source::Search);
+    EXPECT_FALSE(player.pondering());
+    EXPECT_TRUE(legal(after, d.move));
+}
+
+TEST(Player, PonderRejectsIllegalReply) {
+    const GameState s = middlegame();
+    EnginePlayer player;
+    EXPECT_FALSE(player.startPonder(s, Move{ 0, { 9,9 }, false }));
+    EXPECT_FALSE(player.pondering());
+}
@@ -0,0 +1,23 @@
+#include <gtest/gtest.h>
+#include "profile.hpp"
+#include "rules.hpp"
+
+using namespace hive;
+
+// Runs in both builds: without HIVE_PROFILE nothing is recorded.
+TEST(Profile, AttributesMoveGenerationToZones) {
+    const profile::Snapshot before = profile::snapshot();
+    GameState s;
+    const std::uint64_t nodes = perft(s, 3);
+    const profile::Snapshot d = profile::snapshot() - before;
+
+    const auto& gen = d.zones[static_cast<int>(profile::Zone::GenerateMoves)];
+    if (!profile::kEnabled) {
+        EXPECT_EQ(gen.calls, 0u);
+        return;
+    }
+    // every interior node generates once (ply 2 by the bulk count): 1 root, 5 at ply 1, 150 at ply 2
+    EXPECT_EQ(gen.calls, 1u + 5u + 150u);
+    EXPECT_EQ(d.counters[static_cast<int>(profile::Counter::MovesGenerated)], 5u + 150u + nodes);
+    EXPECT_EQ(d.zones[static_cast<int>(profile::Zone::Placement)].calls, gen.calls);
+}
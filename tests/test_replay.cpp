@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "replay.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <utility>
+
+using namespace hive;
+
+static GameRecord randomGame(Ruleset r, std::uint32_t seed, int plies) {
+    std::mt19937 rng(seed);
+    GameState s(r);
+    GameRecord g{ r, GameOver::None, {} };
+    for (int i = 0; i < plies && evaluateGameOver(s) == GameOver::None; ++i) {
+        auto moves = generateMoves(s);
+        const Move m = moves.empty() ? Move::pass() : moves[rng() % moves.size()];
+        g.moves.push_back(m);
+        s.play(m);
+    }
+    return g;
+}
+
+static std::vector<std::string> sortedMoves(const GameState& s) {
+    std::vector<std::string> out;
+    for (const Move& m : generateMoves(s)) out.push_back(moveToString(s, m));
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+static void expectSamePosition(const GameState& a, const GameState& b) {
+    EXPECT_EQ(a.hash(), b.hash());
+    EXPECT_EQ(a.ply(), b.ply());
+    EXPECT_EQ(a.toMove(), b.toMove());
+    ASSERT_EQ(a.pieces().size(), b.pieces().size());
+    for (std::size_t i = 0; i < a.pieces().size(); ++i) {
+        EXPECT_EQ(a.pieces()[i].onBoard, b.pieces()[i].onBoard);
+        if (a.pieces()[i].onBoard) {
+            EXPECT_EQ(a.pieces()[i].pos, b.pieces()[i].pos);
+            EXPECT_EQ(a.pieces()[i].height, b.pieces()[i].height);
+        }
+    }
+    for (int c = 0; c < kColorCount; ++c) {
+        for (int bug = 0; bug < kBugCount; ++bug) {
+            EXPECT_EQ(a.inHand(static_cast<Color>(c), static_cast<Bug>(bug)), b.inHand(static_cast<Color>(c), static_cast<Bug>(bug)));
+        }
+        EXPECT_EQ(a.queenId(static_cast<Color>(c)), b.queenId(static_cast<Color>(c)));
+    }
+    EXPECT_EQ(sortedMoves(a), sortedMoves(b)); // board iteration order depends on history
+}
+
+TEST(Replay, SnapshotRestoresStacksHandsAndTurn) {
+    for (std::uint32_t seed = 1; seed <= 20; ++seed) {
+        const GameRecord g = randomGame(seed % 2 ? Ruleset::MLP : Ruleset::Base, seed, 120);
+        GameState s(g.ruleset);
+        for (const Move& m : g.moves) {
+            s.play(m);
+            GameState r;
+            r.restore(s.snapshot());
+            expectSamePosition(s, r);
+            ASSERT_NE(r.lastMove(), nullptr);
+            EXPECT_EQ(*r.lastMove(), m);
+            // the last move is kept (the rules freeze a thrown piece), and undoes
+            GameState before = s;
+            before.undo();
+            r.undo();
+            EXPECT_EQ(r.hash(), before.hash());
+            EXPECT_EQ(r.ply(), before.ply());
+            EXPECT_EQ(r.lastMove(), nullptr);
+        }
+    }
+}
+
+// Queens and Ants down, then the Ants shuffle back and forth: a threefold draw at ply 12.
+static GameRecord shuffleGame() {
+    GameState s;
+    GameRecord g{ Ruleset::Base, GameOver::Draw, {} };
+    auto play = [&](Move m) { g.moves.push_back(m); s.play(m); };
+    play({ s.nextInHand(Color::White, Bug::Queen), { 0,0 }, true });
+    play({ s.nextInHand(Color::Black, Bug::Queen), { 1,0 }, true });
+    const int wa = s.nextInHand(Color::White, Bug::Ant);
+    play({ wa, { -1,0 }, true });
+    const int ba = s.nextInHand(Color::Black, Bug::Ant);
+    play({ ba, { 2,0 }, true });
+    for (int i = 0; i < 2; ++i) {
+        play({ wa, { -1,1 }, false }); play({ ba, { 2,-1 }, false });
+        play({ wa, { -1,0 }, false }); play({ ba, { 2,0 }, false });
+    }
+    return g;
+}
+
+TEST(Replay, SeekAgreesWithPlayingThrough) {
+    for (const auto& [g, every] : { std::pair{ randomGame(Ruleset::MLP, 7, 150), 8 }, std::pair{ shuffleGame(), 4 } }) {
+        const GameReplay replay(g, every);
+        EXPECT_EQ(replay.keyframes(), static_cast<std::size_t>(replay.length() / every + 1));
+
+        std::vector<GameState> line{ GameState(g.ruleset) };
+        for (const Move& m : g.moves) {
+            line.push_back(line.back());
+            line.back().play(m);
+        }
+        // the position, and the repetitions the rules see in it
+        auto expectSame = [&](const GameState& s) {
+            expectSamePosition(s, line[s.ply()]);
+            EXPECT_EQ(s.repetitions(), line[s.ply()].repetitions()) << "ply " << s.ply();
+            EXPECT_EQ(evaluateGameOver(s), evaluateGameOver(line[s.ply()])) << "ply " << s.ply();
+        };
+        GameState s(g.ruleset);
+        std::mt19937 rng(3);
+        for (int i = 0; i < 60; ++i) {
+            replay.seek(s, static_cast<int>(rng() % (line.size())));
+            expectSame(s);
+        }
+        // stepping back across keyframes, then forward to the end
+        replay.seek(s, replay.length());
+        expectSame(s);
+        while (replay.back(s)) expectSame(s);
+        EXPECT_EQ(s.ply(), 0);
+        while (replay.forward(s)) expectSame(s);
+        EXPECT_EQ(s.ply(), replay.length());
+        if (g.result == GameOver::Draw) EXPECT_EQ(evaluateGameOver(s), GameOver::Draw); // the shuffle's threefold
+    }
+}
+
+TEST(Replay, ArchiveIndexesOnDemand) {
+    const std::string path = ::testing::TempDir() + "hive_test_replay.txt";
+    std::vector<GameRecord> games;
+    {
+        std::ofstream out(path);
+        out << "# archive\n\n";
+        for (std::uint32_t seed = 1; seed <= 5; ++seed) {
+            games.push_back(randomGame(Ruleset::Base, seed, 40));
+            out << formatRecord(games.back()) << "\n";
+            if (seed == 2) out << "base * not-a-move\n";
+        }
+    }
+    RecordArchive archive;
+    ASSERT_TRUE(archive.open(path));
+    auto first = archive.get(0);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(formatRecord(*first), formatRecord(games[0]));
+    EXPECT_EQ(archive.indexed(), 1u);
+    EXPECT_FALSE(archive.complete());
+
+    auto third = archive.get(2); // past the malformed line
+    ASSERT_TRUE(third.has_value());
+    EXPECT_EQ(formatRecord(*third), formatRecord(games[2]));
+    EXPECT_EQ(formatRecord(*archive.get(1)), formatRecord(games[1])); // back again
+    EXPECT_FALSE(archive.get(5).has_value());
+    EXPECT_TRUE(archive.complete());
+    EXPECT_EQ(archive.indexed(), 5u);
+    EXPECT_EQ(formatRecord(*archive.get(4)), formatRecord(games[4]));
+    std::remove(path.c_str());
+}
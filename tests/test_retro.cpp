@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "retro.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <set>
+
+using namespace hive;
+
+TEST(Retro, VariantParse) {
+    auto v = RetroVariant::parse("QSA");
+    ASSERT_TRUE(v.has_value());
+    EXPECT_EQ(v->pieces(), 6);
+    EXPECT_EQ(v->name(), "QSA");
+
+    auto w = RetroVariant::parse("QGGG/QGG");
+    ASSERT_TRUE(w.has_value());
+    EXPECT_EQ(w->pieces(), 7);
+    EXPECT_EQ(w->name(), "QGGG/QGG");
+
+    EXPECT_FALSE(RetroVariant::parse("SA").has_value());    // no Queen
+    EXPECT_FALSE(RetroVariant::parse("QQ").has_value());    // two Queens
+    EXPECT_FALSE(RetroVariant::parse("QM").has_value());    // expansion bug
+    EXPECT_FALSE(RetroVariant::parse("Q/Q/Q").has_value());
+}
+
+TEST(Retro, VariantStartLimitsHands) {
+    const GameState s = variantStart(*RetroVariant::parse("QSAG/QA"));
+    EXPECT_EQ(s.inHand(Color::White, Bug::Spider), 1);
+    EXPECT_EQ(s.inHand(Color::White, Bug::Beetle), 0);
+    EXPECT_EQ(s.inHand(Color::Black, Bug::Grasshopper), 0);
+    EXPECT_EQ(s.nextInHand(Color::Black, Bug::Spider), -1);
+    EXPECT_NE(s.nextInHand(Color::Black, Bug::Ant), -1);
+    for (const Move& m : generateMoves(s)) {
+        const Bug b = s.pieces()[m.pieceId].bug;
+        EXPECT_TRUE(b == Bug::Queen || b == Bug::Spider || b == Bug::Ant || b == Bug::Grasshopper);
+    }
+
+    GameState t;
+    t.play(*parseMove(t, "wA1@0,0"));
+    EXPECT_THROW(t.limitHand(Color::White, Bug::Ant, 1), std::runtime_error);
+    EXPECT_NO_THROW(t.limitHand(Color::White, Bug::Spider, 1));
+}
+
+// Unmoves invert moves: along random games every parent is among the child's
+// predecessors, and every reported predecessor has a move back to the child.
+TEST(Retro, PredecessorsInvertMoves) {
+    const RetroVariant v = *RetroVariant::parse("QGG/QGGG");
+    std::mt19937 rng(3);
+    int checked = 0;
+    for (int game = 0; game < 6; ++game) {
+        GameState s = variantStart(v);
+        for (int ply = 0; ply < 30 && evaluateGameOver(s) == GameOver::None; ++ply) {
+            auto moves = generateMoves(s);
+            if (moves.empty()) moves.push_back(Move::pass());
+            const Move m = moves[rng() % moves.size()];
+            const std::uint64_t parent = canonicalHash(s);
+            s.play(m);
+
+            std::set<std::uint64_t> preds;
+            forEachPredecessor(v, s, [&](const GameState& p) {
+                EXPECT_NE(p.toMove(), s.toMove());
+                preds.insert(canonicalHash(p));
+                if (checked % 4 != 0) return; // the reverse check is the slow half
+                GameState q = p;
+                auto back = generateMoves(q);
+                if (back.empty()) back.push_back(Move::pass());
+                const bool reaches = std::any_of(back.begin(), back.end(), [&](const Move& b) {
+                    q.play(b);
+                    const bool same = canonicalHash(q) == canonicalHash(s);
+                    q.undo();
+                    return same;
+                });
+                EXPECT_TRUE(reaches) << "game " << game << " ply " << ply;
+            });
+            EXPECT_TRUE(preds.count(parent)) << "game " << game << " ply " << ply;
+            ++checked;
+        }
+    }
+    EXPECT_GT(checked, 100);
+}
+
+// QA is far too small to surround a queen: every position is a draw.
+TEST(Retro, BuildsAndLoadsTable) {
+    const RetroVariant v = *RetroVariant::parse("QA");
+    const std::string path = ::testing::TempDir() + "hive_test_qa.retro";
+    const auto stats = buildRetroTable(v, path, 2);
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_GT(stats->positions, 100u);
+    EXPECT_EQ(stats->draws, stats->positions);
+    EXPECT_EQ(stats->wins + stats->losses, 0u);
+
+    RetroTable table;
+    ASSERT_TRUE(table.load(path));
+    EXPECT_EQ(table.size(), stats->positions);
+    EXPECT_EQ(table.variant().name(), "QA");
+
+    std::mt19937 rng(5);
+    for (int game = 0; game < 20; ++game) {
+        GameState s = variantStart(v);
+        for (int ply = 0; ply < 40; ++ply) {
+            const auto r = table.find(s);
+            ASSERT_TRUE(r.has_value()) << "game " << game << " ply " << ply;
+            EXPECT_EQ(r->value, RetroValue::Draw);
+            auto moves = generateMoves(s);
+            s.play(moves.empty() ? Move::pass() : moves[rng() % moves.size()]);
+        }
+    }
+    GameState full; // the full base game has positions outside any small table
+    for (const char* m : { "wB1@0,0", "bB1@1,0" }) full.play(*parseMove(full, m));
+    EXPECT_FALSE(table.find(full).has_value());
+
+    { // a truncated file is rejected
+        std::ifstream in(path, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 2));
+    }
+    RetroTable broken;
+    EXPECT_FALSE(broken.load(path));
+    std::remove(path.c_str());
+}
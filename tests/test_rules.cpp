@@ -123,6 +123,29 @@ TEST(Rules, SpiderExactlyThreeSteps) {
     }
 }
 
+TEST(Rules, SpiderReportsEachDestinationOnce) {
+    GameState s;
+    int sp = s.addDemoPiece(Bug::Spider, Color::White, { 0,0 });
+    s.addDemoPiece(Bug::Queen, Color::Black, { -1,0 });
+
+    // both ways round the Queen end on its far side
+    auto moves = legalMovesForPiece(s, sp);
+    ASSERT_EQ(moves.size(), 1u);
+    EXPECT_EQ(moves[0].to.q, -2);
+    EXPECT_EQ(moves[0].to.r, 0);
+}
+
+TEST(Rules, MoveNotation) {
+    GameState s;
+    const int q = s.nextInHand(Color::White, Bug::Queen);
+    s.play({ q, { 0,0 }, true });
+    const int a2 = s.nextInHand(Color::Black, Bug::Ant) + 1; // second black Ant
+    EXPECT_EQ(pieceName(s, q), "wQ");
+    EXPECT_EQ(pieceName(s, a2), "bA2");
+    EXPECT_EQ(moveToString(s, { q, { -1,2 }, false }), "wQ@-1,2");
+    EXPECT_EQ(moveToString(s, Move::pass()), "pass");
+}
+
 TEST(Rules, BeetleClimbsOntoOccupiedNeighbor) {
     GameState s;
     int b = s.addDemoPiece(Bug::Beetle, Color::White, { 0,0 });
@@ -143,6 +166,7 @@ TEST(Rules, BeetleIgnoresCorridorWhenOnTop) {
     // Create a stack at {0,0}: Queen (bottom) then Beetle (top)
     s.addDemoPiece(Bug::Queen, Color::White, { 0,0 });
     int b = s.addDemoPiece(Bug::Beetle, Color::White, { 0,0 }); // now on top
+    ASSERT_EQ(s.board().at({ 0,0 }).back(), b);
 
     // Block the corridor from {0,0} -> {1,0} by occupying the two side neighbors:
     // for dir(0) = (1,0), its "left" and "right" from {0,0} are {0,1} and {1,-1}
@@ -162,3 +186,235 @@ TEST(Rules, BeetleIgnoresCorridorWhenOnTop) {
 }
 
 
+
+TEST(Rules, OpeningPlacements) {
+    GameState s;
+    auto first = generateMoves(s);
+    ASSERT_EQ(first.size(), 5u); // one per bug kind, all at the origin
+    for (auto& m : first) {
+        EXPECT_TRUE(m.isPlacement);
+        EXPECT_EQ(m.to, (Axial{ 0,0 }));
+    }
+
+    s.play(first.front());
+    EXPECT_EQ(generateMoves(s).size(), 5u * 6u); // second piece: any neighbor of the hive
+}
+
+TEST(Rules, QueenByFourthPlacement) {
+    GameState s;
+    s.play({ s.nextInHand(Color::White, Bug::Ant), { 0,0 }, true });
+    s.play({ s.nextInHand(Color::Black, Bug::Ant), { 1,0 }, true });
+    s.play({ s.nextInHand(Color::White, Bug::Ant), { -1,0 }, true });
+    s.play({ s.nextInHand(Color::Black, Bug::Ant), { 2,0 }, true });
+    s.play({ s.nextInHand(Color::White, Bug::Spider), { -2,0 }, true });
+    s.play({ s.nextInHand(Color::Black, Bug::Spider), { 3,0 }, true });
+
+    auto moves = generateMoves(s);
+    ASSERT_FALSE(moves.empty());
+    for (auto& m : moves) {
+        EXPECT_TRUE(m.isPlacement);
+        EXPECT_EQ(s.pieces()[m.pieceId].bug, Bug::Queen);
+    }
+}
+
+TEST(Rules, PinnedPieceCannotMove) {
+    GameState s;
+    s.addDemoPiece(Bug::Queen, Color::White, { -1,0 });
+    int mid = s.addDemoPiece(Bug::Ant, Color::White, { 0,0 });
+    s.addDemoPiece(Bug::Queen, Color::Black, { 1,0 });
+
+    EXPECT_TRUE(isPinned(s, mid));
+    EXPECT_TRUE(legalMovesForPiece(s, mid).empty());
+    auto pinned = pinnedCells(s);
+    EXPECT_EQ(pinned.size(), 1u);
+    EXPECT_TRUE(pinned.count({ 0,0 }));
+}
+
+// Ring of the given radius around the origin, origin left empty.
+static GameState hexRing(int radius) {
+    GameState s;
+    Axial a{ -radius, radius }; // dir(4) * radius
+    for (int side = 0; side < kHexDirCount; ++side) {
+        for (int k = 0; k < radius; ++k) {
+            s.addDemoPiece(Bug::Ant, Color::White, a);
+            a = add(a, dir(side));
+        }
+    }
+    return s;
+}
+
+TEST(Rules, ConnectivityTiers) {
+    ConnectivityTier tier{};
+
+    // a Beetle leaving a stack only has to land next to the hive
+    GameState stack;
+    stack.addDemoPiece(Bug::Queen, Color::White, { 0,0 });
+    int beetle = stack.addDemoPiece(Bug::Beetle, Color::White, { 0,0 });
+    EXPECT_TRUE(keepsHiveConnectedAfter(stack, beetle, { 1,0 }, &tier));
+    EXPECT_EQ(tier, ConnectivityTier::StackTop);
+    EXPECT_FALSE(keepsHiveConnectedAfter(stack, beetle, { 2,0 }, &tier));
+    EXPECT_EQ(tier, ConnectivityTier::StackTop);
+
+    // end of a line: one run of neighbors
+    GameState line;
+    line.addDemoPiece(Bug::Queen, Color::White, { 0,0 });
+    line.addDemoPiece(Bug::Queen, Color::Black, { 1,0 });
+    int end = line.addDemoPiece(Bug::Ant, Color::White, { 2,0 });
+    EXPECT_TRUE(keepsHiveConnectedAfter(line, end, { -1,0 }, &tier));
+    EXPECT_EQ(tier, ConnectivityTier::Ring);
+
+    // small ring: both neighbors of a ring cell meet around the short way
+    GameState ring = hexRing(1);
+    int cell = ring.board().at({ 1,0 }).back();
+    EXPECT_TRUE(keepsHiveConnectedAfter(ring, cell, { 2,-1 }, &tier));
+    EXPECT_EQ(tier, ConnectivityTier::Bounded);
+    EXPECT_FALSE(isPinned(ring, cell));
+
+    // middle of a bent line: the split is proven locally...
+    GameState bent;
+    bent.addDemoPiece(Bug::Queen, Color::White, { 0,0 });
+    int mid = bent.addDemoPiece(Bug::Queen, Color::Black, { 1,0 });
+    bent.addDemoPiece(Bug::Ant, Color::White, { 1,1 });
+    EXPECT_FALSE(keepsHiveConnectedAfter(bent, mid, { 1,-1 }, &tier));
+    EXPECT_EQ(tier, ConnectivityTier::Bounded);
+    // ...unless it lands where it bridges both ends
+    EXPECT_TRUE(keepsHiveConnectedAfter(bent, mid, { 0,1 }, &tier));
+
+    // large ring: the way around leaves the local radius
+    GameState big = hexRing(4);
+    cell = big.board().at({ 4,0 }).back();
+    EXPECT_TRUE(keepsHiveConnectedAfter(big, cell, { 5,-1 }, &tier));
+    EXPECT_EQ(tier, ConnectivityTier::Full);
+    EXPECT_FALSE(isPinned(big, cell));
+}
+
+TEST(Rules, UndoRestoresPosition) {
+    GameState s;
+    s.play({ s.nextInHand(Color::White, Bug::Queen), { 0,0 }, true });
+    s.play({ s.nextInHand(Color::Black, Bug::Queen), { 1,0 }, true });
+    s.play({ s.nextInHand(Color::White, Bug::Beetle), { -1,0 }, true });
+    s.play({ s.nextInHand(Color::Black, Bug::Beetle), { 2,0 }, true });
+
+    const auto before = s.board();
+    auto moves = generateMoves(s);
+    for (auto& m : moves) {
+        s.play(m);
+        s.undo();
+        EXPECT_EQ(s.board(), before) << moveToString(s, m);
+        EXPECT_EQ(s.toMove(), Color::White);
+        EXPECT_EQ(s.inHand(Color::White, Bug::Beetle), 1);
+        EXPECT_TRUE(s.queenPlaced(Color::White));
+    }
+}
+
+TEST(Rules, LadybugTwoUpOneDown) {
+    GameState s(Ruleset::MLP);
+    int lb = s.addDemoPiece(Bug::Ladybug, Color::White, { 0,0 });
+    s.addDemoPiece(Bug::Queen, Color::White, { 1,0 });
+    s.addDemoPiece(Bug::Queen, Color::Black, { 2,0 });
+
+    // up onto (1,0), over onto (2,0), down into any empty neighbor of (2,0)
+    auto moves = legalMovesForPiece(s, lb);
+    EXPECT_EQ(moves.size(), 5u);
+    for (auto& m : moves) {
+        EXPECT_FALSE(occupied(s, m.to));
+        EXPECT_NE(m.to, (Axial{ 0,0 }));
+    }
+}
+
+TEST(Rules, MosquitoCopiesNeighbors) {
+    GameState s(Ruleset::MLP);
+    int mq = s.addDemoPiece(Bug::Mosquito, Color::White, { 0,0 });
+    s.addDemoPiece(Bug::Grasshopper, Color::White, { 1,0 });
+    s.addDemoPiece(Bug::Queen, Color::Black, { 2,0 });
+
+    // only a Grasshopper touches it: a single jump over the line
+    auto moves = legalMovesForPiece(s, mq);
+    ASSERT_EQ(moves.size(), 1u);
+    EXPECT_EQ(moves[0].to, (Axial{ 3,0 }));
+
+    // on top of the hive it is a Beetle
+    s.movePiece(mq, { 1,0 });
+    bool climbs = false;
+    for (auto& m : legalMovesForPiece(s, mq)) climbs |= m.kind == MoveKind::Climb;
+    EXPECT_TRUE(climbs);
+}
+
+TEST(Rules, PillbugThrowsAllButLastMoved) {
+    GameState s(Ruleset::MLP);
+    int pb = s.addDemoPiece(Bug::Pillbug, Color::White, { 0,0 });
+    s.addDemoPiece(Bug::Queen, Color::White, { -1,0 });
+    int bq = s.addDemoPiece(Bug::Queen, Color::Black, { 1,0 });
+    int ant = s.addDemoPiece(Bug::Ant, Color::Black, { 1,1 });
+    s.play(Move::pass());
+    s.play({ ant, { 0,1 }, false }); // black just moved the ant next to the Pillbug
+
+    auto throws = pillbugThrows(s, pb);
+    EXPECT_EQ(throws.size(), 6u); // both queens, 3 empty cells each
+    for (auto& t : throws) {
+        EXPECT_NE(t.pieceId, ant);
+        EXPECT_EQ(t.kind, MoveKind::Throw);
+    }
+
+    const Move toss{ bq, { 0,-1 }, false };
+    auto moves = generateMoves(s);
+    ASSERT_NE(std::find(moves.begin(), moves.end(), toss), moves.end());
+
+    // the thrown queen may not move on black's next turn
+    s.play(toss);
+    for (auto& m : generateMoves(s)) EXPECT_NE(m.pieceId, bq);
+}
+
+TEST(Rules, CountsMatchGeneratedMovesWithThrows) {
+    // white's Pillbug can throw its own Ant to cells the Ant also reaches by itself
+    GameState s(Ruleset::MLP);
+    int pb = s.addDemoPiece(Bug::Pillbug, Color::White, { 0,0 });
+    s.addDemoPiece(Bug::Queen, Color::White, { -1,0 });
+    int ant = s.addDemoPiece(Bug::Ant, Color::White, { 0,-1 });
+    s.addDemoPiece(Bug::Queen, Color::Black, { 1,0 });
+    s.addDemoPiece(Bug::Mosquito, Color::Black, { 1,1 });
+    EXPECT_FALSE(pillbugThrows(s, pb).empty());
+    EXPECT_EQ(countLegalMoves(s), static_cast<int>(generateMoves(s).size()));
+    EXPECT_EQ(countLegalMovesForPiece(s, ant), static_cast<int>(legalMovesForPiece(s, ant).size()));
+    EXPECT_EQ(countLegalMovesForPiece(s, pb), static_cast<int>(legalMovesForPiece(s, pb).size()));
+
+    // and along games that throw whenever they can
+    for (int game = 0; game < 4; ++game) {
+        GameState g(Ruleset::MLP);
+        for (int ply = 0; ply < 120 && evaluateGameOver(g) == GameOver::None; ++ply) {
+            const auto moves = generateMoves(g);
+            ASSERT_EQ(countLegalMoves(g), static_cast<int>(moves.size())) << "game " << game << " ply " << ply;
+            if (moves.empty()) { g.play(Move::pass()); continue; }
+            auto thrown = std::find_if(moves.begin(), moves.end(), [&](const Move& m) {
+                return !m.isPlacement && g.pieces()[m.pieceId].color != g.toMove();
+            });
+            g.play(thrown != moves.end() && ply % 3 ? *thrown : moves[(ply * 7 + game * 13) % moves.size()]);
+        }
+    }
+}
+
+static_assert(unpackMove(pack(Move{ 27, { -5, 12 }, true })) == Move{ 27, { -5, 12 }, true });
+static_assert(pack(Move::pass()).isPass() && unpackMove(PackedMove{}).isPass());
+
+TEST(Rules, PackedMovesRoundTrip) {
+    GameState s(Ruleset::MLP);
+    for (int ply = 0; ply < 40 && evaluateGameOver(s) == GameOver::None; ++ply) {
+        for (const Move& m : generateMoves(s)) {
+            EXPECT_EQ(unpackMove(pack(m)), m);
+        }
+        for (const Piece& p : s.pieces()) {
+            if (!p.onBoard) continue;
+            for (const LegalMove& lm : legalMovesForPiece(s, p.id)) {
+                const PackedMove pm = pack(lm);
+                const LegalMove back = unpackLegalMove(pm);
+                EXPECT_EQ(back.pieceId, lm.pieceId);
+                EXPECT_EQ(back.to, lm.to);
+                EXPECT_EQ(back.kind, lm.kind);
+                EXPECT_EQ(back.steps, lm.steps);
+                EXPECT_EQ(pm, pack(toMove(lm))); // kind and steps do not change the identity
+            }
+        }
+        const auto moves = generateMoves(s);
+        s.play(moves.empty() ? Move::pass() : moves[(ply * 5) % moves.size()]);
+    }
+}
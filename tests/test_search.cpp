@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include "search.hpp"
+#include "game_record.hpp"
+#include <thread>
+
+using namespace hive;
+
+// Black queen at the origin with one open neighbor (0,1) that the white ant can reach.
+static GameState surroundInOne() {
+    GameState s;
+    s.addDemoPiece(Bug::Queen, Color::Black, { 0,0 });
+    s.addDemoPiece(Bug::Queen, Color::White, { 1,0 });
+    s.addDemoPiece(Bug::Grasshopper, Color::White, { 1,-1 });
+    s.addDemoPiece(Bug::Ant, Color::Black, { 0,-1 });
+    s.addDemoPiece(Bug::Spider, Color::Black, { -1,0 });
+    s.addDemoPiece(Bug::Beetle, Color::White, { -1,1 });
+    s.addDemoPiece(Bug::Ant, Color::White, { 2,0 });
+    return s;
+}
+
+TEST(Search, FindsSurroundInOne) {
+    GameState s = surroundInOne();
+    Searcher searcher;
+    SearchLimits limits;
+    limits.maxDepth = 2;
+    auto r = searcher.search(s, limits);
+    EXPECT_GE(r.score, kWinThreshold);
+    EXPECT_EQ(r.best.to, (Axial{ 0,1 }));
+    EXPECT_EQ(s.pieces()[r.best.pieceId].bug, Bug::Ant);
+}
+
+TEST(Search, StreamsInfoPerIteration) {
+    GameState s;
+    Searcher searcher;
+    SearchLimits limits;
+    limits.maxDepth = 2;
+    std::vector<int> depths;
+    searcher.search(s, limits, [&](const SearchInfo& info) { depths.push_back(info.depth); });
+    EXPECT_EQ(depths, (std::vector<int>{ 1, 2 }));
+}
+
+TEST(Search, StoppedSearchStillReturnsLegalMove) {
+    GameState s = surroundInOne();
+    Searcher searcher;
+    searcher.stop();
+    auto r = searcher.search(s, SearchLimits{});
+    auto moves = generateMoves(s);
+    EXPECT_NE(std::find(moves.begin(), moves.end(), r.best), moves.end());
+}
+
+TEST(Search, MultiPvScoresEveryRestrictedMove) {
+    GameState s = surroundInOne();
+    const int antId = s.board().at({ 2,0 }).back();
+    std::vector<Move> antMoves;
+    for (const Move& m : generateMoves(s)) {
+        if (!m.isPlacement && m.pieceId == antId) antMoves.push_back(m);
+    }
+    ASSERT_GT(antMoves.size(), 2u);
+
+    Searcher searcher;
+    SearchLimits limits;
+    limits.maxDepth = 2;
+    limits.searchMoves = antMoves;
+    limits.multiPv = (int)antMoves.size();
+    std::vector<SearchInfo> last;
+    searcher.search(s, limits, [&](const SearchInfo& info) {
+        if (info.multiPv == 1) last.clear();
+        last.push_back(info);
+    });
+    ASSERT_EQ(last.size(), antMoves.size());
+    EXPECT_EQ(last.front().pv.front().to, (Axial{ 0,1 }));
+    for (size_t i = 0; i < last.size(); ++i) {
+        if (i > 0) {
+            EXPECT_GE(last[i - 1].score, last[i].score);
+        }
+        // each line's score matches a search restricted to that move alone
+        SearchLimits single;
+        single.maxDepth = 2;
+        single.searchMoves = { last[i].pv.front() };
+        EXPECT_EQ(searcher.search(s, single).score, last[i].score);
+    }
+}
+
+TEST(Search, TranspositionTableRoundTrip) {
+    TranspositionTable tt(1000); // rounded down to 512
+    EXPECT_EQ(tt.size(), 512u);
+    TranspositionTable::Hit hit;
+    EXPECT_FALSE(tt.probe(42, hit));
+
+    const Move m{ 3, { -2, 5 }, false };
+    tt.store(42, 6, -kWinScore + 7, TranspositionTable::Bound::Lower, pack(m));
+    ASSERT_TRUE(tt.probe(42, hit));
+    EXPECT_EQ(hit.score, -kWinScore + 7);
+    EXPECT_EQ(hit.depth, 6);
+    EXPECT_EQ(hit.bound, TranspositionTable::Bound::Lower);
+    EXPECT_EQ(unpackMove(hit.move), m);
+    EXPECT_FALSE(tt.probe(42 + 512, hit)); // same slot, other key
+
+    // a shallower result for another key keeps the deeper one of this search...
+    tt.store(42 + 512, 2, 10, TranspositionTable::Bound::Exact, pack(Move::pass()));
+    EXPECT_TRUE(tt.probe(42, hit));
+    // ...but not one left from an earlier search
+    tt.newSearch();
+    tt.store(42 + 512, 2, 10, TranspositionTable::Bound::Exact, pack(Move::pass()));
+    EXPECT_FALSE(tt.probe(42, hit));
+    ASSERT_TRUE(tt.probe(42 + 512, hit));
+    EXPECT_TRUE(hit.move.isPass());
+    tt.clear();
+    EXPECT_FALSE(tt.probe(42 + 512, hit));
+}
+
+TEST(Search, WarmTableSavesNodes) {
+    GameState s;
+    for (const char* m : { "wQ@0,0", "bQ@1,0", "wA1@-1,0", "bA1@2,0", "wG1@-1,1", "bS1@3,-1" }) s.play(*parseMove(s, m));
+    auto table = std::make_shared<TranspositionTable>();
+    Searcher searcher;
+    searcher.setTable(table);
+    SearchLimits limits;
+    limits.maxDepth = 3;
+    const SearchResult cold = searcher.search(s, limits);
+    const SearchResult warm = searcher.search(s, limits);
+    EXPECT_EQ(warm.score, cold.score);
+    EXPECT_LT(warm.nodes, cold.nodes);
+
+    Searcher other; // a fresh searcher sharing the warm table
+    other.setTable(table);
+    EXPECT_LT(other.search(s, limits).nodes, cold.nodes);
+}
+
+// The same board hashes alike in both rulesets: a shared table must not let
+// a Base search answer an MLP one.
+TEST(Search, TableIsKeptApartPerRuleset) {
+    GameState base(Ruleset::Base), mlp(Ruleset::MLP);
+    for (const char* m : { "wQ@0,0", "bQ@1,0", "wA1@-1,0", "bA1@2,0", "wG1@-1,1", "bS1@3,-1" }) {
+        base.play(*parseMove(base, m));
+        mlp.play(*parseMove(mlp, m));
+    }
+    ASSERT_EQ(base.hash(), mlp.hash());
+    SearchLimits limits;
+    limits.maxDepth = 3;
+    const SearchResult cold = Searcher().search(mlp, limits);
+
+    auto table = std::make_shared<TranspositionTable>();
+    Searcher shared;
+    shared.setTable(table);
+    shared.search(base, limits);
+    const SearchResult after = shared.search(mlp, limits);
+    EXPECT_EQ(after.nodes, cold.nodes);
+    EXPECT_EQ(after.score, cold.score);
+}
+
+TEST(Search, TimeManagerBudgets) {
+    TimeManager tm;
+    TimeControl tc;
+    tc.remainingMs = 60000;
+    tm.start(tc, 0);
+    EXPECT_GT(tm.optimumMs(), 1000);
+    EXPECT_LE(tm.optimumMs(), tm.maximumMs());
+    EXPECT_LT(tm.maximumMs(), tc.remainingMs / 2);
+    const int base = tm.optimumMs();
+
+    tc.incrementMs = 2000; // increments are spent as they come
+    tm.start(tc, 0);
+    EXPECT_GT(tm.optimumMs(), base + 1000);
+    tc.incrementMs = 0;
+    tc.movesToGo = 2; // the control is close: spend more per move
+    tm.start(tc, 0);
+    EXPECT_GT(tm.optimumMs(), 4 * base);
+    EXPECT_LT(tm.maximumMs(), tc.remainingMs);
+
+    // a stable best move stops halfway through the budget...
+    tc.movesToGo = 0;
+    tm.start(tc, 0);
+    const Move a{ 1, { 0,1 }, false }, b{ 2, { 1,0 }, false };
+    EXPECT_TRUE(tm.keepSearching(10, a, 0));
+    EXPECT_TRUE(tm.keepSearching(base / 2 - 10, a, 0));
+    EXPECT_FALSE(tm.keepSearching(base / 2 + 10, a, 0));
+    // ...a changing one or a falling score buys more time, never past the maximum
+    EXPECT_TRUE(tm.keepSearching(base / 2 + 10, b, 0));
+    EXPECT_GT(tm.budgetMs(), base);
+    EXPECT_TRUE(tm.keepSearching(base / 2 + 10, b, -200));
+    EXPECT_LE(tm.budgetMs(), tm.maximumMs());
+    EXPECT_FALSE(tm.keepSearching(tm.maximumMs(), b, -200));
+}
+
+TEST(Search, TimedSearchReturnsForcedMoveAtOnce) {
+    GameState s = surroundInOne();
+    const Move only = generateMoves(s).front();
+    Searcher searcher;
+    SearchLimits limits;
+    limits.clock.remainingMs = 600000;
+    limits.searchMoves = { only };
+    const SearchResult r = searcher.search(s, limits);
+    EXPECT_EQ(r.best, only);
+    EXPECT_EQ(r.depth, 1);
+}
+
+TEST(Search, PonderWaitsForHit) {
+    GameState s;
+    for (const char* m : { "wQ@0,0", "bQ@1,0" }) s.play(*parseMove(s, m));
+    Searcher searcher;
+    SearchLimits limits;
+    limits.maxDepth = 2;
+    limits.ponder = true;
+    std::atomic<bool> done{ false };
+    SearchResult r;
+    std::thread t([&] { r = searcher.search(s, limits); done = true; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(done.load()); // depth 2 is long finished, but the move was not played yet
+    TimeControl clock;
+    clock.remainingMs = 1000;
+    searcher.ponderHit(clock);
+    t.join();
+    EXPECT_EQ(r.depth, 2);
+    auto moves = generateMoves(s);
+    EXPECT_NE(std::find(moves.begin(), moves.end(), r.best), moves.end());
+
+    // stop() ends a ponder that never hits
+    std::thread u([&] { r = searcher.search(s, limits); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    searcher.stop();
+    u.join();
+    searcher.clearStop();
+    EXPECT_EQ(r.depth, 2);
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "game_record.hpp"
+#include "solver.hpp"
+#include <random>
+
+using namespace hive;
+
+// Black queen at the origin with one open neighbor (0,1) that the white ant can reach.
+static GameState surroundInOne() {
+    GameState s;
+    s.addDemoPiece(Bug::Queen, Color::Black, { 0,0 });
+    s.addDemoPiece(Bug::Queen, Color::White, { 1,0 });
+    s.addDemoPiece(Bug::Grasshopper, Color::White, { 1,-1 });
+    s.addDemoPiece(Bug::Ant, Color::Black, { 0,-1 });
+    s.addDemoPiece(Bug::Spider, Color::Black, { -1,0 });
+    s.addDemoPiece(Bug::Beetle, Color::White, { -1,1 });
+    s.addDemoPiece(Bug::Ant, Color::White, { 2,0 });
+    return s;
+}
+
+// Plain AND/OR search: can the side to move at the top force a surround within plies?
+static bool forcedWin(GameState& s, Color attacker, int plies) {
+    const GameOver g = evaluateGameOver(s);
+    if (g != GameOver::None) return g == (attacker == Color::White ? GameOver::WhiteWins : GameOver::BlackWins);
+    if (plies == 0) return false;
+    std::vector<Move> moves = generateMoves(s);
+    if (moves.empty()) moves.push_back(Move::pass());
+    const bool attacking = s.toMove() == attacker;
+    for (const Move& m : moves) {
+        s.play(m);
+        const bool won = forcedWin(s, attacker, plies - 1);
+        s.undo();
+        if (won == attacking) return attacking;
+    }
+    return !attacking;
+}
+
+static int openAround(const GameState& s, Color c) {
+    const int qid = s.queenId(c);
+    if (qid < 0) return 6;
+    int n = 0;
+    for (int i = 0; i < 6; ++i) n += !occupied(s, add(s.pieces()[qid].pos, dir(i)));
+    return n;
+}
+
+TEST(Solver, SurroundInOneDetector) {
+    GameState s = surroundInOne();
+    auto w = findSurroundInOne(s);
+    ASSERT_TRUE(w.has_value());
+    EXPECT_EQ(w->to, (Axial{ 0,1 }));
+    EXPECT_EQ(s.pieces()[w->pieceId].bug, Bug::Ant);
+    EXPECT_EQ(s.ply(), 0); // restored
+
+    s.movePiece(s.board().at({ -1,1 }).back(), { -2,2 }); // second open neighbor: no single move finishes
+    EXPECT_FALSE(findSurroundInOne(s).has_value());
+}
+
+TEST(Solver, ProvesWinInOne) {
+    GameState s = surroundInOne();
+    ProofSolver solver(1 << 12);
+    auto r = solver.solve(s, SolveLimits{});
+    ASSERT_EQ(r.result, ProofResult::Win);
+    EXPECT_EQ(r.winInMoves, 1);
+    EXPECT_EQ(r.best.to, (Axial{ 0,1 }));
+    EXPECT_EQ(r.pv.size(), 1u);
+}
+
+// From a random game: the side to move cannot finish in one but forces the surround in two.
+TEST(Solver, ProvesWinInTwo) {
+    auto rec = parseRecord(
+        "base * wS1@0,0 bG1@1,-1 wG1@-1,1 bA1@2,-2 wB1@0,1 bB1@2,-1 wQ@1,1 bQ@2,-3 wB2@1,2 bB2@1,-3 wG2@0,3 "
+        "bS1@3,-2 wS2@2,2 bB1@1,-1 wG3@-1,2 bS2@2,-1 wA1@-2,3 bG2@0,-2 wA1@4,-2 bG3@2,-4 wA1@3,-5 bB1@0,-1 "
+        "wA1@2,-5 bG1@-1,-1 wA2@-1,3 bG1@3,-5 wA3@3,1 bS2@1,-1 wA3@2,3 bS2@2,0 wA2@-1,4 bA2@0,-3 wA1@-1,3 "
+        "bA2@4,-3 wA3@4,-6 bA3@3,-1 wA2@4,-2 bA3@5,-6 wA2@-2,2 bA2@4,-7 wG3@1,0 bA3@4,-5 wA1@-1,0 bA2@0,2 "
+        "wA1@1,-4 bA2@3,-3 wA3@3,2 bA2@3,-1 wA1@-1,-1 bS2@4,-1 wA3@2,3 bA3@3,-4 wG3@-1,0 bB1@-1,0 wA3@-2,3 "
+        "bB1@-2,0 wS1@1,-2 bA3@2,1 wS2@4,0 bA3@-1,-2 wS1@1,0 bA3@1,3 wA3@-3,3 bA3@3,0 wA3@-2,1 bS2@4,1 "
+        "wA3@-1,-2 bS2@4,-1 wA3@4,1 bA3@1,-4 wA2@2,2 bB1@-2,1 wA3@2,3 bA3@-1,3 wA3@5,-1 bA3@1,-4 wA3@0,2 "
+        "bA3@4,-5 wS1@1,-2 bA3@1,0 wA3@2,1 bB1@-1,0 wA3@4,-3 bA3@3,2 wS1@1,-1 bA3@-1,-2 wA3@4,1 bA3@3,-3 "
+        "wA2@5,1 bA3@3,2 wA2@5,-2 bA3@5,0 wA2@5,1 bA3@6,1 wS1@2,0");
+    ASSERT_TRUE(rec.has_value());
+    GameState s;
+    for (const Move& m : rec->moves) s.play(m);
+    ProofSolver solver(1 << 14);
+    SolveLimits limits;
+    limits.maxMoves = 2;
+    auto r = solver.solve(s, limits);
+    ASSERT_EQ(r.result, ProofResult::Win);
+    EXPECT_EQ(r.winInMoves, 2);
+    ASSERT_EQ(r.pv.size(), 3u);
+    EXPECT_TRUE(forcedWin(s, s.toMove(), 3));
+    EXPECT_FALSE(forcedWin(s, s.toMove(), 1));
+}
+
+TEST(Solver, OpeningHasNoShortWin) {
+    ProofSolver solver(1 << 12);
+    SolveLimits limits;
+    limits.maxMoves = 2;
+    EXPECT_EQ(solver.solve(GameState{}, limits).result, ProofResult::NoWin);
+}
+
+TEST(Solver, BudgetGivesUnknown) {
+    GameState s;
+    for (const char* m : { "wQ@0,0", "bQ@1,0", "wA1@-1,0", "bA1@2,0" }) s.play(*parseMove(s, m));
+    ProofSolver solver(1 << 12);
+    SolveLimits limits;
+    limits.maxMoves = 3;
+    limits.maxNodes = 10;
+    auto r = solver.solve(s, limits);
+    EXPECT_EQ(r.result, ProofResult::Unknown);
+    EXPECT_GE(r.nodes, 10);
+}
+
+// Positions from random games once a queen is nearly closed in, checked
+// against the plain search; proven lines must replay to a surround.
+TEST(Solver, AgreesWithFullSearch) {
+    std::mt19937 rng(7);
+    int checked = 0, wins = 0;
+    ProofSolver solver(1 << 16);
+    for (int game = 0; game < 200 && checked < 60; ++game) {
+        GameState s;
+        for (int ply = 0; ply < 120 && evaluateGameOver(s) == GameOver::None; ++ply) {
+            if (openAround(s, opponent(s.toMove())) <= 2) {
+                SolveLimits limits;
+                limits.maxMoves = 2;
+                limits.maxNodes = 0;
+                const SolveResult r = solver.solve(s, limits);
+                ASSERT_NE(r.result, ProofResult::Unknown);
+                const bool win = forcedWin(s, s.toMove(), 3);
+                EXPECT_EQ(r.result == ProofResult::Win, win) << "game " << game << " ply " << ply;
+                if (r.result == ProofResult::Win) {
+                    ++wins;
+                    EXPECT_EQ(r.winInMoves, forcedWin(s, s.toMove(), 1) ? 1 : 2);
+                    GameState line = s;
+                    for (const Move& m : r.pv) line.play(m);
+                    EXPECT_EQ(evaluateGameOver(line), s.toMove() == Color::White ? GameOver::WhiteWins : GameOver::BlackWins);
+                }
+                if (++checked >= 60) break;
+            }
+            auto moves = generateMoves(s);
+            s.play(moves.empty() ? Move::pass() : moves[rng() % moves.size()]);
+        }
+    }
+    EXPECT_EQ(checked, 60);
+    EXPECT_GT(wins, 0);
+}
+
+// One solver, both sides attacking: White's proofs below Black's root must
+// not read as wins for Black.
+TEST(Solver, TableIsKeptApartPerAttacker) {
+    GameState s = surroundInOne();
+    s.setToMove(Color::Black);
+    ProofSolver shared(1 << 12);
+    SolveLimits limits;
+    limits.maxMoves = 2;
+    int whiteWins = 0;
+    for (const Move& m : generateMoves(s)) {
+        s.play(m);
+        whiteWins += shared.solve(s, limits).result == ProofResult::Win;
+        s.undo();
+    }
+    ASSERT_GT(whiteWins, 0);
+
+    ProofSolver fresh(1 << 12);
+    const SolveResult want = fresh.solve(s, limits);
+    const SolveResult got = shared.solve(s, limits);
+    EXPECT_EQ(got.result, want.result);
+    EXPECT_EQ(got.winInMoves, want.winInMoves);
+    EXPECT_NE(got.result, ProofResult::Win);
+}
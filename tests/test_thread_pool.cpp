@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "thread_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+
+using namespace hive;
+
+TEST(ThreadPool, RunsEverySubmittedTask) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+    std::atomic<int> sum{ 0 };
+    for (int i = 1; i <= 1000; ++i) pool.submit([&sum, i] { sum += i; });
+    pool.wait();
+    EXPECT_EQ(sum.load(), 500500);
+}
+
+TEST(ThreadPool, WaitCoversTasksSubmittedByTasks) {
+    ThreadPool pool(3);
+    std::atomic<int> runs{ 0 };
+    // each task resubmits itself, like a search time slice
+    std::function<void(int)> slice = [&](int left) {
+        ++runs;
+        if (left > 0) pool.submit([&slice, left] { slice(left - 1); });
+    };
+    for (int i = 0; i < 8; ++i) pool.submit([&slice] { slice(24); });
+    pool.wait();
+    EXPECT_EQ(runs.load(), 8 * 25);
+}
+
+TEST(ThreadPool, IdleWorkersStealQueuedWork) {
+    ThreadPool pool(4);
+    std::mutex m;
+    std::set<std::thread::id> workers;
+    // one task floods its own queue; the other workers can only get work by stealing
+    pool.submit([&] {
+        for (int i = 0; i < 64; ++i) {
+            pool.submit([&] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                std::lock_guard<std::mutex> lock(m);
+                workers.insert(std::this_thread::get_id());
+            });
+        }
+    });
+    pool.wait();
+    EXPECT_GT(workers.size(), 1u);
+}
+
+TEST(ThreadPool, DestructorDrainsTheQueues) {
+    std::atomic<int> runs{ 0 };
+    {
+        ThreadPool pool(2);
+        for (int i = 0; i < 100; ++i) pool.submit([&runs] { ++runs; });
+    }
+    EXPECT_EQ(runs.load(), 100);
+}
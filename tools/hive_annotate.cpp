@@ -0,0 +1,78 @@
+// Blunder check over a game archive: every ply of every game is searched to a
+// fixed budget and moves that lose at least --threshold against the best move
+// are flagged.
+//   hive_annotate <games.txt> <annotated.txt> [--depth N] [--nodes N] [--threshold CP] [--threads N] [--tt-mb M]
+// The output repeats each record, followed by a '#' comment per flagged ply
+// (see annotate.hpp), so it loads back as a game file.
+#include "annotate.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+using namespace hive;
+
+namespace {
+
+    int usage() {
+        std::fprintf(stderr, "usage: hive_annotate <games.txt> <annotated.txt> [--depth N] [--nodes N] [--threshold CP] [--threads N] [--tt-mb M]\n");
+        return 2;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    AnnotateOptions o;
+    std::size_t ttMb = 256;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--depth") && hasValue) o.depth = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--nodes") && hasValue) o.maxNodes = std::atoll(argv[++i]);
+        else if (!std::strcmp(argv[i], "--threshold") && hasValue) o.threshold = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--threads") && hasValue) o.threads = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--tt-mb") && hasValue) ttMb = static_cast<std::size_t>(std::atoi(argv[++i]));
+        else files.push_back(argv[i]);
+    }
+    if (files.size() != 2 || o.depth < 1) return usage();
+    o.ttEntries = std::max<std::size_t>(ttMb, 1) * 1024 * 1024 / 16; // two 8-byte words per slot
+
+    std::ifstream in(files[0]);
+    if (!in) { std::fprintf(stderr, "cannot read %s\n", files[0].c_str()); return 1; }
+    int rejected = 0;
+    const std::vector<GameRecord> games = readRecords(in, &rejected);
+    std::int64_t positions = 0;
+    for (const GameRecord& g : games) positions += static_cast<std::int64_t>(g.moves.size());
+    std::printf("%zu games (%d malformed), %lld positions\n", games.size(), rejected, static_cast<long long>(positions));
+    std::fflush(stdout);
+
+    std::atomic<std::int64_t> done{ 0 };
+    const auto t0 = std::chrono::steady_clock::now();
+    auto seconds = [&] { return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count(); };
+    auto work = std::async(std::launch::async, [&] { return annotateGames(games, o, &done); });
+    while (work.wait_for(std::chrono::seconds(2)) != std::future_status::ready) {
+        const double t = seconds();
+        std::fprintf(stderr, "  %lld/%lld positions, %.0f/s\n", static_cast<long long>(done.load()),
+            static_cast<long long>(positions), done.load() / std::max(t, 1e-9));
+    }
+    const std::vector<GameAnnotation> notes = work.get();
+    const double t = seconds();
+
+    std::ofstream out(files[1]);
+    if (!out) { std::fprintf(stderr, "cannot write %s\n", files[1].c_str()); return 1; }
+    out << "# hive_annotate: depth " << o.depth;
+    if (o.maxNodes > 0) out << ", " << o.maxNodes << " nodes";
+    out << ", threshold " << o.threshold << "\n";
+    int flagged = 0;
+    for (std::size_t i = 0; i < games.size(); ++i) {
+        writeAnnotated(out, games[i], notes[i], o.threshold);
+        flagged += notes[i].flagged;
+    }
+    std::printf("%d flagged moves in %.1f s, %.0f positions/s\n", flagged, t, positions / std::max(t, 1e-9));
+    return 0;
+}
@@ -0,0 +1,227 @@
+// Opening book tool.
+//   hive_book selfplay <games> <records.txt> [--ruleset base|mlp] [--depth N] [--random-plies K] [--seed S] [--move-limit P]
+//                      [--time-ms T [--inc-ms I] [--ponder]] [--profile] [--trace trace.json]
+// With --time-ms each side plays on a clock of T ms plus I per move through
+// the time manager (--depth is then ignored), optionally pondering on the
+// opponent's time; running out of time loses.
+//   hive_book build <out.book> <records.txt>... [--ruleset base|mlp] [--plies N] [--min-visits V]
+//   hive_book probe <book> [move...]
+#include "book.hpp"
+#include "player.hpp"
+#include "profile.hpp"
+#include "search.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace hive;
+
+namespace {
+
+    struct Options {
+        Ruleset ruleset{ Ruleset::Base };
+        int depth{ 2 };
+        int randomPlies{ 4 };
+        unsigned seed{ 1 };
+        int moveLimit{ 200 };
+        int plies{ 16 };
+        std::uint32_t minVisits{ 1 };
+        int timeMs{ 0 };
+        int incMs{ 0 };
+        bool ponder{ false };
+        bool profile{ false };
+        std::string tracePath;
+        std::vector<std::string> positional;
+    };
+
+    Options parseOptions(int argc, char** argv, int first) {
+        Options o;
+        for (int i = first; i < argc; ++i) {
+            const std::string a = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (a == "--ruleset" && hasValue) o.ruleset = std::strcmp(argv[++i], "mlp") == 0 ? Ruleset::MLP : Ruleset::Base;
+            else if (a == "--depth" && hasValue) o.depth = std::atoi(argv[++i]);
+            else if (a == "--random-plies" && hasValue) o.randomPlies = std::atoi(argv[++i]);
+            else if (a == "--seed" && hasValue) o.seed = static_cast<unsigned>(std::atoi(argv[++i]));
+            else if (a == "--move-limit" && hasValue) o.moveLimit = std::atoi(argv[++i]);
+            else if (a == "--plies" && hasValue) o.plies = std::atoi(argv[++i]);
+            else if (a == "--min-visits" && hasValue) o.minVisits = static_cast<std::uint32_t>(std::atoi(argv[++i]));
+            else if (a == "--time-ms" && hasValue) o.timeMs = std::atoi(argv[++i]);
+            else if (a == "--inc-ms" && hasValue) o.incMs = std::atoi(argv[++i]);
+            else if (a == "--ponder") o.ponder = true;
+            else if (a == "--profile") o.profile = true;
+            else if (a == "--trace" && hasValue) o.tracePath = argv[++i];
+            else o.positional.push_back(a);
+        }
+        return o;
+    }
+
+    int usage() {
+        std::fprintf(stderr,
+            "usage: hive_book selfplay <games> <records.txt> [--ruleset base|mlp] [--depth N] [--random-plies K] [--seed S] [--move-limit P]\n"
+            "                          [--time-ms T [--inc-ms I] [--ponder]] [--profile] [--trace trace.json]\n"
+            "       hive_book build <out.book> <records.txt>... [--ruleset base|mlp] [--plies N] [--min-visits V]\n"
+            "       hive_book probe <book> [move...]\n");
+        return 2;
+    }
+
+    struct Clocks {
+        int remainingMs[kColorCount]{};
+        int timeLosses{ 0 };
+        int ponderHits{ 0 };
+        int moves{ 0 };
+    };
+
+    // One timed move for the side to move; false when its flag falls.
+    bool timedMove(const Options& o, EnginePlayer* players, Clocks& clocks, GameState& s, Move& played) {
+        const Color us = s.toMove();
+        EnginePlayer& player = players[colorIndex(us)];
+        TimeControl tc;
+        tc.remainingMs = clocks.remainingMs[colorIndex(us)];
+        tc.incrementMs = o.incMs;
+        const auto t0 = std::chrono::steady_clock::now();
+        const EnginePlayer::Decision d = player.go(s, tc);
+        const int spent = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count());
+        ++clocks.moves;
+        clocks.ponderHits += d.source == EnginePlayer::Source::PonderHit;
+        clocks.remainingMs[colorIndex(us)] -= spent;
+        if (clocks.remainingMs[colorIndex(us)] <= 0) return false;
+        clocks.remainingMs[colorIndex(us)] += o.incMs;
+        played = d.move;
+        if (o.ponder && d.hasPonder) {
+            GameState after = s;
+            after.play(d.move);
+            player.startPonder(after, d.ponder);
+        }
+        return true;
+    }
+
+    // Random opening plies for variety, then a shallow search (or a timed
+    // search, see --time-ms) per move.
+    int selfplay(const Options& o) {
+        if (o.positional.size() != 2) return usage();
+        const int games = std::atoi(o.positional[0].c_str());
+        std::ofstream out(o.positional[1], std::ios::app);
+        if (!out) { std::fprintf(stderr, "cannot write %s\n", o.positional[1].c_str()); return 1; }
+
+        if (!o.tracePath.empty()) profile::setTracing(true);
+        std::mt19937 rng(o.seed);
+        Searcher searcher;
+        SearchLimits limits;
+        limits.maxDepth = o.depth;
+        int tally[4]{};
+        Clocks clocks;
+        for (int g = 0; g < games; ++g) {
+            GameState s(o.ruleset);
+            s.setMoveLimit(o.moveLimit);
+            GameRecord rec;
+            rec.ruleset = o.ruleset;
+            EnginePlayer players[kColorCount];
+            for (int& ms : clocks.remainingMs) ms = o.timeMs;
+            while ((rec.result = evaluateGameOver(s)) == GameOver::None) {
+                Move m = Move::pass();
+                if (s.ply() < o.randomPlies) {
+                    const auto moves = generateMoves(s);
+                    if (!moves.empty()) m = moves[rng() % moves.size()];
+                }
+                else if (o.timeMs > 0) {
+                    if (!timedMove(o, players, clocks, s, m)) {
+                        rec.result = s.toMove() == Color::White ? GameOver::BlackWins : GameOver::WhiteWins;
+                        ++clocks.timeLosses;
+                        break;
+                    }
+                }
+                else {
+                    m = searcher.search(s, limits).best;
+                }
+                s.play(m);
+                rec.moves.push_back(m);
+            }
+            out << formatRecord(rec) << '\n';
+            ++tally[static_cast<int>(rec.result)];
+        }
+        std::printf("%d games: %d white wins, %d black wins, %d draws\n", games,
+            tally[static_cast<int>(GameOver::WhiteWins)], tally[static_cast<int>(GameOver::BlackWins)], tally[static_cast<int>(GameOver::Draw)]);
+        if (o.timeMs > 0) {
+            std::printf("%d timed moves, %d lost on time, %d ponder hits\n", clocks.moves, clocks.timeLosses, clocks.ponderHits);
+        }
+        if (o.profile) profile::printSummary();
+        if (!o.tracePath.empty() && !profile::writeChromeTrace(o.tracePath)) {
+            std::fprintf(stderr, "cannot write trace %s%s\n", o.tracePath.c_str(), profile::kEnabled ? "" : " (built without HIVE_PROFILE)");
+            return 1;
+        }
+        return 0;
+    }
+
+    int build(const Options& o) {
+        if (o.positional.size() < 2) return usage();
+        BookBuilder builder(o.ruleset, o.plies);
+        int used = 0, skipped = 0, rejected = 0;
+        for (size_t i = 1; i < o.positional.size(); ++i) {
+            std::ifstream in(o.positional[i]);
+            if (!in) { std::fprintf(stderr, "cannot read %s\n", o.positional[i].c_str()); return 1; }
+            for (const GameRecord& g : readRecords(in, &rejected)) {
+                if (builder.add(g)) ++used; else ++skipped;
+            }
+        }
+        if (!builder.write(o.positional[0], o.minVisits)) {
+            std::fprintf(stderr, "cannot write %s\n", o.positional[0].c_str());
+            return 1;
+        }
+        std::printf("%d games (%d other ruleset, %d malformed) -> %zu positions\n", used, skipped, rejected, builder.positions());
+        return 0;
+    }
+
+    int probe(const Options& o) {
+        if (o.positional.empty()) return usage();
+        OpeningBook book;
+        if (!book.load(o.positional[0])) { std::fprintf(stderr, "cannot load %s\n", o.positional[0].c_str()); return 1; }
+
+        GameState s(book.ruleset());
+        for (size_t i = 1; i < o.positional.size(); ++i) {
+            const auto m = parseMove(s, o.positional[i]);
+            if (!m) { std::fprintf(stderr, "bad move %s\n", o.positional[i].c_str()); return 1; }
+            s.play(*m);
+        }
+
+        struct Line { std::string move; BookStats st; };
+        std::vector<Line> lines;
+        std::vector<std::uint64_t> seen; // mirrored moves share an entry: list each once
+        GameState probeState = s;
+        for (const Move& m : generateMoves(s)) {
+            probeState.play(m);
+            const std::uint64_t key = canonicalHash(probeState);
+            probeState.undo();
+            if (std::find(seen.begin(), seen.end(), key) != seen.end()) continue;
+            seen.push_back(key);
+            if (auto st = book.find(key)) lines.push_back({ moveToString(s, m), *st });
+        }
+        std::sort(lines.begin(), lines.end(), [](const Line& a, const Line& b) { return a.st.visits > b.st.visits; });
+        std::printf("%zu book positions; %zu book moves here\n", book.size(), lines.size());
+        for (const Line& l : lines) {
+            std::printf("  %-12s visits %6u  +%u =%u -%u  score %.3f\n", l.move.c_str(), l.st.visits,
+                s.toMove() == Color::White ? l.st.whiteWins : l.st.blackWins, l.st.draws,
+                s.toMove() == Color::White ? l.st.blackWins : l.st.whiteWins, l.st.scoreFor(s.toMove()));
+        }
+        if (auto m = book.pick(s, 1)) std::printf("pick: %s\n", moveToString(s, *m).c_str());
+        return 0;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) return usage();
+    const std::string cmd = argv[1];
+    const Options o = parseOptions(argc, argv, 2);
+    if (cmd == "selfplay") return selfplay(o);
+    if (cmd == "build") return build(o);
+    if (cmd == "probe") return probe(o);
+    return usage();
+}
@@ -0,0 +1,142 @@
+// Retrograde analysis of reduced-piece variants.
+//   hive_retro build <variant> <out.retro> [--threads N]
+//   hive_retro probe <table.retro> [move...]
+//   hive_retro verify <table.retro> [--games N] [--seed S]
+// A variant lists each side's bugs, e.g. QSA (both sides) or QSAG/QSA (white/black).
+#include "retro.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace hive;
+
+namespace {
+
+    int usage() {
+        std::fprintf(stderr,
+            "usage: hive_retro build <variant> <out.retro> [--threads N]\n"
+            "       hive_retro probe <table.retro> [move...]\n"
+            "       hive_retro verify <table.retro> [--games N] [--seed S]\n"
+            "variant: bug letters per side, e.g. QSA or QSAG/QSA (white/black)\n");
+        return 2;
+    }
+
+    std::string describe(const RetroResult& r) {
+        switch (r.value) {
+        case RetroValue::Win: return "win in " + std::to_string(r.distance);
+        case RetroValue::Loss: return "loss in " + std::to_string(r.distance);
+        case RetroValue::Draw: break;
+        }
+        return "draw";
+    }
+
+    int build(int argc, char** argv) {
+        int threads = 0;
+        std::vector<std::string> positional;
+        for (int i = 2; i < argc; ++i) {
+            if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = std::atoi(argv[++i]);
+            else positional.push_back(argv[i]);
+        }
+        if (positional.size() != 2) return usage();
+        const auto v = RetroVariant::parse(positional[0]);
+        if (!v) { std::fprintf(stderr, "bad variant %s (base bugs only, one Queen per side)\n", positional[0].c_str()); return 2; }
+
+        const auto stats = buildRetroTable(*v, positional[1], threads);
+        if (!stats) { std::fprintf(stderr, "cannot write %s\n", positional[1].c_str()); return 1; }
+        std::printf("%s: %zu positions, %zu wins, %zu losses, %zu draws, longest win %d plies, %.1f s\n",
+            v->name().c_str(), stats->positions, stats->wins, stats->losses, stats->draws, stats->longestWin, stats->ms / 1000.0);
+        return 0;
+    }
+
+    int probe(int argc, char** argv) {
+        if (argc < 3) return usage();
+        RetroTable table;
+        if (!table.load(argv[2])) { std::fprintf(stderr, "cannot load %s\n", argv[2]); return 1; }
+
+        GameState s = variantStart(table.variant());
+        for (int i = 3; i < argc; ++i) {
+            const auto m = parseMove(s, argv[i]);
+            const auto moves = generateMoves(s);
+            if (!m || std::find(moves.begin(), moves.end(), *m) == moves.end()) { std::fprintf(stderr, "illegal move %s\n", argv[i]); return 1; }
+            s.play(*m);
+        }
+        const auto here = table.find(s);
+        std::printf("%s, %zu positions; %s to move: %s\n", table.variant().name().c_str(), table.size(),
+            s.toMove() == Color::White ? "white" : "black", here ? describe(*here).c_str() : "not in table");
+
+        // each move with the value it leaves the opponent, best for us first
+        struct Line { std::string move; RetroResult r; };
+        std::vector<Line> lines;
+        for (const Move& m : generateMoves(s)) {
+            s.play(m);
+            if (auto r = table.find(s)) lines.push_back({ moveToString(s, m), *r });
+            s.undo();
+        }
+        auto rank = [](const RetroResult& r) { // opponent's view: their quick loss first, their quick win last
+            return r.value == RetroValue::Loss ? r.distance : r.value == RetroValue::Draw ? 1 << 20 : (1 << 21) - r.distance;
+        };
+        std::stable_sort(lines.begin(), lines.end(), [&](const Line& a, const Line& b) { return rank(a.r) < rank(b.r); });
+        for (const Line& l : lines) std::printf("  %-12s opponent %s\n", l.move.c_str(), describe(l.r).c_str());
+        return 0;
+    }
+
+    // Random games through the table: every position must be in it and agree
+    // with its successors, i.e. a win in d has a reply lost in d-1 and none
+    // sooner, a loss in d only replies won in at most d-1, a draw neither.
+    int verify(int argc, char** argv) {
+        if (argc < 3) return usage();
+        int games = 200;
+        unsigned seed = 1;
+        for (int i = 3; i + 1 < argc; i += 2) {
+            if (!std::strcmp(argv[i], "--games")) games = std::atoi(argv[i + 1]);
+            else if (!std::strcmp(argv[i], "--seed")) seed = static_cast<unsigned>(std::atoi(argv[i + 1]));
+        }
+        RetroTable table;
+        if (!table.load(argv[2])) { std::fprintf(stderr, "cannot load %s\n", argv[2]); return 1; }
+
+        std::mt19937 rng(seed);
+        long checked = 0, bad = 0;
+        for (int g = 0; g < games; ++g) {
+            GameState s = variantStart(table.variant());
+            while (s.ply() < 300 && !queenSurrounded(s, Color::White) && !queenSurrounded(s, Color::Black)) {
+                auto moves = generateMoves(s);
+                if (moves.empty()) moves.push_back(Move::pass());
+                const auto here = table.find(s);
+                int soonestLoss = -1, latestWin = -1;
+                bool allWon = true, missing = !here;
+                for (const Move& m : moves) {
+                    s.play(m);
+                    const auto r = table.find(s);
+                    s.undo();
+                    if (!r) { missing = true; continue; }
+                    if (r->value == RetroValue::Loss && (soonestLoss < 0 || r->distance < soonestLoss)) soonestLoss = r->distance;
+                    if (r->value == RetroValue::Win) latestWin = std::max(latestWin, r->distance);
+                    else allWon = false;
+                }
+                bool ok = !missing;
+                if (ok && here->value == RetroValue::Win) ok = soonestLoss == here->distance - 1;
+                else if (ok && here->value == RetroValue::Loss) ok = allWon && latestWin == here->distance - 1;
+                else if (ok) ok = soonestLoss < 0 && !allWon;
+                ++checked;
+                if (!ok && ++bad <= 10) std::printf("game %d ply %d: %s disagrees with its moves\n", g, s.ply(), here ? describe(*here).c_str() : "missing");
+                s.play(moves[rng() % moves.size()]);
+            }
+        }
+        std::printf("%ld positions checked, %ld inconsistent\n", checked, bad);
+        return bad ? 1 : 0;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) return usage();
+    const std::string cmd = argv[1];
+    if (cmd == "build") return build(argc, argv);
+    if (cmd == "probe") return probe(argc, argv);
+    if (cmd == "verify") return verify(argc, argv);
+    return usage();
+}
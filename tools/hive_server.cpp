@@ -0,0 +1,392 @@
+// Multi-session engine host over a Unix domain socket or loopback TCP.
+//   hive_server (--unix <path> | --tcp <port>) [--threads N] [--tt-mb M] [--book <file>] [--slice-ms Q]
+// Every connection is one session with its own game. Searches from all
+// sessions run in time slices on one work-stealing pool and share one
+// transposition table and opening book. One command per line:
+//   new [base|mlp]                      -> ok
+//   play <move>                         -> ok | error <reason>
+//   undo                                -> ok | error <reason>
+//   moves                               -> moves <move>...
+//   position                            -> position <record>     (game record format)
+//   go [depth N] [movetime MS] [clock MS [inc MS]] [infinite]
+//                                       -> info depth D score S nodes N time T pv <move>...
+//                                          bestmove <move> [ponder <move>]
+//   stop                                -> the running search answers bestmove now
+//   quit
+// go defaults to movetime 1000. Position commands are refused while the
+// session's search runs.
+#include "book.hpp"
+#include "search.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define HIVE_SERVER_POSIX 1
+#endif
+
+using namespace hive;
+
+#ifdef HIVE_SERVER_POSIX
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string unixPath;
+        int tcpPort{ 0 };
+        int threads{ 0 };
+        std::size_t ttMb{ 256 };
+        std::string bookPath;
+        int sliceMs{ 50 };
+    };
+
+    // One connection. The game is only touched by the event loop, and only
+    // while no search runs; a search works on its own copy of the position.
+    struct Session {
+        explicit Session(int fd_) : fd(fd_) {}
+        ~Session() { ::close(fd); }
+
+        void send(const std::string& line) {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            if (closed) return;
+            const std::string out = line + "\n";
+            std::size_t sent = 0;
+            while (sent < out.size()) {
+                const ssize_t n = ::send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0) { closed = true; return; }
+                sent += static_cast<std::size_t>(n);
+            }
+        }
+
+        const int fd;
+        std::string inbox; // bytes read, not yet a full line
+        GameState state;
+        std::vector<Move> moves; // played since new, for position
+        std::mutex writeMutex;
+        bool closed{ false };    // guarded by writeMutex
+
+        // the running search, if any
+        std::atomic<bool> searching{ false };
+        std::atomic<bool> stopRequested{ false };
+        Searcher searcher;
+        GameState root;
+        SearchLimits limits;
+        Clock::time_point started, deadline;
+        bool timed{ false }, infinite{ false };
+        TimeManager time;
+        SearchResult best;       // deepest over the slices so far
+        std::int64_t nodes{ 0 }; // of the finished slices
+        int quantumMs{ 0 };      // length of the next slice
+    };
+
+    std::string lineString(GameState s, const std::vector<Move>& line) {
+        std::string out;
+        for (const Move& m : line) {
+            out += ' ';
+            out += moveToString(s, m);
+            s.play(m);
+        }
+        return out;
+    }
+
+    class Server {
+    public:
+        explicit Server(const Options& o)
+            : options_(o), pool_(o.threads),
+              table_(std::make_shared<TranspositionTable>(std::max<std::size_t>(o.ttMb, 1) * 1024 * 1024 / 16)) {}
+
+        bool loadBook(const std::string& path) {
+            auto book = std::make_shared<OpeningBook>();
+            if (!book->load(path)) return false;
+            book_ = std::move(book);
+            return true;
+        }
+
+        int serve(int listenFd);
+
+    private:
+        void handle(const std::shared_ptr<Session>& s, const std::string& line);
+        void go(const std::shared_ptr<Session>& s, std::istringstream& args);
+        void slice(const std::shared_ptr<Session>& s);
+        void finish(Session& s);
+
+        Options options_;
+        ThreadPool pool_;
+        std::shared_ptr<TranspositionTable> table_;
+        std::shared_ptr<const OpeningBook> book_;
+        std::map<int, std::shared_ptr<Session>> sessions_; // by fd
+    };
+
+    int Server::serve(int listenFd) {
+        std::vector<pollfd> fds;
+        char buf[4096];
+        for (;;) {
+            fds.clear();
+            fds.push_back({ listenFd, POLLIN, 0 });
+            for (const auto& [fd, s] : sessions_) fds.push_back({ fd, POLLIN, 0 });
+            if (::poll(fds.data(), fds.size(), -1) < 0) {
+                if (errno == EINTR) continue;
+                std::perror("poll");
+                return 1;
+            }
+            if (fds[0].revents & POLLIN) {
+                const int fd = ::accept(listenFd, nullptr, nullptr);
+                if (fd >= 0) {
+                    auto s = std::make_shared<Session>(fd);
+                    s->searcher.setTable(table_);
+                    sessions_[fd] = s;
+                }
+            }
+            for (std::size_t i = 1; i < fds.size(); ++i) {
+                if (!fds[i].revents) continue;
+                auto it = sessions_.find(fds[i].fd);
+                if (it == sessions_.end()) continue;
+                const std::shared_ptr<Session> s = it->second;
+                const ssize_t n = ::recv(s->fd, buf, sizeof buf, 0);
+                bool quit = n <= 0;
+                if (n > 0) s->inbox.append(buf, static_cast<std::size_t>(n));
+                std::size_t eol;
+                while (!quit && (eol = s->inbox.find('\n')) != std::string::npos) {
+                    std::string line = s->inbox.substr(0, eol);
+                    s->inbox.erase(0, eol + 1);
+                    if (!line.empty() && line.back() == '\r') line.pop_back();
+                    if (line == "quit") quit = true;
+                    else handle(s, line);
+                }
+                if (quit) {
+                    // a running slice keeps the session alive; it sees the stop and ends
+                    s->stopRequested = true;
+                    s->searcher.stop();
+                    { std::lock_guard<std::mutex> lock(s->writeMutex); s->closed = true; }
+                    sessions_.erase(it);
+                }
+            }
+        }
+    }
+
+    void Server::handle(const std::shared_ptr<Session>& s, const std::string& line) {
+        std::istringstream in(line);
+        std::string cmd;
+        in >> cmd;
+        if (cmd.empty()) return;
+        if (cmd == "stop") {
+            s->stopRequested = true;
+            s->searcher.stop();
+            return;
+        }
+        if (cmd == "moves") {
+            std::string out = "moves";
+            for (const Move& m : generateMoves(s->state)) out += " " + moveToString(s->state, m);
+            s->send(out);
+            return;
+        }
+        if (cmd == "position") {
+            GameRecord rec{ s->state.ruleset(), evaluateGameOver(s->state), s->moves };
+            s->send("position " + formatRecord(rec));
+            return;
+        }
+        if (s->searching) { s->send("error busy"); return; }
+
+        if (cmd == "new") {
+            std::string rules;
+            in >> rules;
+            s->state = GameState(rules == "mlp" ? Ruleset::MLP : Ruleset::Base);
+            s->moves.clear();
+            s->send("ok");
+        }
+        else if (cmd == "play") {
+            std::string text;
+            in >> text;
+            auto m = parseMove(s->state, text);
+            auto legal = generateMoves(s->state);
+            if (legal.empty()) legal.push_back(Move::pass());
+            if (!m || std::find(legal.begin(), legal.end(), *m) == legal.end()) { s->send("error illegal move " + text); return; }
+            if (evaluateGameOver(s->state) != GameOver::None) { s->send("error game over"); return; }
+            s->state.play(*m);
+            s->moves.push_back(*m);
+            s->send("ok");
+        }
+        else if (cmd == "undo") {
+            if (s->moves.empty()) { s->send("error nothing to undo"); return; }
+            s->state.undo();
+            s->moves.pop_back();
+            s->send("ok");
+        }
+        else if (cmd == "go") {
+            go(s, in);
+        }
+        else {
+            s->send("error unknown command " + cmd);
+        }
+    }
+
+    void Server::go(const std::shared_ptr<Session>& s, std::istringstream& args) {
+        if (evaluateGameOver(s->state) != GameOver::None) { s->send("error game over"); return; }
+        SearchLimits limits;
+        TimeControl clock;
+        int moveTimeMs = 0;
+        bool infinite = false;
+        std::string key;
+        while (args >> key) {
+            if (key == "depth") args >> limits.maxDepth;
+            else if (key == "movetime") args >> moveTimeMs;
+            else if (key == "clock") args >> clock.remainingMs;
+            else if (key == "inc") args >> clock.incrementMs;
+            else if (key == "infinite") infinite = true;
+        }
+        if (!infinite && moveTimeMs <= 0 && !clock.timed() && limits.maxDepth == SearchLimits{}.maxDepth) moveTimeMs = 1000;
+
+        if (book_ && book_->ruleset() == s->state.ruleset()) {
+            if (auto m = book_->pick(s->state)) { s->send("bestmove " + moveToString(s->state, *m)); return; }
+        }
+
+        s->root = s->state;
+        s->limits = limits;
+        s->started = Clock::now();
+        s->infinite = infinite;
+        s->timed = !infinite && clock.timed();
+        if (s->timed) {
+            s->time.start(clock, s->root.ply());
+            s->deadline = s->started + std::chrono::milliseconds(s->time.maximumMs());
+        }
+        else {
+            s->deadline = moveTimeMs > 0 && !infinite ? s->started + std::chrono::milliseconds(moveTimeMs) : Clock::time_point::max();
+        }
+        s->best = SearchResult{};
+        s->nodes = 0;
+        s->quantumMs = options_.sliceMs;
+        s->stopRequested = false;
+        s->searcher.clearStop();
+        s->searching = true;
+        pool_.submit([this, s] { slice(s); });
+    }
+
+    // One time slice: a search bounded by the slice length, from depth 1 over
+    // the warm table, so it is quickly back at the depth the previous slice
+    // reached; a slice that gets no deeper doubles the next one. Then either
+    // answer or queue the next slice behind the other sessions' work.
+    void Server::slice(const std::shared_ptr<Session>& s) {
+        const auto now = Clock::now();
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(s->deadline - now).count();
+        bool done = s->stopRequested || left <= 0;
+        if (!done) {
+            SearchLimits l = s->limits;
+            l.moveTimeMs = static_cast<int>(std::min<long long>(s->quantumMs, left));
+            const SearchResult r = s->searcher.search(s->root, l, [&](const SearchInfo& info) {
+                // iterations an earlier slice already reported, unless they changed their mind
+                if (info.depth < s->best.depth || (info.depth == s->best.depth && (info.pv.empty() || info.pv.front() == s->best.best))) return;
+                const int ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - s->started).count());
+                s->send("info depth " + std::to_string(info.depth) + " score " + std::to_string(info.score) +
+                    " nodes " + std::to_string(s->nodes + info.nodes) + " time " + std::to_string(ms) + " pv" + lineString(s->root, info.pv));
+            });
+            s->nodes += r.nodes;
+            // a slice that only re-searched known depths was too short for the next one
+            if (r.depth <= s->best.depth) s->quantumMs = static_cast<int>(std::min<long long>(s->quantumMs * 2LL, 1 << 20));
+            if (r.depth >= s->best.depth) {
+                const bool deeper = r.depth > s->best.depth;
+                s->best = r;
+                const int elapsed = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - s->started).count());
+                if (deeper && s->timed && !s->time.keepSearching(elapsed, r.best, r.score)) done = true;
+            }
+            done = done || s->stopRequested || r.depth >= s->limits.maxDepth || std::abs(r.score) >= kWinThreshold
+                || generateMoves(s->root).size() <= 1;
+        }
+        if (done) finish(*s);
+        else pool_.submit([this, s] { slice(s); });
+    }
+
+    void Server::finish(Session& s) {
+        if (s.best.pv.empty()) { // stopped before any slice ran: any legal move
+            auto legal = generateMoves(s.root);
+            s.best.best = legal.empty() ? Move::pass() : legal.front();
+            s.best.pv.assign(1, s.best.best);
+        }
+        std::string out = "bestmove " + moveToString(s.root, s.best.best);
+        if (s.best.pv.size() > 1) {
+            GameState after = s.root;
+            after.play(s.best.best);
+            out += " ponder " + moveToString(after, s.best.pv[1]);
+        }
+        s.send(out);
+        s.searcher.clearStop();
+        s.searching = false;
+    }
+
+    int listenOn(const Options& o) {
+        int fd = -1;
+        if (!o.unixPath.empty()) {
+            fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if (o.unixPath.size() >= sizeof addr.sun_path) return -1;
+            std::strcpy(addr.sun_path, o.unixPath.c_str());
+            ::unlink(o.unixPath.c_str());
+            if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) < 0) return -1;
+        }
+        else {
+            fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            const int yes = 1;
+            ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof yes);
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<std::uint16_t>(o.tcpPort));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // local clients only
+            if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) < 0) return -1;
+        }
+        return ::listen(fd, 64) < 0 ? -1 : fd;
+    }
+
+    int usage() {
+        std::fprintf(stderr, "usage: hive_server (--unix <path> | --tcp <port>) [--threads N] [--tt-mb M] [--book <file>] [--slice-ms Q]\n");
+        return 2;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--unix") && hasValue) o.unixPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--tcp") && hasValue) o.tcpPort = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--threads") && hasValue) o.threads = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--tt-mb") && hasValue) o.ttMb = static_cast<std::size_t>(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--book") && hasValue) o.bookPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--slice-ms") && hasValue) o.sliceMs = std::max(1, std::atoi(argv[++i]));
+        else return usage();
+    }
+    if (o.unixPath.empty() == (o.tcpPort <= 0)) return usage();
+
+    ::signal(SIGPIPE, SIG_IGN);
+    Server server(o);
+    if (!o.bookPath.empty() && !server.loadBook(o.bookPath)) { std::fprintf(stderr, "cannot load %s\n", o.bookPath.c_str()); return 1; }
+    const int fd = listenOn(o);
+    if (fd < 0) { std::perror("listen"); return 1; }
+    std::printf("listening on %s\n", o.unixPath.empty() ? ("127.0.0.1:" + std::to_string(o.tcpPort)).c_str() : o.unixPath.c_str());
+    std::fflush(stdout);
+    return server.serve(fd);
+}
+#else
+int main() {
+    std::fprintf(stderr, "hive_server needs POSIX sockets\n");
+    return 1;
+}
+#endif
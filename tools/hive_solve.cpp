@@ -0,0 +1,83 @@
+// Batch proof-number solving: each record line of a position file is replayed
+// and the side to move is asked for a forced queen surround.
+//   hive_solve <positions.txt>... [--moves N] [--nodes N] [--tt-mb M]
+// Position files use the game record format (see game_record.hpp); the result
+// field is ignored and the position after the last move is solved.
+#include "game_record.hpp"
+#include "solver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace hive;
+
+namespace {
+
+    int usage() {
+        std::fprintf(stderr, "usage: hive_solve <positions.txt>... [--moves N] [--nodes N] [--tt-mb M]\n");
+        return 2;
+    }
+
+    const char* resultName(ProofResult r) {
+        switch (r) {
+        case ProofResult::Win: return "win";
+        case ProofResult::NoWin: return "no-win";
+        case ProofResult::Unknown: break;
+        }
+        return "unknown";
+    }
+
+}
+
+int main(int argc, char** argv) {
+    SolveLimits limits;
+    std::size_t ttMb = 64;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--moves") && hasValue) limits.maxMoves = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--nodes") && hasValue) limits.maxNodes = std::atoll(argv[++i]);
+        else if (!std::strcmp(argv[i], "--tt-mb") && hasValue) ttMb = static_cast<std::size_t>(std::atoi(argv[++i]));
+        else files.push_back(argv[i]);
+    }
+    if (files.empty() || limits.maxMoves < 1) return usage();
+
+    // ~24 bytes per entry
+    ProofSolver solver(std::max<std::size_t>(ttMb, 1) * 1024 * 1024 / 24);
+    int tally[3]{};
+    int index = 0, rejected = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (const std::string& path : files) {
+        std::ifstream in(path);
+        if (!in) { std::fprintf(stderr, "cannot read %s\n", path.c_str()); return 1; }
+        for (const GameRecord& g : readRecords(in, &rejected)) {
+            GameState s(g.ruleset);
+            for (const Move& m : g.moves) s.play(m);
+
+            const auto start = std::chrono::steady_clock::now();
+            const SolveResult r = solver.solve(s, limits);
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            ++tally[static_cast<int>(r.result)];
+
+            std::printf("%4d %s %-7s", ++index, s.toMove() == Color::White ? "w" : "b", resultName(r.result));
+            if (r.result == ProofResult::Win) {
+                std::printf(" in %d:", r.winInMoves);
+                for (const Move& m : r.pv) {
+                    std::printf(" %s", moveToString(s, m).c_str());
+                    s.play(m);
+                }
+            }
+            std::printf("  (%lld nodes, %.1f ms)\n", static_cast<long long>(r.nodes), ms);
+        }
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("%d positions (%d malformed): %d win, %d no-win, %d unknown in %.1f ms\n", index, rejected,
+        tally[static_cast<int>(ProofResult::Win)], tally[static_cast<int>(ProofResult::NoWin)],
+        tally[static_cast<int>(ProofResult::Unknown)], ms);
+    return 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "engine.hpp"
+#include "rules.hpp"
+#include "search.hpp"
+#include "book.hpp"
+
+// Runs engine work off the render thread. Each request carries a snapshot of
+// the position and returns a ticket; replies are drained once per frame with
+// poll(). cancel() drops queued work, stops a running search and discards any
+// reply still in flight, so stale answers never reach the UI.
+class EngineWorker {
+public:
+	enum class ReplyKind { Targets, Info, BestMove };
+
+	struct Reply {
+		std::uint64_t ticket{};
+		ReplyKind kind{};
+		std::vector<hive::Axial> targets;        // Targets
+		hive::SearchInfo info;                   // Info: one per completed depth and multi-PV line
+		hive::Move best{ hive::Move::pass() };   // BestMove: search finished
+	};
+
+	EngineWorker();
+	~EngineWorker();
+	EngineWorker(const EngineWorker&) = delete;
+	EngineWorker& operator=(const EngineWorker&) = delete;
+
+	std::uint64_t requestMoveTargets(const hive::GameState& s, int pieceId);
+	std::uint64_t requestPlacementTargets(const hive::GameState& s, hive::Color c);
+	// Streams Info replies while deepening, then one BestMove.
+	std::uint64_t requestAnalysis(const hive::GameState& s, const hive::SearchLimits& limits);
+	// Multi-PV analysis restricted to one piece's legal moves (a hand piece's
+	// placements, or a board piece's moves): one Info line per move and depth.
+	std::uint64_t requestPieceAnalysis(const hive::GameState& s, int pieceId, const hive::SearchLimits& limits);
+	// One BestMove: straight from the opening book when in book, else a search.
+	std::uint64_t requestEngineMove(const hive::GameState& s, const hive::SearchLimits& limits);
+	void setBook(std::shared_ptr<const hive::OpeningBook> book);
+
+	void cancel();
+	bool poll(Reply& out); // non-blocking
+
+private:
+	enum class JobKind { MoveTargets, PlacementTargets, Analysis, PieceAnalysis, EngineMove };
+	struct Job {
+		std::uint64_t ticket{};
+		std::uint64_t generation{};
+		JobKind kind{};
+		hive::GameState state;
+		int pieceId{ -1 };
+		hive::Color color{};
+		hive::SearchLimits limits{};
+		std::shared_ptr<const hive::OpeningBook> book; // EngineMove only
+	};
+
+	std::uint64_t post(Job job);
+	void run();
+	void search(const Job& job); // streams Info, then one BestMove
+	void reply(std::uint64_t generation, Reply r);
+
+	std::mutex jobsMutex_;
+	std::condition_variable jobsCv_;
+	std::deque<Job> jobs_;
+	bool quit_{ false };
+
+	std::mutex repliesMutex_;
+	std::deque<Reply> replies_;
+
+	std::atomic<std::uint64_t> generation_{ 0 };
+	std::uint64_t nextTicket_{ 1 }; // UI thread only
+	std::shared_ptr<const hive::OpeningBook> book_; // UI thread only; jobs carry their own reference
+	hive::Searcher searcher_;
+	std::thread thread_; // declared last: starts once everything above exists
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <SFML/System.hpp>
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+// Rolling timing window for one section of the frame (update, render, ...).
+// begin()/end() bracket the section; averages cover the last kWindow frames.
+class SectionTimer {
+public:
+	static constexpr int kWindow = 120;
+
+	void begin() { clock_.restart(); }
+	void end() { push(clock_.getElapsedTime().asMicroseconds()); }
+
+	void push(sf::Int64 micros) {
+		samples_[next_] = micros;
+		next_ = (next_ + 1) % kWindow;
+		count_ = std::min(count_ + 1, kWindow);
+	}
+
+	float avgMs() const {
+		if (count_ == 0) return 0.f;
+		sf::Int64 sum = 0;
+		for (int i = 0; i < count_; ++i) sum += samples_[i];
+		return static_cast<float>(sum) / static_cast<float>(count_) / 1000.f;
+	}
+
+	// standard deviation of the window: frame pacing jitter when fed frame intervals
+	float stddevMs() const {
+		if (count_ < 2) return 0.f;
+		const double mean = avgMs() * 1000.0;
+		double var = 0.0;
+		for (int i = 0; i < count_; ++i) {
+			const double d = static_cast<double>(samples_[i]) - mean;
+			var += d * d;
+		}
+		return static_cast<float>(std::sqrt(var / count_) / 1000.0);
+	}
+
+	float maxMs() const {
+		sf::Int64 m = 0;
+		for (int i = 0; i < count_; ++i) m = std::max(m, samples_[i]);
+		return static_cast<float>(m) / 1000.f;
+	}
+
+private:
+	std::array<sf::Int64, kWindow> samples_{};
+	int next_{ 0 };
+	int count_{ 0 };
+	sf::Clock clock_;
+};
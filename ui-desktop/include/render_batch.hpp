@@ -0,0 +1,31 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <string>
+
+// Batched geometry: hexes are appended as triangles to a caller-owned vertex
+// array, so a whole layer (fills, outlines, rings) goes out in one draw call.
+// Hexes are pointy-top with the first corner at -30 degrees, matching axialToPixel.
+void appendHexFill(sf::VertexArray& va, sf::Vector2f center, float size, sf::Color fill);
+// Outline band grown outward from the hex edge, like sf::Shape outlines.
+void appendHexOutline(sf::VertexArray& va, sf::Vector2f center, float size, sf::Color outline, float thickness);
+
+// Glyph-atlas text batcher: strings become textured quads against the font's
+// glyph page for one character size, so all labels of that size share one draw.
+class TextBatch {
+public:
+	void begin(const sf::Font& font, unsigned characterSize);
+
+	// Centres the string's ink box on `center`, anchoring vertically at 70% of
+	// the box height (same placement the per-label sf::Text used).
+	void addCentered(const std::string& s, sf::Vector2f center, sf::Color color);
+
+	bool empty() const { return verts_.getVertexCount() == 0; }
+	const sf::VertexArray& vertices() const { return verts_; }
+	// Query after all add calls: adding glyphs may grow the atlas page.
+	sf::RenderStates states() const;
+
+private:
+	const sf::Font* font_{ nullptr };
+	unsigned size_{ 0 };
+	sf::VertexArray verts_{ sf::Triangles };
+};
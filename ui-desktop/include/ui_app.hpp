@@ -1,35 +1,48 @@
 ﻿#pragma once
 #include <SFML/Graphics.hpp>
 #include <unordered_map>
+#include <unordered_set>
 #include <optional>
 #include <vector>
 #include <cstdint>
 #include "engine.hpp"
 #include "rules.hpp"
+#include "frame_stats.hpp"
+#include "render_batch.hpp"
+#include "engine_worker.hpp"
+#include "replay.hpp"
 
 
 class UIApp {
 public:
-	UIApp();
+	// with a game file, starts in replay mode on its first record
+	explicit UIApp(const std::string& replayPath = {});
 	void run();
 
 
 private:
 	// lifecycle
 	void handleEvents();
-	void update();
+	void update(float dt); // dt in seconds
+	void applyPacing();
 	void render();
 
 	// helpers
-	static sf::ConvexShape makeHex(float size);
 	static hive::Axial pixelToAxial(sf::Vector2f p, float s);
+	hive::Axial axialAtScreen(sf::Vector2i screen) const; // O(1): pixel -> axial with cube rounding
 
 	// render helpers (kept private)
 	void drawBackgroundGrid(sf::RenderTarget& rt, float baseSize);
+	void rebuildGridTexture(float baseSize);
+	void rebuildGridRingOverlay(float baseSize);
 	void drawBoardHexes(sf::RenderTarget& rt, float baseSize);
 	void drawPieceLabels(sf::RenderTarget& rt, float baseSize);
 	void drawLegalTargets(sf::RenderTarget& rt, float baseSize);
 	void drawHoverOutline(sf::RenderTarget& rt, float baseSize);
+	void drawFrameStats(sf::RenderTarget& rt);
+
+	// every draw goes through here so the HUD can report draw calls per frame
+	void submit(sf::RenderTarget& rt, const sf::Drawable& d, const sf::RenderStates& states = sf::RenderStates::Default);
 
 	// ring animation helpers
 	static std::int64_t ringKey(hive::Axial a);
@@ -38,32 +51,36 @@ private:
 	// UI tray
 	void drawPieceTray(sf::RenderTarget& rt);
 
-	// turn management
-	hive::Color currentTurn_{ hive::Color::White };
-	// helper to toggle turns
-	inline void nextTurn() {
-		currentTurn_ = (currentTurn_ == hive::Color::White) ? hive::Color::Black
-			: hive::Color::White;
-	}
-
-	// Placement / reserves
-	void initReservesFromBoard();
-	std::vector<hive::Axial> computePlacementTargets(hive::Color c) const;
+	// Placement (hand counts and turn live in state_)
 	bool hitTestTray(sf::Vector2f pt, hive::Color& outColor, hive::Bug& outBug) const;
 
 	struct TrayItem { sf::FloatRect rect; hive::Color color; hive::Bug bug; };
 	mutable std::vector<TrayItem> trayItems_;
 
-	// piece reserves and placement
-	std::unordered_map<hive::Bug, int> remainingWhite_;
-	std::unordered_map<hive::Bug, int> remainingBlack_;
+	// armed tray piece
 	std::optional<std::pair<hive::Color, hive::Bug>> pendingPlace_;
 
-	// placement helpers
-	bool queenPlaced(hive::Color c) const;
-	int  placementsMade(hive::Color c) const;
-	bool adjacentToColor(hive::Axial a, hive::Color c) const;
-	bool adjacentToOpponent(hive::Axial a, hive::Color c) const;
+	// game flow; every position change goes through playMove()
+	void playMove(const hive::Move& m);
+	void newGame(hive::Ruleset ruleset);
+	bool selectable(int pid) const; // own piece, or an enemy one next to our Pillbug/Mosquito
+	void selectPiece(int pid);
+	void armPlacement(hive::Color c, hive::Bug b);
+	void clearSelection();   // user-facing: drop selection, resume analysis
+	void resetSelection();   // fields only
+	void cancelEngineWork();
+
+	// replay mode: the board shows a recorded game and only moves along it
+	bool loadReplayGame(std::size_t index);
+	bool replayKey(sf::Keyboard::Key key); // true when the key navigated
+	void replayMoved();                    // state_ was moved along the record
+	void drawReplayBar(sf::RenderTarget& rt);
+
+	// engine worker: targets, analysis and engine moves off the render thread
+	void pollEngine();
+	void restartAnalysis();
+	int focusPieceId() const; // selected board piece or armed hand piece, else -1
+	void drawAnalysis(sf::RenderTarget& rt);
 
 	// data
 	sf::RenderWindow window_;
@@ -86,10 +103,66 @@ private:
 	std::vector<hive::Axial> legalTargets_;
 	std::unordered_map<std::int64_t, float> ringAlpha_; // key: packed (q,r) -> alpha [0..1]
 
+	// timing: animations run on real elapsed time, optionally in fixed steps (F4)
+	enum class Pacing { Cap60, VSync, Uncapped }; // cycle with F5
+	sf::Clock frameClock_;
+	Pacing pacing_{ Pacing::Cap60 };
+	bool fixedTimestep_{ false };
+	float fixedAccumulator_{ 0.f };
+
 	// feedback
 	float queenWarningTimer_{ 0.f }; // counts down from 2.0f when warning about missing queen
 	float moveBeforeQueenTimer_{ 0.f };   //fade-out warning when moving before queen
 
+	// frame-time instrumentation (toggle with F3)
+	SectionTimer frameTimer_;   // interval between frames: pacing
+	SectionTimer updateTimer_;
+	SectionTimer renderTimer_;  // building the frame, excluding display()
+	SectionTimer presentTimer_; // display(): swap plus any vsync/cap wait
+	bool showFrameStats_{ false };
+	int drawCalls_{ 0 };      // draw calls issued so far this frame
+	int lastDrawCalls_{ 0 };  // total of the previous frame (shown in the HUD)
+
+	// batched board layers, reused every frame (clear() keeps capacity)
+	sf::VertexArray boardFills_{ sf::Triangles };
+	sf::VertexArray boardOutlines_{ sf::Triangles };
+	sf::VertexArray ringVerts_{ sf::Triangles };
+	TextBatch labelBatch_;
+
+	// engine worker state; replies are matched by ticket, stale ones are dropped
+	EngineWorker worker_;
+	std::uint64_t targetsTicket_{ 0 };
+	std::uint64_t analysisTicket_{ 0 };
+	std::uint64_t engineMoveTicket_{ 0 };
+	bool analysisOn_{ false };                 // toggle with A
+	std::optional<hive::SearchInfo> analysis_; // latest streamed depth
+	// with a piece selected, analysis is multi-PV over its moves; each line's
+	// score lands on its target ring, keyed like ringAlpha_
+	bool analysisFocused_{ false };
+	std::unordered_map<std::int64_t, int> ringScore_;
+	TextBatch ringLabels_;
+
+	// replay: the archive is indexed only as far as the games visited, and the
+	// shown game has a keyframe index, so any ply is a restore plus a few moves
+	hive::RecordArchive archive_;
+	std::optional<hive::GameReplay> replay_;
+	std::size_t replayGame_{ 0 };
+
+	// empty neighbors of the hive, recomputed only when the position changes
+	std::unordered_set<std::int64_t> brightCells_;
+	int brightPly_{ -1 };
+
 	// animated alpha for the "white neighbor grid" ring (like teal rings)
 	std::unordered_map<std::int64_t, float> gridRingAlpha_;  // key: packed (q,r) -> alpha [0..1]
+	bool gridRingDirty_{ true };
+
+	// retained background grid: one lattice period larger than the window, rebuilt
+	// only on zoom or resize; panning just shifts the sprite within one period
+	sf::RenderTexture gridRT_;
+	sf::Sprite gridSprite_;
+	float gridHexSize_{ -1.0f };
+	sf::Vector2u gridWindowSize_{ 0u, 0u };
+	sf::VertexArray gridRingVerts_{ sf::Triangles }; // fading ring cells, world space
+	float gridRingHexSize_{ -1.0f };
+	bool gridRingEmptyBoard_{ false };
 };
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "engine_worker.hpp"
+
+EngineWorker::EngineWorker() : thread_([this] { run(); }) {}
+
+EngineWorker::~EngineWorker() {
+    {
+        std::lock_guard<std::mutex> lk(jobsMutex_);
+        quit_ = true;
+    }
+    searcher_.stop();
+    jobsCv_.notify_one();
+    thread_.join();
+}
+
+std::uint64_t EngineWorker::post(Job job) {
+    job.ticket = nextTicket_++;
+    job.generation = generation_.load();
+    const std::uint64_t ticket = job.ticket;
+    {
+        std::lock_guard<std::mutex> lk(jobsMutex_);
+        jobs_.push_back(std::move(job));
+    }
+    jobsCv_.notify_one();
+    return ticket;
+}
+
+std::uint64_t EngineWorker::requestMoveTargets(const hive::GameState& s, int pieceId) {
+    Job job;
+    job.kind = JobKind::MoveTargets;
+    job.state = s;
+    job.pieceId = pieceId;
+    return post(std::move(job));
+}
+
+std::uint64_t EngineWorker::requestPlacementTargets(const hive::GameState& s, hive::Color c) {
+    Job job;
+    job.kind = JobKind::PlacementTargets;
+    job.state = s;
+    job.color = c;
+    return post(std::move(job));
+}
+
+std::uint64_t EngineWorker::requestAnalysis(const hive::GameState& s, const hive::SearchLimits& limits) {
+    Job job;
+    job.kind = JobKind::Analysis;
+    job.state = s;
+    job.limits = limits;
+    return post(std::move(job));
+}
+
+std::uint64_t EngineWorker::requestPieceAnalysis(const hive::GameState& s, int pieceId, const hive::SearchLimits& limits) {
+    Job job;
+    job.kind = JobKind::PieceAnalysis;
+    job.state = s;
+    job.pieceId = pieceId;
+    job.limits = limits;
+    return post(std::move(job));
+}
+
+std::uint64_t EngineWorker::requestEngineMove(const hive::GameState& s, const hive::SearchLimits& limits) {
+    Job job;
+    job.kind = JobKind::EngineMove;
+    job.state = s;
+    job.limits = limits;
+    job.book = book_;
+    return post(std::move(job));
+}
+
+void EngineWorker::setBook(std::shared_ptr<const hive::OpeningBook> book) {
+    book_ = std::move(book);
+}
+
+void EngineWorker::cancel() {
+    {
+        std::lock_guard<std::mutex> lk(jobsMutex_);
+        jobs_.clear();
+    }
+    // bump the generation before stopping, so a search that is just starting
+    // either sees the stop or fails its generation check
+    generation_.fetch_add(1);
+    searcher_.stop();
+    std::lock_guard<std::mutex> lk(repliesMutex_);
+    replies_.clear();
+}
+
+bool EngineWorker::poll(Reply& out) {
+    std::lock_guard<std::mutex> lk(repliesMutex_);
+    if (replies_.empty()) return false;
+    out = std::move(replies_.front());
+    replies_.pop_front();
+    return true;
+}
+
+void EngineWorker::reply(std::uint64_t generation, Reply r) {
+    std::lock_guard<std::mutex> lk(repliesMutex_);
+    if (generation != generation_.load()) return; // cancelled meanwhile
+    replies_.push_back(std::move(r));
+}
+
+void EngineWorker::search(const Job& job) {
+    searcher_.clearStop();
+    if (job.generation != generation_.load()) return;
+    auto result = searcher_.search(job.state, job.limits, [&](const hive::SearchInfo& info) {
+        Reply ir;
+        ir.ticket = job.ticket;
+        ir.kind = ReplyKind::Info;
+        ir.info = info;
+        reply(job.generation, std::move(ir));
+    });
+    Reply r;
+    r.ticket = job.ticket;
+    r.kind = ReplyKind::BestMove;
+    r.best = result.best;
+    r.info.depth = result.depth;
+    r.info.score = result.score;
+    r.info.nodes = result.nodes;
+    r.info.pv = result.pv;
+    reply(job.generation, std::move(r));
+}
+
+void EngineWorker::run() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lk(jobsMutex_);
+            jobsCv_.wait(lk, [this] { return quit_ || !jobs_.empty(); });
+            if (quit_) return;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        if (job.generation != generation_.load()) continue;
+
+        Reply r;
+        r.ticket = job.ticket;
+        switch (job.kind) {
+        case JobKind::MoveTargets:
+            r.kind = ReplyKind::Targets;
+            if (job.state.queenPlaced(job.state.toMove())) {
+                // full rules: Pillbug throws (of either color) and the just-moved piece
+                for (const auto& mv : hive::generateMoves(job.state)) {
+                    if (!mv.isPlacement && mv.pieceId == job.pieceId) r.targets.push_back(mv.to);
+                }
+            }
+            else {
+                // shown anyway; the UI explains why it cannot move yet
+                for (const auto& mv : hive::legalMovesForPiece(job.state, job.pieceId)) r.targets.push_back(mv.to);
+            }
+            reply(job.generation, std::move(r));
+            break;
+        case JobKind::PlacementTargets:
+            r.kind = ReplyKind::Targets;
+            r.targets = hive::placementTargets(job.state, job.color);
+            reply(job.generation, std::move(r));
+            break;
+        case JobKind::PieceAnalysis:
+            // root moves are generated here rather than on the UI thread
+            job.limits.searchMoves.clear();
+            for (const auto& m : hive::generateMoves(job.state)) {
+                if (m.pieceId == job.pieceId) job.limits.searchMoves.push_back(m);
+            }
+            if (job.limits.searchMoves.empty()) break; // not movable now: nothing to rank
+            job.limits.multiPv = static_cast<int>(job.limits.searchMoves.size());
+            search(job);
+            break;
+        case JobKind::EngineMove:
+            if (job.book) {
+                if (auto m = job.book->pick(job.state)) {
+                    r.kind = ReplyKind::BestMove;
+                    r.best = *m;
+                    reply(job.generation, std::move(r));
+                    break;
+                }
+            }
+            search(job); // out of book
+            break;
+        case JobKind::Analysis:
+            search(job);
+            break;
+        }
+    }
+}
@@ -1,7 +1,8 @@
 #include "ui_app.hpp"
 
-int main() {
-    UIApp app;
+// hive_desktop [games.txt]: with a game file, opens it in replay mode
+int main(int argc, char** argv) {
+    UIApp app(argc > 1 ? argv[1] : "");
     app.run();
     return 0;
 }
\ No newline at end of file
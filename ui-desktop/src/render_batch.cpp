@@ -0,0 +1,90 @@
+#include "render_batch.hpp"
+#include "engine.hpp"
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+
+namespace {
+    std::array<sf::Vector2f, hive::kHexDirCount> hexCorners(sf::Vector2f c, float radius) {
+        std::array<sf::Vector2f, hive::kHexDirCount> pts{};
+        for (int i = 0; i < hive::kHexDirCount; ++i) {
+            float angle = static_cast<float>(std::numbers::pi) / 180.0f * (60.0f * static_cast<float>(i) - 30.0f);
+            pts[i] = c + sf::Vector2f(std::cos(angle), std::sin(angle)) * radius;
+        }
+        return pts;
+    }
+}
+
+void appendHexFill(sf::VertexArray& va, sf::Vector2f center, float size, sf::Color fill) {
+    if (fill.a == 0) return;
+    auto in = hexCorners(center, size);
+    for (int i = 0; i < hive::kHexDirCount; ++i) {
+        int j = (i + 1) % hive::kHexDirCount;
+        va.append(sf::Vertex(center, fill));
+        va.append(sf::Vertex(in[i], fill));
+        va.append(sf::Vertex(in[j], fill));
+    }
+}
+
+void appendHexOutline(sf::VertexArray& va, sf::Vector2f center, float size, sf::Color outline, float thickness) {
+    if (outline.a == 0 || thickness <= 0.f) return;
+    constexpr float kMiter = 1.1547005383792515f; // 1 / cos(30deg): corner offset per unit thickness
+    auto in = hexCorners(center, size);
+    auto out = hexCorners(center, size + thickness * kMiter);
+    for (int i = 0; i < hive::kHexDirCount; ++i) {
+        int j = (i + 1) % hive::kHexDirCount;
+        va.append(sf::Vertex(in[i], outline));
+        va.append(sf::Vertex(out[i], outline));
+        va.append(sf::Vertex(out[j], outline));
+        va.append(sf::Vertex(in[i], outline));
+        va.append(sf::Vertex(out[j], outline));
+        va.append(sf::Vertex(in[j], outline));
+    }
+}
+
+void TextBatch::begin(const sf::Font& font, unsigned characterSize) {
+    font_ = &font;
+    size_ = characterSize;
+    verts_.clear();
+}
+
+void TextBatch::addCentered(const std::string& s, sf::Vector2f center, sf::Color color) {
+    if (!font_ || s.empty()) return;
+
+    // lay glyphs out on a baseline at y = 0 and measure the ink box
+    float penX = 0.f;
+    float minX = 1e9f, minY = 1e9f, maxX = -1e9f, maxY = -1e9f;
+    const std::size_t first = verts_.getVertexCount();
+    for (char ch : s) {
+        const sf::Glyph& g = font_->getGlyph(static_cast<unsigned char>(ch), size_, false);
+        const float l = penX + g.bounds.left, t = g.bounds.top;
+        const float r = l + g.bounds.width, b = t + g.bounds.height;
+        minX = std::min(minX, l); minY = std::min(minY, t);
+        maxX = std::max(maxX, r); maxY = std::max(maxY, b);
+
+        const float u0 = static_cast<float>(g.textureRect.left);
+        const float v0 = static_cast<float>(g.textureRect.top);
+        const float u1 = u0 + static_cast<float>(g.textureRect.width);
+        const float v1 = v0 + static_cast<float>(g.textureRect.height);
+        verts_.append(sf::Vertex({ l, t }, color, { u0, v0 }));
+        verts_.append(sf::Vertex({ r, t }, color, { u1, v0 }));
+        verts_.append(sf::Vertex({ l, b }, color, { u0, v1 }));
+        verts_.append(sf::Vertex({ l, b }, color, { u0, v1 }));
+        verts_.append(sf::Vertex({ r, t }, color, { u1, v0 }));
+        verts_.append(sf::Vertex({ r, b }, color, { u1, v1 }));
+        penX += g.advance;
+    }
+    if (maxX < minX) return;
+
+    const sf::Vector2f origin(minX + (maxX - minX) / 2.f, minY + (maxY - minY) * 0.7f);
+    for (std::size_t i = first; i < verts_.getVertexCount(); ++i) {
+        verts_[i].position += center - origin;
+    }
+}
+
+sf::RenderStates TextBatch::states() const {
+    sf::RenderStates st;
+    if (font_) st.texture = &font_->getTexture(size_);
+    return st;
+}
@@ -1,10 +1,10 @@
 ﻿#include "ui_app.hpp"
 #include <cmath>
-#include <numbers>
 #include <algorithm>
 #include <unordered_set>
 #include <array>
 #include <string>
+#include <cstdio>
 
 using namespace hive;
 
@@ -12,23 +12,17 @@ using namespace hive;
 constexpr float ALPHA_FADE_OFF_TURN = 0.6f;
 constexpr float OVERLAY_Q_BY4_SEC = 2.0f;  // queen-by-4th overlay duration
 constexpr float OVERLAY_MOVE_BEFORE_Q_SEC = 2.0f;  // move-before-queen overlay duration
-constexpr float kRate = 0.20f; // smoothing factor per frame
+// Ring fades approach their target exponentially: 13.4/s matches the old
+// 0.20-per-frame step at 60 fps, now independent of the frame rate.
+constexpr float kFadeRatePerSec = 13.4f;
+constexpr float kFixedDt = 1.f / 120.f;   // fixed-timestep update interval
+constexpr int   kMaxFixedSteps = 8;       // per frame, so a stall cannot spiral
+constexpr float kMaxFrameDt = 0.25f;      // clamp long stalls (window drag, breakpoints)
+constexpr int   kReplayKeyframeEvery = 16; // plies between replay snapshots
+constexpr int   kReplayJump = 10;          // plies per Up/Down in replay mode
+
+static float smoothingFactor(float dt) { return 1.f - std::exp(-kFadeRatePerSec * dt); }
 // ===== helpers =====
-sf::ConvexShape UIApp::makeHex(float size) {
-    sf::ConvexShape hex; hex.setPointCount(6);
-    for (int i = 0; i < kHexDirCount; ++i) {
-        float angle = static_cast<float>(std::numbers::pi) / 180.0f * (60.0f * static_cast<float>(i) - 30.0f);
-        hex.setPoint(i, sf::Vector2f(
-            static_cast<float>(std::cos(angle) * size),
-            static_cast<float>(std::sin(angle) * size))
-        );
-    }
-    hex.setOutlineThickness(3.0f);
-    hex.setOutlineColor(sf::Color::Black);
-    hex.setFillColor(sf::Color(235, 235, 235));
-    return hex;
-}
-
 static Axial cubeToAxial(float x, float z) { return { (int)std::round(x), (int)std::round(z) }; }
 
 Axial UIApp::pixelToAxial(sf::Vector2f p, float s) {
@@ -49,25 +43,57 @@ Axial UIApp::pixelToAxial(sf::Vector2f p, float s) {
     return cubeToAxial(rx, rz);
 }
 
+Axial UIApp::axialAtScreen(sf::Vector2i screen) const {
+    sf::Vector2f world = sf::Vector2f(static_cast<float>(screen.x), static_cast<float>(screen.y)) - offset_;
+    return pixelToAxial(world, hexSize_);
+}
+
 // ===== lifecycle =====
-UIApp::UIApp() : window_(sf::VideoMode(1024, 768), "Hive (Desktop) – Kickstart", sf::Style::Default, sf::ContextSettings(0u, 0u, 8u)) {
-    window_.setFramerateLimit(60);
+UIApp::UIApp(const std::string& replayPath) : window_(sf::VideoMode(1024, 768), "Hive (Desktop) – Kickstart", sf::Style::Default, sf::ContextSettings(0u, 0u, 8u)) {
+    applyPacing();
 
     fontOk_ = font_.loadFromFile("assets/DejaVuSans.ttf");
+    // optional: built with tools/hive_book; without it the engine always searches
+    auto book = std::make_shared<hive::OpeningBook>();
+    if (book->load("assets/opening.book")) worker_.setBook(std::move(book));
     offset_ = sf::Vector2f(512.f, 384.f);
 
-    // start with White
-    currentTurn_ = hive::Color::White;
-
-    // initialize unplaced piece reserves based on base Hive counts minus current board
-    initReservesFromBoard();
+    if (!replayPath.empty() && !(archive_.open(replayPath) && loadReplayGame(0))) {
+        std::fprintf(stderr, "no game records in %s\n", replayPath.c_str());
+    }
 }
 
 void UIApp::run() {
+    frameClock_.restart();
     while (window_.isOpen()) {
+        const sf::Int64 frameMicros = frameClock_.restart().asMicroseconds();
+        frameTimer_.push(frameMicros);
+        const float dt = std::min(static_cast<float>(frameMicros) / 1e6f, kMaxFrameDt);
+
         handleEvents();
-        update();
+        pollEngine();
+        updateTimer_.begin();
+        if (fixedTimestep_) {
+            fixedAccumulator_ += dt;
+            int steps = 0;
+            while (fixedAccumulator_ >= kFixedDt && steps < kMaxFixedSteps) {
+                update(kFixedDt);
+                fixedAccumulator_ -= kFixedDt;
+                ++steps;
+            }
+            if (steps == kMaxFixedSteps) fixedAccumulator_ = 0.f; // drop the backlog
+        }
+        else {
+            update(dt);
+        }
+        updateTimer_.end();
+        renderTimer_.begin();
         render();
+        renderTimer_.end();
+        // display() blocks for vsync or the frame cap: keep it out of render
+        presentTimer_.begin();
+        window_.display();
+        presentTimer_.end();
     }
 }
 
@@ -81,10 +107,42 @@ void UIApp::handleEvents() {
             continue;
         }
 
+        if (replay_ && e.type == sf::Event::KeyPressed && replayKey(e.key.code)) continue;
+        // the replayed game is read-only: no clicks on board or tray, no engine moves
+        if (replay_ && e.type == sf::Event::MouseButtonPressed && e.mouseButton.button == sf::Mouse::Left) continue;
+        if (replay_ && e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::E) continue;
+
+        if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::F3) {
+            showFrameStats_ = !showFrameStats_;
+        }
+        if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::F4) {
+            fixedTimestep_ = !fixedTimestep_;
+            fixedAccumulator_ = 0.f;
+        }
+        if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::F5) {
+            pacing_ = pacing_ == Pacing::Cap60 ? Pacing::VSync
+                : pacing_ == Pacing::VSync ? Pacing::Uncapped : Pacing::Cap60;
+            applyPacing();
+        }
         if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::Escape) {
-            pendingPlace_.reset();
-            selectedPid_ = -1;
-            legalTargets_.clear();
+            clearSelection();
+        }
+        if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::A) {
+            analysisOn_ = !analysisOn_;
+            clearSelection(); // stops a running search when switching off
+        }
+        if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::X) {
+            // new game, switching between the base set and the M/L/P expansions
+            newGame(state_.ruleset() == hive::Ruleset::Base ? hive::Ruleset::MLP : hive::Ruleset::Base);
+        }
+        if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::E) {
+            // engine plays for the side to move (from the book while in book);
+            // analysis resumes after its move
+            resetSelection();
+            cancelEngineWork();
+            hive::SearchLimits limits;
+            limits.moveTimeMs = 1500;
+            engineMoveTicket_ = worker_.requestEngineMove(state_, limits);
         }
         if (e.type == sf::Event::Closed) window_.close();
         if (e.type == sf::Event::MouseLeft) { hoverAx_.reset(); }
@@ -112,19 +170,17 @@ void UIApp::handleEvents() {
             sf::Vector2i mp = sf::Mouse::getPosition(window_);
             sf::Vector2f screenPt(static_cast<float>(mp.x), static_cast<float>(mp.y));
             hive::Color hitColor; hive::Bug hitBug;
-            // turn restriction: only arm pieces for currentTurn_
+            // turn restriction: only arm pieces for the side to move
             if (hitTestTray(screenPt, hitColor, hitBug)) {
                 
-                if (hitColor == currentTurn_) {
+                if (hitColor == state_.toMove()) {
                     // arm pending placement if we have remaining pieces of that kind
-                    auto& rem = (hitColor == hive::Color::White) ? remainingWhite_ : remainingBlack_;
-                    if (!queenPlaced(hitColor) && placementsMade(hitColor) >= 3 && hitBug != hive::Bug::Queen) {
+                    if (!state_.queenPlaced(hitColor) && state_.placementsMade(hitColor) >= 3 && hitBug != hive::Bug::Queen) {
                         // trigger warning banner
                         queenWarningTimer_ = OVERLAY_Q_BY4_SEC;
                     }
-                    else if (rem[hitBug] > 0) {
-                        pendingPlace_ = std::make_pair(hitColor, hitBug);
-                        legalTargets_ = computePlacementTargets(hitColor);
+                    else if (state_.inHand(hitColor, hitBug) > 0) {
+                        armPlacement(hitColor, hitBug);
                     }
 				}
 				else {
@@ -135,8 +191,7 @@ void UIApp::handleEvents() {
             }
 
             // Compute axial under the cursor at click time (works for empty cells too)
-            sf::Vector2f world = sf::Vector2f(static_cast<float>(mp.x), static_cast<float>(mp.y)) - offset_;
-            Axial clickAx = pixelToAxial(world, hexSize_);
+            Axial clickAx = axialAtScreen(mp);
 
             if (pendingPlace_) {
                 // If a tray piece is armed, only allow placement onto a legal target
@@ -145,18 +200,7 @@ void UIApp::handleEvents() {
 
                 if (isTarget) {
                     auto [pc, pb] = *pendingPlace_;
-                    state_.addDemoPiece(pb, pc, clickAx);
-                    auto& rem = (pc == hive::Color::White) ? remainingWhite_ : remainingBlack_;
-                    if (rem[pb] > 0) rem[pb] -= 1;
-                    auto go = evaluateGameOver(state_);
-                    if (go != hive::GameOver::None) {
-                        gameOver_ = true;
-                        gameOverState_ = go;
-                    }
-                    pendingPlace_.reset();
-                    legalTargets_.clear(); // rings will fade out via animation
-                    // switch turn after a successful placement
-                    nextTurn();
+                    playMove({ state_.nextInHand(pc, pb), clickAx, /*isPlacement=*/true });
                 }
                 // If not a legal target, ignore (keep pending)
                 continue;
@@ -166,35 +210,30 @@ void UIApp::handleEvents() {
                 // Deselect if clicking the same piece
                 auto it = state_.board().find(clickAx);
                 if (it != state_.board().end() && !it->second.empty() && it->second.back() == selectedPid_) {
-                    selectedPid_ = -1;
-                    legalTargets_.clear();
+                    clearSelection();
                 }
                 else {
                     // Move only to a legal (teal-ring) target — supports empty cells too
                     auto isTarget = std::find_if(legalTargets_.begin(), legalTargets_.end(), [&](const Axial& a) { return a.q == clickAx.q && a.r == clickAx.r; }) != legalTargets_.end();
                     if (isTarget) {
                         // Block moving until the current player's queen is placed
-                        if (!queenPlaced(currentTurn_)) {
+                        if (!state_.queenPlaced(state_.toMove())) {
                             moveBeforeQueenTimer_ = OVERLAY_MOVE_BEFORE_Q_SEC;   // show message
-                            // clear legal targets so rings fade out:
-                            legalTargets_.clear();
-							//reset selection too
-                            selectedPid_ = -1;
+                            // rings fade out, selection resets
+                            clearSelection();
                         }
                         else {
-                            state_.movePiece(selectedPid_, clickAx, /*allowStack=*/true);
-                            // ... after state_.movePiece(...)
-                            auto go = evaluateGameOver(state_);
-                            if (go != hive::GameOver::None) {
-                                gameOver_ = true;
-                                gameOverState_ = go;
-                            }
-                            selectedPid_ = -1;
-                            legalTargets_.clear();
-                            // switch turn after a successful move
-                            nextTurn();
+                            playMove({ selectedPid_, clickAx, /*isPlacement=*/false });
                         }
                     }
+                    else if (it != state_.board().end() && selectable(it->second.back())) {
+                        // clicked another movable piece: switch selection
+                        selectPiece(it->second.back());
+                    }
+                    else {
+                        // clicked elsewhere: drop the selection and any pending target query
+                        clearSelection();
+                    }
                 }
             }
             else {
@@ -202,13 +241,8 @@ void UIApp::handleEvents() {
                 auto it = state_.board().find(clickAx);
                 if (it != state_.board().end() && !it->second.empty()) {
                     int topPid = it->second.back();
-                    const Piece& top = state_.pieces()[topPid];
-                    if (top.color == currentTurn_) {            // ← Enforce turn on selection
-                        selectedPid_ = topPid;
-                        legalTargets_.clear();
-                        for (const auto& mv : legalMovesForPiece(state_, selectedPid_)) {
-                            legalTargets_.push_back(mv.to);
-                        }
+                    if (selectable(topPid)) {         // ← Enforce turn on selection
+                        selectPiece(topPid);
                     }
                 }
             }
@@ -216,28 +250,226 @@ void UIApp::handleEvents() {
     }
 }
 
-void UIApp::update() {
-    if (!window_.hasFocus()) { hoverAx_.reset(); return; }
+// ===== game flow + engine worker =====
+void UIApp::resetSelection() {
+    pendingPlace_.reset();
+    selectedPid_ = -1;
+    legalTargets_.clear(); // rings will fade out via animation
+    ringScore_.clear();
+}
 
-    // Mouse in window coords -> world coords
-    sf::Vector2i m = sf::Mouse::getPosition(window_);
-    sf::Vector2f world = sf::Vector2f(static_cast<float>(m.x), static_cast<float>(m.y)) - offset_;
+void UIApp::cancelEngineWork() {
+    worker_.cancel();
+    targetsTicket_ = analysisTicket_ = engineMoveTicket_ = 0;
+}
 
-    // Find nearest existing board cell; only hover if close enough
-    std::optional<Axial> best;
-    float bestDist2 = (hexSize_ * 0.85f) * (hexSize_ * 0.85f); // radius threshold^2
+void UIApp::clearSelection() {
+    resetSelection();
+    cancelEngineWork();
+    restartAnalysis();
+}
 
-    for (const auto& [pos, stack] : state_.board()) {
-        Pixel p = axialToPixel(pos, hexSize_);
-        float dx = world.x - static_cast<float>(p.x);
-        float dy = world.y - static_cast<float>(p.y);
-        float d2 = dx * dx + dy * dy;
-        if (d2 < bestDist2) {
-            bestDist2 = d2;
-            best = pos;
+bool UIApp::selectable(int pid) const {
+    const Piece& p = state_.pieces()[pid];
+    if (p.color == state_.toMove()) return true;
+    // an enemy piece may be thrown by one of our Pillbugs (or a Mosquito copying one)
+    for (int i = 0; i < hive::kHexDirCount; ++i) {
+        auto it = state_.board().find(hive::add(p.pos, hive::dir(i)));
+        if (it == state_.board().end()) continue;
+        const Piece& n = state_.pieces()[it->second.back()];
+        if (n.color == state_.toMove() && (n.bug == Bug::Pillbug || n.bug == Bug::Mosquito)) return true;
+    }
+    return false;
+}
+
+void UIApp::newGame(hive::Ruleset ruleset) {
+    cancelEngineWork();
+    resetSelection();
+    replay_.reset(); // a new game leaves replay mode
+    state_ = hive::GameState(ruleset);
+    gameOver_ = false;
+    gameOverState_.reset();
+    analysis_.reset();
+    animPos_.clear();
+    brightPly_ = -1;
+    gridRingDirty_ = true;
+    restartAnalysis();
+}
+
+// ===== replay mode =====
+bool UIApp::loadReplayGame(std::size_t index) {
+    auto record = archive_.get(index);
+    if (!record) return false;
+    replay_.emplace(std::move(*record), kReplayKeyframeEvery);
+    replayGame_ = index;
+    state_ = hive::GameState(replay_->record().ruleset);
+    animPos_.clear();
+    replayMoved();
+    return true;
+}
+
+bool UIApp::replayKey(sf::Keyboard::Key key) {
+    switch (key) {
+    case sf::Keyboard::Right: if (!replay_->forward(state_)) return true; break;
+    case sf::Keyboard::Left: if (!replay_->back(state_)) return true; break;
+    case sf::Keyboard::Up: replay_->seek(state_, state_.ply() + kReplayJump); break;
+    case sf::Keyboard::Down: replay_->seek(state_, state_.ply() - kReplayJump); break;
+    case sf::Keyboard::Home: replay_->seek(state_, 0); break;
+    case sf::Keyboard::End: replay_->seek(state_, replay_->length()); break;
+    case sf::Keyboard::PageDown: loadReplayGame(replayGame_ + 1); return true;
+    case sf::Keyboard::PageUp: if (replayGame_ > 0) loadReplayGame(replayGame_ - 1); return true;
+    default: return false;
+    }
+    replayMoved();
+    return true;
+}
+
+void UIApp::replayMoved() {
+    // game over is shown in the replay bar; navigation stays live
+    gameOver_ = false;
+    gameOverState_.reset();
+    analysis_.reset();
+    brightPly_ = -1; // another game can reach the same ply
+    gridRingDirty_ = true;
+    clearSelection();
+}
+
+void UIApp::drawReplayBar(sf::RenderTarget& rt) {
+    if (!fontOk_ || !replay_) return;
+    const hive::GameOver over = evaluateGameOver(state_);
+    const char* result = over == hive::GameOver::WhiteWins ? "  White wins"
+        : over == hive::GameOver::BlackWins ? "  Black wins" : over == hive::GameOver::Draw ? "  Draw" : "";
+    char text[192];
+    std::snprintf(text, sizeof(text), "Replay  game %zu/%zu%s  ply %d/%d%s\n"
+        "Left/Right ply   Up/Down %d   Home/End   PgUp/PgDn game",
+        replayGame_ + 1, archive_.indexed(), archive_.complete() ? "" : "+", state_.ply(), replay_->length(), result,
+        kReplayJump);
+
+    sf::Text t; t.setFont(font_);
+    t.setCharacterSize(14);
+    t.setString(text);
+    t.setFillColor(sf::Color(220, 220, 220));
+    const sf::FloatRect lb = t.getLocalBounds();
+    t.setPosition(static_cast<float>(window_.getSize().x) - lb.width - 16.f, 10.f);
+
+    sf::FloatRect tb = t.getGlobalBounds();
+    sf::RectangleShape bg;
+    bg.setPosition(tb.left - 6.f, tb.top - 6.f);
+    bg.setSize(sf::Vector2f(tb.width + 12.f, tb.height + 12.f));
+    bg.setFillColor(sf::Color(55, 55, 55, 200));
+    submit(rt, bg);
+    submit(rt, t);
+}
+
+void UIApp::selectPiece(int pid) {
+    resetSelection();
+    cancelEngineWork();
+    selectedPid_ = pid;
+    targetsTicket_ = worker_.requestMoveTargets(state_, pid);
+    restartAnalysis();
+}
+
+void UIApp::armPlacement(hive::Color c, hive::Bug b) {
+    resetSelection();
+    cancelEngineWork();
+    pendingPlace_ = std::make_pair(c, b);
+    targetsTicket_ = worker_.requestPlacementTargets(state_, c);
+    restartAnalysis();
+}
+
+void UIApp::playMove(const hive::Move& m) {
+    state_.play(m); // passes the turn
+    auto go = evaluateGameOver(state_);
+    if (go != hive::GameOver::None) {
+        gameOver_ = true;
+        gameOverState_ = go;
+    }
+    analysis_.reset();
+    clearSelection(); // analysis restarts on the new position unless the game ended
+}
+
+void UIApp::restartAnalysis() {
+    if (!analysisOn_ || gameOver_) {
+        analysisTicket_ = 0;
+        analysis_.reset();
+        return;
+    }
+    // queued behind any target query, so the rings never wait on the search
+    hive::SearchLimits limits;
+    limits.maxDepth = 6;
+    const int focus = focusPieceId();
+    analysisFocused_ = focus >= 0;
+    analysisTicket_ = analysisFocused_ ? worker_.requestPieceAnalysis(state_, focus, limits)
+                                       : worker_.requestAnalysis(state_, limits);
+}
+
+int UIApp::focusPieceId() const {
+    if (selectedPid_ >= 0) return selectedPid_;
+    if (pendingPlace_) return state_.nextInHand(pendingPlace_->first, pendingPlace_->second);
+    return -1;
+}
+
+void UIApp::pollEngine() {
+    EngineWorker::Reply r;
+    while (worker_.poll(r)) {
+        if (r.ticket == targetsTicket_ && r.kind == EngineWorker::ReplyKind::Targets) {
+            legalTargets_ = std::move(r.targets);
+        }
+        else if (r.ticket == analysisTicket_) {
+            if (r.info.pv.empty()) continue;
+            if (r.info.multiPv == 1) analysis_ = r.info;
+            if (analysisFocused_ && r.kind == EngineWorker::ReplyKind::Info) {
+                ringScore_[ringKey(r.info.pv.front().to)] = r.info.score;
+            }
+        }
+        else if (r.ticket == engineMoveTicket_ && r.kind == EngineWorker::ReplyKind::BestMove && !gameOver_) {
+            engineMoveTicket_ = 0;
+            playMove(r.best);
         }
     }
-    hoverAx_ = best; // clears when not near any tile
+}
+
+void UIApp::drawAnalysis(sf::RenderTarget& rt) {
+    if (!fontOk_ || !analysisOn_) return;
+    std::string text = "Analysis: thinking...";
+    if (analysis_) {
+        char head[96];
+        std::snprintf(head, sizeof(head), "Analysis d%d  %+d  (%lld nodes)", analysis_->depth, analysis_->score,
+            static_cast<long long>(analysis_->nodes));
+        text = head;
+        text += "\nPV:";
+        for (size_t i = 0; i < analysis_->pv.size() && i < 6; ++i) text += " " + moveToString(state_, analysis_->pv[i]);
+    }
+
+    sf::Text t; t.setFont(font_);
+    t.setCharacterSize(14);
+    t.setString(text);
+    t.setFillColor(sf::Color(220, 220, 220));
+    t.setPosition(10.f, 48.f);
+
+    sf::FloatRect tb = t.getGlobalBounds();
+    sf::RectangleShape bg;
+    bg.setPosition(tb.left - 6.f, tb.top - 6.f);
+    bg.setSize(sf::Vector2f(tb.width + 12.f, tb.height + 12.f));
+    bg.setFillColor(sf::Color(55, 55, 55, 200));
+    submit(rt, bg);
+    submit(rt, t);
+}
+
+void UIApp::applyPacing() {
+    // never combine a frame limit with vsync: the two fight and cause judder
+    window_.setVerticalSyncEnabled(pacing_ == Pacing::VSync);
+    window_.setFramerateLimit(pacing_ == Pacing::Cap60 ? 60u : 0u);
+}
+
+void UIApp::update(float dt) {
+    if (!window_.hasFocus()) { hoverAx_.reset(); return; }
+    const float fade = smoothingFactor(dt); // share of the gap closed this step
+
+    // Hex under the cursor, then a single board lookup: hover only occupied tiles
+    Axial ax = axialAtScreen(sf::Mouse::getPosition(window_));
+    if (occupied(state_, ax)) hoverAx_ = ax;
+    else hoverAx_.reset();
 
     // --- Animate teal ring alphas (appear/disappear) ---
     std::unordered_set<std::int64_t> current;
@@ -247,7 +479,7 @@ void UIApp::update() {
     // Fade in current targets toward 1.0
     for (std::int64_t k : current) {
         float& alpha = ringAlpha_[k];
-        alpha += (1.0f - alpha) * kRate;
+        alpha += (1.0f - alpha) * fade;
         if (alpha > 1.0f) alpha = 1.0f;
     }
 
@@ -256,54 +488,60 @@ void UIApp::update() {
     toErase.reserve(ringAlpha_.size());
     for (auto& kv : ringAlpha_) {
         if (current.find(kv.first) == current.end()) {
-            kv.second += (0.0f - kv.second) * kRate;
+            kv.second += (0.0f - kv.second) * fade;
             if (kv.second < 0.02f) toErase.push_back(kv.first);
         }
     }
-    for (std::int64_t k : toErase) ringAlpha_.erase(k);
+    for (std::int64_t key : toErase) ringAlpha_.erase(key);
 
     // --- Animate white grid neighbor ring (fade in/out like teal rings) ---
     {
-        // 1) Compute current neighbor-empties ("bright set")
-        std::unordered_set<std::int64_t> bright;
-        if (!state_.board().empty()) {
-            bright.reserve(state_.board().size() * 3);
+        // 1) Current neighbor-empties ("bright set"), only rescanned after a move
+        if (brightPly_ != state_.ply()) {
+            brightCells_.clear();
+            brightCells_.reserve(state_.board().size() * 3);
             for (const auto& [pos, stack] : state_.board()) {
                 for (int i = 0; i < kHexDirCount; ++i) {
                     Axial n = add(pos, dir(i));
                     if (!occupied(state_, n)) {
-                        bright.insert(ringKey(n));
+                        brightCells_.insert(ringKey(n));
                     }
                 }
             }
+            brightPly_ = state_.ply();
         }
+        const auto& bright = brightCells_;
 
         // 2) Fade in/out alphas
 
-        // Fade in for current bright cells
-        for (std::int64_t k : bright) {
-            float& a = gridRingAlpha_[k];
-            a += (1.0f - a) * kRate;
-            if (a > 1.0f) a = 1.0f;
+        // Fade in for current bright cells; snap to 1 so settled rings stop
+        // dirtying the retained overlay
+        for (std::int64_t key : bright) {
+            float& a = gridRingAlpha_[key];
+            if (a >= 1.0f) continue;
+            a += (1.0f - a) * fade;
+            if (a > 0.995f) a = 1.0f;
+            gridRingDirty_ = true;
         }
         // Fade out others and cull tiny
         toErase.clear();
         toErase.reserve(gridRingAlpha_.size());
         for (auto& kv : gridRingAlpha_) {
             if (bright.find(kv.first) == bright.end()) {
-                kv.second += (0.0f - kv.second) * kRate;
+                kv.second += (0.0f - kv.second) * fade;
                 if (kv.second < 0.02f) toErase.push_back(kv.first);
+                gridRingDirty_ = true;
             }
         }
-        for (auto k : toErase) gridRingAlpha_.erase(k);
+        for (auto key : toErase) gridRingAlpha_.erase(key);
     }
 
     if (queenWarningTimer_ > 0.f) {
-        queenWarningTimer_ -= 1.f / 60.f; // assuming 60 fps cap
+        queenWarningTimer_ -= dt;
         if (queenWarningTimer_ < 0.f) queenWarningTimer_ = 0.f;
     }
     if (moveBeforeQueenTimer_ > 0.f) {
-        moveBeforeQueenTimer_ -= 1.f / 60.f; // assuming 60 fps cap
+        moveBeforeQueenTimer_ -= dt;
         if (moveBeforeQueenTimer_ < 0.f) moveBeforeQueenTimer_ = 0.f;
     }
 }
@@ -324,157 +562,173 @@ hive::Axial UIApp::axialFromKey(std::int64_t k) {
     return { q,r };
 }
 
-void UIApp::drawBackgroundGrid(sf::RenderTarget& rt, float baseSize) {
-    // cached, faint grid with AA via 2x supersample
-    static sf::RenderTexture gridRT;
-    static sf::Sprite gridSprite;
-    static bool gridReady = false;
-    static float prevHexSize = -1.0f;
-    static sf::Vector2f prevOffset(99999.f, 99999.f);
-    static sf::Vector2u prevSize(0u, 0u);
-
-    if (prevSize != window_.getSize()) {
-        gridRT.create(window_.getSize().x * 2u, window_.getSize().y * 2u);
-        gridSprite.setTexture(gridRT.getTexture(), true);
-        gridSprite.setScale(0.5f, 0.5f); // downscale to 1x (AA)
-        prevSize = window_.getSize();
-    }
-    gridRT.clear(sf::Color(0, 0, 0, 0));
+void UIApp::rebuildGridTexture(float baseSize) {
+    // The hex lattice repeats every (sqrt3*s, 3*s) in pixels, so a texture one
+    // period larger than the window covers every pan position of this zoom level.
+    constexpr float SQ3 = 1.7320508075688772f;
+    const sf::Vector2f period(SQ3 * hexSize_, 3.0f * hexSize_);
+    const sf::Vector2u ws = window_.getSize();
+    const unsigned texW = static_cast<unsigned>(std::ceil(static_cast<float>(ws.x) + period.x));
+    const unsigned texH = static_cast<unsigned>(std::ceil(static_cast<float>(ws.y) + period.y));
 
-    // compute visible world corners
-    sf::Vector2u ws = window_.getSize();
-    sf::Vector2f tl(0.f, 0.f);
-    sf::Vector2f tr(static_cast<float>(ws.x), 0.f);
-    sf::Vector2f bl(0.f, static_cast<float>(ws.y));
-    sf::Vector2f br(static_cast<float>(ws.x), static_cast<float>(ws.y));
+    // 2x supersample for AA
+    gridRT_.create(texW * 2u, texH * 2u);
+    gridSprite_.setTexture(gridRT_.getTexture(), true);
+    gridSprite_.setScale(0.5f, 0.5f);
+    gridRT_.clear(sf::Color(0, 0, 0, 0));
 
-    Axial aTL = pixelToAxial(tl - offset_, hexSize_);
-    Axial aTR = pixelToAxial(tr - offset_, hexSize_);
-    Axial aBL = pixelToAxial(bl - offset_, hexSize_);
-    Axial aBR = pixelToAxial(br - offset_, hexSize_);
+    // lattice origin sits at `period` in texture space; cover the whole texture
+    Axial aTL = pixelToAxial(-period, hexSize_);
+    Axial aTR = pixelToAxial(sf::Vector2f(static_cast<float>(texW), 0.f) - period, hexSize_);
+    Axial aBL = pixelToAxial(sf::Vector2f(0.f, static_cast<float>(texH)) - period, hexSize_);
+    Axial aBR = pixelToAxial(sf::Vector2f(static_cast<float>(texW), static_cast<float>(texH)) - period, hexSize_);
 
     int minQ = std::min(std::min(aTL.q, aTR.q), std::min(aBL.q, aBR.q)) - 3;
     int maxQ = std::max(std::max(aTL.q, aTR.q), std::max(aBL.q, aBR.q)) + 3;
     int minR = std::min(std::min(aTL.r, aTR.r), std::min(aBL.r, aBR.r)) - 3;
     int maxR = std::max(std::max(aTL.r, aTR.r), std::max(aBL.r, aBR.r)) + 3;
 
-    auto gridHex = makeHex(baseSize * 2.0f);
-    gridHex.setFillColor(sf::Color(0, 0, 0, 0));
-    gridHex.setOutlineThickness(2.0f); // ~1px after downscale
-    gridHex.setOutlineColor(sf::Color(120, 120, 130, 60));
+    const sf::Color greyOutline(130, 130, 140, 50);
+    const sf::Color greyFill(140, 145, 155, 22);
 
-    // draw the grid, using animated white outline for neighbor ring, grey elsewhere
+    sf::VertexArray va(sf::Triangles);
     for (int q = minQ; q <= maxQ; ++q) {
         for (int r = minR; r <= maxR; ++r) {
-            Axial pos{ q, r };
-            Pixel p = axialToPixel(pos, hexSize_);
-
-            // Special-case: if board is empty, highlight {0,0} as bright
-            if (state_.board().empty() && q == 0 && r == 0) {
-                gridHex.setFillColor(sf::Color(0, 0, 0, 0));
-                gridHex.setOutlineColor(sf::Color(255, 255, 255, 120));
-                gridHex.setPosition(
-                    sf::Vector2f(offset_.x * 2.f, offset_.y * 2.f)
-                    + sf::Vector2f(p.x * 2.f, p.y * 2.f)
-                );
-                gridRT.draw(gridHex);
-                continue;  // skip normal grey/alpha handling for this cell
-            }
+            Pixel p = axialToPixel({ q, r }, hexSize_);
+            sf::Vector2f c = (period + sf::Vector2f(p.x, p.y)) * 2.f;
+            appendHexFill(va, c, baseSize * 2.0f, greyFill);
+            appendHexOutline(va, c, baseSize * 2.0f, greyOutline, 2.0f); // ~1px after downscale
+        }
+    }
+    submit(gridRT_, va);
+    gridRT_.display();
+    gridRT_.setSmooth(true);
 
-            // alpha for this cell in [0..1], default 0 if not present
-            float a = 0.f;
-            auto itA = gridRingAlpha_.find(ringKey(pos));
-            if (itA != gridRingAlpha_.end()) a = std::clamp(itA->second, 0.0f, 1.0f);
+    gridHexSize_ = hexSize_;
+    gridWindowSize_ = ws;
+}
 
-            // colors
-            const sf::Color whiteOutline(255, 255, 255, static_cast<sf::Uint8>(a * 128.f)); // fade to ~128 alpha
-            const sf::Color greyOutline(130, 130, 140, 50);
-            const sf::Color greyFill(140, 145, 155, 22); 
+void UIApp::rebuildGridRingOverlay(float baseSize) {
+    gridRingVerts_.clear();
 
-            // bright ring gets transparent fill; non-bright gets grey fill
-            const bool isBrightNow = (a > 0.001f);
+    // Special-case: if board is empty, highlight {0,0} as bright
+    if (state_.board().empty()) {
+        appendHexOutline(gridRingVerts_, { 0.f, 0.f }, baseSize, sf::Color(255, 255, 255, 120), 1.0f);
+    }
+    for (const auto& [key, alpha] : gridRingAlpha_) {
+        float a = std::clamp(alpha, 0.0f, 1.0f);
+        if (a <= 0.001f) continue;
+        Pixel p = axialToPixel(axialFromKey(key), hexSize_);
+        const sf::Color whiteOutline(255, 255, 255, static_cast<sf::Uint8>(a * 128.f)); // fade to ~128 alpha
+        appendHexOutline(gridRingVerts_, { p.x, p.y }, baseSize, whiteOutline, 1.0f);
+    }
 
-            gridHex.setOutlineColor(isBrightNow ? whiteOutline : greyOutline);
-            gridHex.setFillColor(isBrightNow ? sf::Color(0, 0, 0, 0) : greyFill);
+    gridRingHexSize_ = hexSize_;
+    gridRingEmptyBoard_ = state_.board().empty();
+    gridRingDirty_ = false;
+}
 
-            gridHex.setPosition(
-                sf::Vector2f(offset_.x * 2.f, offset_.y * 2.f)
-                + sf::Vector2f(p.x * 2.f, p.y * 2.f)
-            );
-            gridRT.draw(gridHex);
-        }
+void UIApp::drawBackgroundGrid(sf::RenderTarget& rt, float baseSize) {
+    // static grid: rebuilt on zoom or resize only
+    if (gridHexSize_ != hexSize_ || gridWindowSize_ != window_.getSize()) {
+        rebuildGridTexture(baseSize);
+    }
+
+    // pan: shift the cached texture by the offset modulo one lattice period
+    constexpr float SQ3 = 1.7320508075688772f;
+    const sf::Vector2f period(SQ3 * hexSize_, 3.0f * hexSize_);
+    sf::Vector2f phase(std::fmod(offset_.x, period.x), std::fmod(offset_.y, period.y));
+    if (phase.x < 0.f) phase.x += period.x;
+    if (phase.y < 0.f) phase.y += period.y;
+    gridSprite_.setPosition(phase - period);
+    submit(rt, gridSprite_);
+
+    // fading neighbor ring: rebuilt when its alphas change or on zoom, panned via transform
+    if (gridRingDirty_ || gridRingHexSize_ != hexSize_ || gridRingEmptyBoard_ != state_.board().empty()) {
+        rebuildGridRingOverlay(baseSize);
     }
-    gridRT.display();
-    gridRT.setSmooth(true);
-    gridReady = true;
-    prevHexSize = hexSize_;
-    prevOffset = offset_;
-    
-    rt.draw(gridSprite);
+    sf::Transform xf;
+    xf.translate(offset_);
+    submit(rt, gridRingVerts_, sf::RenderStates(xf));
 }
 
 void UIApp::drawBoardHexes(sf::RenderTarget& rt, float baseSize) {
-    auto hex = makeHex(baseSize);
+    // two layers so no tile's fill can cover a neighbour's outline
+    boardFills_.clear();
+    boardOutlines_.clear();
     for (const auto& [pos, stack] : state_.board()) {
         Pixel px = axialToPixel(pos, hexSize_);
-        hex.setPosition(offset_ + sf::Vector2f(px.x, px.y));
+        const sf::Vector2f c = offset_ + sf::Vector2f(px.x, px.y);
 
+        sf::Color fill(236, 240, 241);
         if (!stack.empty()) {
             const Piece& top = state_.pieces()[stack.back()];
-            hex.setFillColor(top.color == Color::White ? sf::Color(245, 245, 245) : sf::Color(30, 30, 30));
-        }
-        else {
-            hex.setFillColor(sf::Color(236, 240, 241));
+            fill = top.color == Color::White ? sf::Color(245, 245, 245) : sf::Color(30, 30, 30);
         }
+        sf::Color outline = sf::Color::Black;
         if (selectedPid_ >= 0 && !stack.empty() && stack.back() == selectedPid_) {
-            hex.setOutlineColor(sf::Color::Blue);
+            outline = sf::Color::Blue;
         }
         else if (hoverAx_ && *hoverAx_ == pos) {
-            hex.setOutlineColor(sf::Color(255, 180, 0));
+            outline = sf::Color(255, 180, 0);
         }
-        else {
-            hex.setOutlineColor(sf::Color::Black);
-        }
-        rt.draw(hex);
+        appendHexFill(boardFills_, c, baseSize, fill);
+        appendHexOutline(boardOutlines_, c, baseSize, outline, 3.0f);
     }
+    if (boardFills_.getVertexCount() > 0) submit(rt, boardFills_);
+    if (boardOutlines_.getVertexCount() > 0) submit(rt, boardOutlines_);
 }
 
 void UIApp::drawPieceLabels(sf::RenderTarget& rt, float baseSize) {
     if (!fontOk_) return;
+    labelBatch_.begin(font_, static_cast<unsigned>(baseSize * 0.6f));
     for (const auto& [pos, stack] : state_.board()) {
         if (stack.empty()) continue;
         const Piece& top = state_.pieces()[stack.back()];
-        char c = '?';
-        switch (top.bug) {
-        case Bug::Queen: c = 'Q'; break; case Bug::Ant: c = 'A'; break;
-        case Bug::Spider: c = 'S'; break; case Bug::Grasshopper: c = 'G'; break;
-        case Bug::Beetle: c = 'B'; break;
-        }
+        const char c = hive::bugChar(top.bug);
         Pixel px = axialToPixel(pos, hexSize_);
-        sf::Text t; t.setFont(font_);
-        t.setCharacterSize(static_cast<unsigned>(baseSize * 0.6f));
-        t.setString(std::string(1, c));
-        t.setFillColor(top.color == Color::White ? sf::Color::Black : sf::Color::White);
-        auto b = t.getLocalBounds();
-        t.setOrigin(b.left + b.width / 2.f, b.top + b.height * 0.7f);
-        t.setPosition(offset_.x + px.x, offset_.y + px.y);
-        rt.draw(t);
+        labelBatch_.addCentered(std::string(1, c), offset_ + sf::Vector2f(px.x, px.y),
+            top.color == Color::White ? sf::Color::Black : sf::Color::White);
     }
+    if (!labelBatch_.empty()) submit(rt, labelBatch_.vertices(), labelBatch_.states());
 }
 
 void UIApp::drawLegalTargets(sf::RenderTarget& rt, float baseSize) {
+    // scored rings shade from teal (best) to red by how much worse than the best they are
+    constexpr float kScoreSpread = 240.0f;
+    int best = -hive::kWinScore - 1;
+    for (const auto& kv : ringScore_) best = std::max(best, kv.second);
+
+    ringVerts_.clear();
+    const bool labels = fontOk_ && !ringScore_.empty();
+    if (labels) ringLabels_.begin(font_, static_cast<unsigned>(std::max(8.0f, baseSize * 0.32f)));
     for (const auto& kv : ringAlpha_) {
         float a = std::clamp(kv.second, 0.0f, 1.0f);
         if (a <= 0.001f) continue;
         Axial pos = axialFromKey(kv.first);
         Pixel p = axialToPixel(pos, hexSize_);
-        auto ring = makeHex(baseSize * 0.92f);
-        ring.setPosition(offset_ + sf::Vector2f(p.x, p.y));
-        ring.setFillColor(sf::Color(0, 0, 0, 0));
-        ring.setOutlineThickness(3.0f);
-        ring.setOutlineColor(sf::Color(0, 180, 180, static_cast<sf::Uint8>(a * 255.0f)));
-        rt.draw(ring);
+        const sf::Vector2f center = offset_ + sf::Vector2f(p.x, p.y);
+        const sf::Uint8 alpha = static_cast<sf::Uint8>(a * 255.0f);
+
+        sf::Color color(0, 180, 180, alpha);
+        float thickness = 3.0f;
+        auto sc = ringScore_.find(kv.first);
+        if (sc != ringScore_.end()) {
+            const float t = std::clamp((best - sc->second) / kScoreSpread, 0.0f, 1.0f);
+            color = sf::Color(static_cast<sf::Uint8>(0 + t * 210), static_cast<sf::Uint8>(180 - t * 120),
+                static_cast<sf::Uint8>(180 - t * 120), alpha);
+            if (sc->second == best) thickness = 5.0f;
+
+            char buf[16];
+            if (sc->second >= hive::kWinThreshold) std::snprintf(buf, sizeof(buf), "win");
+            else if (sc->second <= -hive::kWinThreshold) std::snprintf(buf, sizeof(buf), "loss");
+            else std::snprintf(buf, sizeof(buf), "%+d", sc->second);
+            ringLabels_.addCentered(buf, center, sf::Color(color.r, color.g, color.b, alpha));
+        }
+        appendHexOutline(ringVerts_, center, baseSize * 0.92f, color, thickness);
     }
+    if (ringVerts_.getVertexCount() > 0) submit(rt, ringVerts_);
+    if (labels && !ringLabels_.empty()) submit(rt, ringLabels_.vertices(), ringLabels_.states());
 }
 
 void UIApp::drawHoverOutline(sf::RenderTarget& rt, float baseSize) {
@@ -486,107 +740,12 @@ void UIApp::drawHoverOutline(sf::RenderTarget& rt, float baseSize) {
     }
     if (hasSelectedHere) return;
     Pixel px = axialToPixel(*hoverAx_, hexSize_);
-    auto h = makeHex(baseSize);
-    h.setPosition(offset_ + sf::Vector2f(px.x, px.y));
-    h.setFillColor(sf::Color(0, 0, 0, 0));
-    h.setOutlineThickness(4.0f);
-    h.setOutlineColor(sf::Color(255, 200, 60));
-    rt.draw(h);
-}
-
-// ===== tray + placement =====
-void UIApp::initReservesFromBoard() {
-    auto seed = [&](std::unordered_map<hive::Bug, int>& m) {
-        m[hive::Bug::Queen] = 1; m[hive::Bug::Spider] = 2; m[hive::Bug::Beetle] = 2; m[hive::Bug::Grasshopper] = 3; m[hive::Bug::Ant] = 3;
-        };
-    seed(remainingWhite_); seed(remainingBlack_);
-
-    // subtract already-placed pieces from reserves
-    for (size_t pid = 0; pid < state_.pieces().size(); ++pid) {
-        const auto& p = state_.pieces()[pid];
-        auto& rem = (p.color == hive::Color::White) ? remainingWhite_ : remainingBlack_;
-        if (rem[p.bug] > 0) { rem[p.bug] -= 1; }
-    }
+    sf::VertexArray h(sf::Triangles);
+    appendHexOutline(h, offset_ + sf::Vector2f(px.x, px.y), baseSize, sf::Color(255, 200, 60), 4.0f);
+    submit(rt, h);
 }
 
 // ===== placement helpers =====
-bool UIApp::queenPlaced(hive::Color c) const {
-    for (const auto& [pos, stack] : state_.board()) {
-        if (!stack.empty()) {
-            // scan full stack, not just top
-            for (int pid : stack) {
-                const Piece& p = state_.pieces()[pid];
-                if (p.color == c && p.bug == hive::Bug::Queen) return true;
-            }
-        }
-    }
-    return false;
-}
-
-int UIApp::placementsMade(hive::Color c) const {
-    // Total base Hive pieces per color = 11 (1Q, 2S, 2B, 3G, 3A)
-    auto total = 11;
-    const auto& rem = (c == hive::Color::White) ? remainingWhite_ : remainingBlack_;
-    int remaining = 0;
-    for (auto& kv : rem) remaining += kv.second;
-    return total - remaining;
-}
-
-bool UIApp::adjacentToColor(hive::Axial a, hive::Color c) const {
-    for (int i = 0; i < kHexDirCount; ++i) {
-        Axial n = add(a, dir(i));
-        auto it = state_.board().find(n);
-        if (it != state_.board().end() && !it->second.empty()) {
-            const auto& st = it->second;
-            const Piece& top = state_.pieces()[st.back()];
-            if (top.color == c) return true;
-        }
-    }
-    return false;
-}
-
-bool UIApp::adjacentToOpponent(hive::Axial a, hive::Color c) const {
-    hive::Color opp = (c == hive::Color::White) ? hive::Color::Black : hive::Color::White;
-    return adjacentToColor(a, opp);
-}
-
-std::vector<hive::Axial> UIApp::computePlacementTargets(hive::Color c) const {
-    std::unordered_set<std::int64_t> uniq;
-    std::vector<hive::Axial> out;
-
-    if (state_.board().empty()) {
-        out.push_back({ 0,0 });
-        return out;
-    }
-
-    // gather all empties adjacent to the hive
-    std::vector<hive::Axial> candidates;
-    candidates.reserve(state_.board().size() * 3);
-    for (const auto& [pos, stack] : state_.board()) {
-        for (int i = 0; i < kHexDirCount; ++i) {
-            Axial n = add(pos, dir(i));
-            if (!occupied(state_, n)) {
-                auto k = ringKey(n);
-                if (uniq.insert(k).second) candidates.push_back(n);
-            }
-        }
-    }
-
-    // if this color has no placed pieces yet, allow any empty neighbor of the hive
-    if (placementsMade(c) == 0) {
-        return candidates; // simple opening allowance so Black can place after White
-    }
-
-    // otherwise, enforce: must touch own color AND cannot touch opponent
-    for (const auto& a : candidates) {
-        if (adjacentToColor(a, c) && !adjacentToOpponent(a, c)) {
-            out.push_back(a);
-        }
-    }
-    return out;
-}
-
-
 bool UIApp::hitTestTray(sf::Vector2f pt, hive::Color& outColor, hive::Bug& outBug) const {
     for (const auto& it : trayItems_) {
         if (it.rect.contains(pt)) {
@@ -612,13 +771,13 @@ void UIApp::drawPieceTray(sf::RenderTarget& rt) {
     panel.setFillColor(sf::Color(245, 245, 248, 230));
     panel.setOutlineThickness(1.f);
     panel.setOutlineColor(sf::Color(200, 200, 210));
-    rt.draw(panel);
+    submit(rt, panel);
 
     bool showQueenHint = (queenWarningTimer_ > 0.f);
 
     auto drawSection = [&](hive::Color col, float& y) {
 
-        bool activeSection = (col == currentTurn_);
+        bool activeSection = (col == state_.toMove());
         sf::Uint8 rowAlpha = activeSection ? 255 : 160;   // dim off-turn
 
         if (fontOk_) {
@@ -627,13 +786,16 @@ void UIApp::drawPieceTray(sf::RenderTarget& rt) {
             t.setString(col == hive::Color::White ? "White Reserve" : "Black Reserve");
             t.setFillColor(activeSection ? sf::Color(30, 30, 35, rowAlpha) : sf::Color(90, 90, 100, static_cast<sf::Uint8>(ALPHA_FADE_OFF_TURN * rowAlpha)));
             t.setPosition(x0 + 10.f, y);
-            rt.draw(t);
+            submit(rt, t);
         }
         y += 22.f;
 
-        const std::array<hive::Bug, 5> order{ hive::Bug::Queen, hive::Bug::Spider, hive::Bug::Beetle, hive::Bug::Grasshopper, hive::Bug::Ant };
+        const std::array<hive::Bug, hive::kBugCount> order{ hive::Bug::Queen, hive::Bug::Spider, hive::Bug::Beetle, hive::Bug::Grasshopper, hive::Bug::Ant,
+            hive::Bug::Mosquito, hive::Bug::Ladybug, hive::Bug::Pillbug };
+        const auto hand = hive::startingHand(state_.ruleset());
         for (auto bug : order) {
-            int remaining = (col == hive::Color::White ? remainingWhite_.at(bug) : remainingBlack_.at(bug));
+            if (hand[hive::bugIndex(bug)] == 0) continue; // expansion bugs only in their ruleset
+            int remaining = state_.inHand(col, bug);
 
             sf::FloatRect box(x0 + 10.f, y, panelW - 20.f, rowH);
             // store hit rect
@@ -642,11 +804,10 @@ void UIApp::drawPieceTray(sf::RenderTarget& rt) {
             sf::RectangleShape r; r.setPosition({ box.left, box.top }); r.setSize({ box.width, box.height });
             r.setFillColor(sf::Color(255, 255, 255, remaining > 0 ? rowAlpha : static_cast<sf::Uint8>(rowAlpha * ALPHA_FADE_OFF_TURN)));
             r.setOutlineThickness(1.f); r.setOutlineColor(sf::Color(190, 190, 200));
-            rt.draw(r);
+            submit(rt, r);
 
             if (fontOk_) {
-                char c = '?';
-            switch (bug) { case hive::Bug::Queen:c = 'Q'; break; case hive::Bug::Spider:c = 'S'; break; case hive::Bug::Beetle:c = 'B'; break; case hive::Bug::Grasshopper:c = 'G'; break; case hive::Bug::Ant:c = 'A'; break; }
+                const char c = hive::bugChar(bug);
                 sf::Text t; t.setFont(font_);
                 t.setCharacterSize(18);
 
@@ -657,7 +818,7 @@ void UIApp::drawPieceTray(sf::RenderTarget& rt) {
                 if (remaining <= 0) alpha = static_cast<sf::Uint8>(alpha * 0.60f);
 
                 // Grey-out non-Queen rows if this color has already made >4 placements and hasn't placed the Queen yet
-                bool requireQueenNow = (!queenPlaced(col) && placementsMade(col) >= 3);
+                bool requireQueenNow = (!state_.queenPlaced(col) && state_.placementsMade(col) >= 3);
                 if (requireQueenNow && bug != hive::Bug::Queen) {
                     // muted grey
                     t.setFillColor(sf::Color(130, 130, 140, alpha));
@@ -670,11 +831,11 @@ void UIApp::drawPieceTray(sf::RenderTarget& rt) {
 
                 t.setString(std::string(1, c) + "  x" + std::to_string(remaining));
                 t.setPosition(box.left + 10.f, box.top + 6.f);
-                rt.draw(t);
+                submit(rt, t);
             }
 
             // If we are warning about queen placement, highlight the Queen row for the active color
-            if (showQueenHint && col == currentTurn_ && bug == hive::Bug::Queen) {
+            if (showQueenHint && col == state_.toMove() && bug == hive::Bug::Queen) {
                 sf::RectangleShape hint;
                 hint.setPosition({ box.left, box.top });
                 hint.setSize({ box.width, box.height });
@@ -683,14 +844,14 @@ void UIApp::drawPieceTray(sf::RenderTarget& rt) {
                 float pulse = 0.5f + 0.5f * std::sin(static_cast<float>(std::fmod(queenWarningTimer_ * 10.f, 6.28318f)));
                 hint.setOutlineThickness(2.f);
                 hint.setOutlineColor(sf::Color(220, 40, 40, static_cast<sf::Uint8>(120 + 100 * pulse)));
-                rt.draw(hint);
+                submit(rt, hint);
             }
 
             if (pendingPlace_ && pendingPlace_->first == col && pendingPlace_->second == bug) {
                 sf::RectangleShape h; h.setPosition({ box.left, box.top }); h.setSize({ box.width, box.height });
                 h.setFillColor(sf::Color(0, 180, 180, 40));
                 h.setOutlineThickness(2.f); h.setOutlineColor(sf::Color(0, 180, 180, 180));
-                rt.draw(h);
+                submit(rt, h);
             }
 
             y += rowH + 6.f;
@@ -704,8 +865,45 @@ void UIApp::drawPieceTray(sf::RenderTarget& rt) {
 }
 
 
+void UIApp::drawFrameStats(sf::RenderTarget& rt) {
+    if (!fontOk_) return;
+    const float frameMs = frameTimer_.avgMs();
+    const char* pacing = pacing_ == Pacing::Cap60 ? "cap 60" : pacing_ == Pacing::VSync ? "vsync" : "uncapped";
+    char buf[320];
+    std::snprintf(buf, sizeof(buf),
+        "frame %.2f ms (%.0f fps), max %.2f, jitter %.2f\n"
+        "update %.3f ms (max %.3f)\nrender %.3f ms (max %.3f)\npresent %.3f ms (max %.3f)\n"
+        "draw calls %d\ncells %zu\n"
+        "pacing: %s [F5]  step: %s [F4]",
+        frameMs, frameMs > 0.f ? 1000.f / frameMs : 0.f, frameTimer_.maxMs(), frameTimer_.stddevMs(),
+        updateTimer_.avgMs(), updateTimer_.maxMs(), renderTimer_.avgMs(), renderTimer_.maxMs(),
+        presentTimer_.avgMs(), presentTimer_.maxMs(),
+        lastDrawCalls_, state_.board().size(),
+        pacing, fixedTimestep_ ? "fixed 120 Hz" : "variable");
+
+    sf::Text t; t.setFont(font_);
+    t.setCharacterSize(13);
+    t.setString(buf);
+    t.setFillColor(sf::Color(220, 220, 220));
+    t.setPosition(10.f, static_cast<float>(window_.getSize().y) - 140.f);
+
+    sf::FloatRect tb = t.getGlobalBounds();
+    sf::RectangleShape bg;
+    bg.setPosition(tb.left - 6.f, tb.top - 6.f);
+    bg.setSize(sf::Vector2f(tb.width + 12.f, tb.height + 12.f));
+    bg.setFillColor(sf::Color(55, 55, 55, 200));
+    submit(rt, bg);
+    submit(rt, t);
+}
+
+void UIApp::submit(sf::RenderTarget& rt, const sf::Drawable& d, const sf::RenderStates& states) {
+    rt.draw(d, states);
+    ++drawCalls_;
+}
+
 // ===== render orchestrator =====
 void UIApp::render() {
+    drawCalls_ = 0;
     window_.clear(sf::Color(250, 250, 252));
 
     const float kSepPct = 0.10f;
@@ -718,11 +916,14 @@ void UIApp::render() {
     drawLegalTargets(window_, baseSize);
     drawHoverOutline(window_, baseSize);
     drawPieceTray(window_);
+    drawAnalysis(window_);
+    drawReplayBar(window_);
+    if (showFrameStats_) drawFrameStats(window_);
 
     if (fontOk_) {
         sf::Text turn; turn.setFont(font_);
         turn.setCharacterSize(16);
-        turn.setString(currentTurn_ == hive::Color::White ? "White to move" : "Black to move");
+        turn.setString(state_.toMove() == hive::Color::White ? "White to move" : "Black to move");
         turn.setFillColor(sf::Color(220, 220, 220));
         turn.setPosition(10.f, 10.f);
 
@@ -738,8 +939,8 @@ void UIApp::render() {
         bg.setOutlineColor(sf::Color(200, 200, 210));
 
         // draw rectangle first, then text
-        window_.draw(bg);
-        window_.draw(turn);
+        submit(window_, bg);
+        submit(window_, turn);
     }
 
     // helper lambda inside UIApp::render()
@@ -766,8 +967,8 @@ void UIApp::render() {
             bg.setOutlineThickness(1.f);
             bg.setOutlineColor(sf::Color(200, 200, 210, static_cast<sf::Uint8>(alpha)));
 
-            window_.draw(bg);
-            window_.draw(msg);
+            submit(window_, bg);
+            submit(window_, msg);
         }
         };
 
@@ -799,10 +1000,10 @@ void UIApp::render() {
         bg.setOutlineThickness(2.f);
         bg.setOutlineColor(sf::Color(255, 255, 255, 80));
 
-        window_.draw(bg);
-        window_.draw(t);
+        submit(window_, bg);
+        submit(window_, t);
     }
 
 
-    window_.display();
+    lastDrawCalls_ = drawCalls_;
 }